@@ -0,0 +1,78 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+/**
+ * # Sharded counter benchmark
+ * Number of threads increment a counter, which is either a single atomic, ThreadLocal or CoreLocal one. Reports
+ * increments per second depending on the number of threads.
+ *
+ * Usage: runCounterBench [max threads] [increments per thread]
+ */
+
+template <typename F> static double Measure(std::size_t threads, uint64_t increments, F increment) {
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&go, &increment, increments] {
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            for (uint64_t i = 0; i < increments; i++) {
+                increment();
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * increments / elapsed;
+}
+
+int main(int argc, char **argv) {
+    std::size_t max_threads = argc > 1 ? std::atoi(argv[1]) : 16;
+    uint64_t increments = argc > 2 ? std::atoll(argv[2]) : 10000000;
+
+    std::cerr << "threads\tatomic\tthread local\tcore local (increments/s)" << std::endl;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::atomic<uint64_t> shared(0);
+        double atomic = Measure(threads, increments, [&shared] { shared.fetch_add(1, std::memory_order_relaxed); });
+
+        // Single writer per copy, so there is no need for atomic read-modify-write
+        ThreadLocal<std::atomic<uint64_t>> per_thread;
+        double thread_local_rate = Measure(threads, increments, [&per_thread] {
+            std::atomic<uint64_t> &mine = per_thread.Get();
+            mine.store(mine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        });
+
+        CoreLocal<std::atomic<uint64_t>> per_core;
+        double core_local = Measure(threads, increments, [&per_core] {
+            per_core->fetch_add(1, std::memory_order_relaxed);
+        });
+
+        // Make sure nothing is lost
+        uint64_t total_thread = 0, total_core = 0;
+        per_thread.ForEach([&total_thread](std::atomic<uint64_t> &v) { total_thread += v.load(); });
+        per_core.ForEach([&total_core](std::atomic<uint64_t> &v) { total_core += v.load(); });
+        if (shared.load() != threads * increments || total_thread != shared.load() || total_core != shared.load()) {
+            std::cerr << "Lost increments!" << std::endl;
+            return 1;
+        }
+
+        std::cerr << threads << "\t" << uint64_t(atomic) << "\t" << uint64_t(thread_local_rate) << "\t"
+                  << uint64_t(core_local) << std::endl;
+    }
+    return 0;
+}
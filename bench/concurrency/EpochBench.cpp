@@ -0,0 +1,152 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+
+#include <afina/concurrency/Epoch.h>
+
+using namespace Afina::Concurrency;
+
+/**
+ * # Deferred reclamation benchmark
+ * Readers keep reading shared object while single writer keeps replacing it with a fresh copy and freeing the old
+ * one, which is what storage evicting items under readers does. Object is protected by:
+ * - epoch: lock-free readers, writer retires old copy to EpochDomain
+ * - mutex: everybody takes std::mutex, writer deletes old copy right away
+ * - rwlock: readers share pthread_rwlock_t, writer takes it exclusively
+ *
+ * Reports reads and writes per second depending on the number of readers.
+ *
+ * Usage: runEpochBench [max readers] [milliseconds]
+ */
+
+struct Item {
+    uint64_t values[8];
+};
+
+static Item *Fresh(uint64_t seed) {
+    Item *item = new Item;
+    for (auto &value : item->values) {
+        value = seed;
+    }
+    return item;
+}
+
+static uint64_t Sum(const Item *item) {
+    uint64_t sum = 0;
+    for (auto value : item->values) {
+        sum += value;
+    }
+    return sum;
+}
+
+struct Result {
+    double reads;
+    double writes;
+};
+
+// Runs readers and writer for the given time, Read and Write perform single operation each
+template <typename R, typename W> static Result Measure(std::size_t readers, int millis, R read, W write) {
+    std::atomic<bool> stop(false);
+    std::atomic<uint64_t> reads(0), writes(0), sink(0);
+
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < readers; t++) {
+        threads.emplace_back([&] {
+            uint64_t count = 0, sum = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                sum += read();
+                count++;
+            }
+            reads += count;
+            sink += sum;
+        });
+    }
+    threads.emplace_back([&] {
+        uint64_t count = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            write(count++);
+        }
+        writes += count;
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+    stop = true;
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return Result{reads / elapsed, writes / elapsed};
+}
+
+int main(int argc, char **argv) {
+    std::size_t max_readers = argc > 1 ? std::atoi(argv[1]) : 8;
+    int millis = argc > 2 ? std::atoi(argv[2]) : 1000;
+
+    std::cerr << "readers\tepoch reads/writes\tmutex reads/writes\trwlock reads/writes (per second)" << std::endl;
+    for (std::size_t readers = 1; readers <= max_readers; readers *= 2) {
+        Result epoch, locked, shared;
+        {
+            EpochDomain domain;
+            std::atomic<Item *> current(Fresh(0));
+            epoch = Measure(readers, millis,
+                            [&] {
+                                EpochGuard guard(domain);
+                                return Sum(current.load(std::memory_order_acquire));
+                            },
+                            [&](uint64_t i) { domain.Retire(current.exchange(Fresh(i))); });
+            delete current.load();
+        }
+        {
+            std::mutex mutex;
+            Item *current = Fresh(0);
+            locked = Measure(readers, millis,
+                             [&] {
+                                 std::lock_guard<std::mutex> lock(mutex);
+                                 return Sum(current);
+                             },
+                             [&](uint64_t i) {
+                                 Item *fresh = Fresh(i), *old;
+                                 {
+                                     std::lock_guard<std::mutex> lock(mutex);
+                                     old = current;
+                                     current = fresh;
+                                 }
+                                 delete old;
+                             });
+            delete current;
+        }
+        {
+            pthread_rwlock_t lock = PTHREAD_RWLOCK_INITIALIZER;
+            Item *current = Fresh(0);
+            shared = Measure(readers, millis,
+                             [&] {
+                                 pthread_rwlock_rdlock(&lock);
+                                 uint64_t sum = Sum(current);
+                                 pthread_rwlock_unlock(&lock);
+                                 return sum;
+                             },
+                             [&](uint64_t i) {
+                                 Item *fresh = Fresh(i);
+                                 pthread_rwlock_wrlock(&lock);
+                                 Item *old = current;
+                                 current = fresh;
+                                 pthread_rwlock_unlock(&lock);
+                                 delete old;
+                             });
+            delete current;
+            pthread_rwlock_destroy(&lock);
+        }
+
+        std::cerr << readers << "\t" << uint64_t(epoch.reads) << "/" << uint64_t(epoch.writes) << "\t"
+                  << uint64_t(locked.reads) << "/" << uint64_t(locked.writes) << "\t" << uint64_t(shared.reads)
+                  << "/" << uint64_t(shared.writes) << std::endl;
+    }
+    return 0;
+}
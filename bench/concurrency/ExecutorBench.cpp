@@ -0,0 +1,94 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+#include <afina/concurrency/WorkStealingExecutor.h>
+
+using namespace Afina::Concurrency;
+
+/**
+ * # Thread pool throughput benchmark
+ * Measures how many tiny tasks per second pools could run depending on the number of threads:
+ * - inject: all tasks are submitted from outside of the pool
+ * - fork: every task submits two more until tree of given depth is done, so tasks are produced by pool threads
+ *
+ * Usage: runConcurrencyBench [max threads] [tasks] [depth]
+ */
+
+// Work every task does, small enough for queue overhead to dominate
+static void Work(std::atomic<uint64_t> &done) {
+    volatile int sink = 0;
+    for (int i = 0; i < 64; i++) {
+        sink += i;
+    }
+    done.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void Await(std::atomic<uint64_t> &done, uint64_t expected) {
+    while (done.load(std::memory_order_relaxed) < expected) {
+        std::this_thread::yield();
+    }
+}
+
+template <typename Pool> static void Fork(Pool &pool, std::atomic<uint64_t> &done, int depth) {
+    Work(done);
+    if (depth > 0) {
+        pool.Execute(Fork<Pool>, std::ref(pool), std::ref(done), depth - 1);
+        pool.Execute(Fork<Pool>, std::ref(pool), std::ref(done), depth - 1);
+    }
+}
+
+template <typename Pool> static double Inject(Pool &pool, uint64_t tasks) {
+    std::atomic<uint64_t> done(0);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < tasks; i++) {
+        while (!pool.Execute(Work, std::ref(done))) {
+            std::this_thread::yield();
+        }
+    }
+    Await(done, tasks);
+    return tasks / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename Pool> static double Tree(Pool &pool, int depth) {
+    std::atomic<uint64_t> done(0);
+    uint64_t tasks = (uint64_t(1) << (depth + 1)) - 1;
+    auto start = std::chrono::steady_clock::now();
+    pool.Execute(Fork<Pool>, std::ref(pool), std::ref(done), depth);
+    Await(done, tasks);
+    return tasks / std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    std::size_t max_threads = argc > 1 ? std::atoi(argv[1]) : 16;
+    uint64_t tasks = argc > 2 ? std::atoll(argv[2]) : 1000000;
+    int depth = argc > 3 ? std::atoi(argv[3]) : 19;
+
+    std::cerr << "threads\texecutor inject\tstealing inject\texecutor fork\tstealing fork (tasks/s)" << std::endl;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double results[4];
+        {
+            // Queue is unbounded in effect, so that nothing is rejected
+            Executor pool("bench", threads, threads, std::size_t(-1), std::chrono::milliseconds(1000));
+            results[0] = Inject(pool, tasks);
+            results[2] = Tree(pool, depth);
+        }
+        {
+            WorkStealingExecutor pool("bench", threads);
+            results[1] = Inject(pool, tasks);
+            results[3] = Tree(pool, depth);
+        }
+
+        std::cerr << threads;
+        for (double r : results) {
+            std::cerr << "\t" << uint64_t(r);
+        }
+        std::cerr << std::endl;
+    }
+    return 0;
+}
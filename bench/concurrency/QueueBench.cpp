@@ -0,0 +1,208 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/MpmcQueue.h>
+#include <afina/concurrency/SpscQueue.h>
+
+using namespace Afina::Concurrency;
+
+/**
+ * # Bounded queue benchmark
+ * Equal number of producers and consumers pass integers through queue of fixed capacity:
+ * - mutex: std::deque guarded by std::mutex, full/empty sides wait on std::condition_variable
+ * - mpmc: MpmcQueue, Push/Pop retried with yield
+ * - batch: MpmcQueue, PushBatch/PopBatch of kBatch items
+ * - blocking: MpmcQueue, BlockingPush/BlockingPop sleeping on futex
+ * - spsc: SpscQueue, only for single producer and consumer
+ *
+ * Reports millions of items per second depending on the number of producer/consumer pairs.
+ *
+ * Usage: runQueueBench [max pairs] [items per producer] [capacity]
+ */
+
+static constexpr std::size_t kBatch = 16;
+
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : _capacity(capacity) {}
+
+    void Push(uint64_t value) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_items.size() >= _capacity) {
+            _not_full.wait(lock);
+        }
+        _items.push_back(value);
+        _not_empty.notify_one();
+    }
+
+    uint64_t Pop() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_items.empty()) {
+            _not_empty.wait(lock);
+        }
+        uint64_t value = _items.front();
+        _items.pop_front();
+        _not_full.notify_one();
+        return value;
+    }
+
+private:
+    const std::size_t _capacity;
+    std::mutex _mutex;
+    std::condition_variable _not_empty;
+    std::condition_variable _not_full;
+    std::deque<uint64_t> _items;
+};
+
+// Runs producers and consumers to completion, returns items per second. Each consumer gets the same share
+template <typename P, typename C> static double Measure(std::size_t pairs, uint64_t items, P produce, C consume) {
+    std::atomic<uint64_t> sink(0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < pairs; t++) {
+        threads.emplace_back([&] { produce(items); });
+        threads.emplace_back([&] { sink += consume(items); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (sink.load() != pairs * items * (items + 1) / 2) {
+        std::cerr << "lost items" << std::endl;
+        std::exit(1);
+    }
+    return pairs * items / elapsed;
+}
+
+int main(int argc, char **argv) {
+    std::size_t max_pairs = argc > 1 ? std::atoi(argv[1]) : 8;
+    uint64_t items = argc > 2 ? std::atoll(argv[2]) : 1000000;
+    std::size_t capacity = argc > 3 ? std::atoi(argv[3]) : 1024;
+
+    std::cerr << "pairs\tmutex\tmpmc\tbatch\tblocking\tspsc (M items/s)" << std::endl;
+    for (std::size_t pairs = 1; pairs <= max_pairs; pairs *= 2) {
+        double locked, mpmc, batch, blocking, spsc = 0;
+        {
+            LockedQueue queue(capacity);
+            locked = Measure(pairs, items,
+                             [&](uint64_t count) {
+                                 for (uint64_t i = 1; i <= count; i++) {
+                                     queue.Push(i);
+                                 }
+                             },
+                             [&](uint64_t count) {
+                                 uint64_t sum = 0;
+                                 for (uint64_t i = 0; i < count; i++) {
+                                     sum += queue.Pop();
+                                 }
+                                 return sum;
+                             });
+        }
+        {
+            MpmcQueue<uint64_t> queue(capacity);
+            mpmc = Measure(pairs, items,
+                           [&](uint64_t count) {
+                               for (uint64_t i = 1; i <= count; i++) {
+                                   while (!queue.Push(i)) {
+                                       std::this_thread::yield();
+                                   }
+                               }
+                           },
+                           [&](uint64_t count) {
+                               uint64_t sum = 0, value;
+                               for (uint64_t i = 0; i < count; i++) {
+                                   while (!queue.Pop(value)) {
+                                       std::this_thread::yield();
+                                   }
+                                   sum += value;
+                               }
+                               return sum;
+                           });
+        }
+        {
+            MpmcQueue<uint64_t> queue(capacity);
+            batch = Measure(pairs, items,
+                            [&](uint64_t count) {
+                                uint64_t values[kBatch];
+                                for (uint64_t i = 1; i <= count;) {
+                                    std::size_t n = 0;
+                                    for (; n < kBatch && i + n <= count; n++) {
+                                        values[n] = i + n;
+                                    }
+                                    std::size_t pushed = queue.PushBatch(values, n);
+                                    if (pushed == 0) {
+                                        std::this_thread::yield();
+                                    }
+                                    i += pushed;
+                                }
+                            },
+                            [&](uint64_t count) {
+                                uint64_t sum = 0, values[kBatch];
+                                for (uint64_t i = 0; i < count;) {
+                                    std::size_t want = count - i < kBatch ? count - i : kBatch;
+                                    std::size_t popped = queue.PopBatch(values, want);
+                                    if (popped == 0) {
+                                        std::this_thread::yield();
+                                    }
+                                    for (std::size_t j = 0; j < popped; j++) {
+                                        sum += values[j];
+                                    }
+                                    i += popped;
+                                }
+                                return sum;
+                            });
+        }
+        {
+            MpmcQueue<uint64_t> queue(capacity);
+            blocking = Measure(pairs, items,
+                               [&](uint64_t count) {
+                                   for (uint64_t i = 1; i <= count; i++) {
+                                       uint64_t value = i;
+                                       queue.BlockingPush(std::move(value));
+                                   }
+                               },
+                               [&](uint64_t count) {
+                                   uint64_t sum = 0, value;
+                                   for (uint64_t i = 0; i < count; i++) {
+                                       queue.BlockingPop(value);
+                                       sum += value;
+                                   }
+                                   return sum;
+                               });
+        }
+        if (pairs == 1) {
+            SpscQueue<uint64_t> queue(capacity);
+            spsc = Measure(pairs, items,
+                           [&](uint64_t count) {
+                               for (uint64_t i = 1; i <= count; i++) {
+                                   while (!queue.Push(i)) {
+                                       std::this_thread::yield();
+                                   }
+                               }
+                           },
+                           [&](uint64_t count) {
+                               uint64_t sum = 0, value;
+                               for (uint64_t i = 0; i < count; i++) {
+                                   while (!queue.Pop(value)) {
+                                       std::this_thread::yield();
+                                   }
+                                   sum += value;
+                               }
+                               return sum;
+                           });
+        }
+
+        std::cerr << pairs << "\t" << locked / 1e6 << "\t" << mpmc / 1e6 << "\t" << batch / 1e6 << "\t"
+                  << blocking / 1e6 << "\t" << spsc / 1e6 << std::endl;
+    }
+    return 0;
+}
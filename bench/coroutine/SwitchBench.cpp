@@ -0,0 +1,92 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+#include <ucontext.h>
+
+#include <afina/coroutine/Engine.h>
+
+using namespace Afina::Coroutine;
+
+/**
+ * # Context switch benchmark
+ * Two coroutines pass control to each other with sched, reports nanoseconds per switch. For comparison the same
+ * ping-pong is done with swapcontext, which also saves signal mask and so makes a syscall per switch. Then
+ * measures how long it takes to create, run and destroy a coroutine, stacks come from the pool.
+ *
+ * Usage: runSwitchBench [switches]
+ */
+
+static uint64_t switches;
+static void *ping_routine, *pong_routine;
+
+static void Pong(Engine &engine) {
+    for (;;) {
+        engine.sched(ping_routine);
+    }
+}
+
+static void Ping(Engine &engine) {
+    for (uint64_t i = 0; i < switches / 2; i++) {
+        engine.sched(pong_routine);
+    }
+
+    // Pong would never finish, so just leave it blocked
+    engine.block(pong_routine);
+}
+
+static void PingPong(Engine &engine) {
+    pong_routine = engine.run(Pong, engine);
+    ping_routine = engine.run(Ping, engine);
+}
+
+static void Empty() {}
+
+static void Spawner(Engine &engine) {
+    for (uint64_t i = 0; i < switches / 2; i++) {
+        engine.run(Empty);
+        engine.yield();
+    }
+}
+
+static ucontext_t ping_uc, pong_uc;
+
+static void UcontextPong() {
+    for (;;) {
+        swapcontext(&pong_uc, &ping_uc);
+    }
+}
+
+template <typename F> static double Measure(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv) {
+    switches = argc > 1 ? std::atoll(argv[1]) : 10000000;
+
+    Engine engine;
+    double engine_ns = Measure([&] { engine.start(PingPong, engine); }) / switches;
+
+    static char stack[64 * 1024];
+    getcontext(&pong_uc);
+    pong_uc.uc_stack.ss_sp = stack;
+    pong_uc.uc_stack.ss_size = sizeof(stack);
+    pong_uc.uc_link = nullptr;
+    makecontext(&pong_uc, UcontextPong, 0);
+    double ucontext_ns = Measure([&] {
+                             for (uint64_t i = 0; i < switches / 2; i++) {
+                                 swapcontext(&ping_uc, &pong_uc);
+                             }
+                         }) /
+                         switches;
+
+    double spawn_ns = Measure([&] { engine.start(Spawner, engine); }) / (switches / 2);
+
+    std::cerr << "Engine switch: " << engine_ns << " ns" << std::endl;
+    std::cerr << "swapcontext switch: " << ucontext_ns << " ns" << std::endl;
+    std::cerr << "Coroutine create + run + destroy: " << spawn_ns << " ns" << std::endl;
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/Storage.h>
+#include <afina/execute/Command.h>
+#include <afina/execute/Variant.h>
+
+#include "execute/Executor.h"
+#include "protocol/Parser.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Command dispatch benchmark
+ * Runs a stream of get/set requests through parser, command and storage the way connection does: once with
+ * heap allocated commands executed through virtual calls, once with commands built in place of Variant and
+ * executed by StaticExecutor of the storage type. Reports requests per second for every storage.
+ *
+ * Usage: runExecuteBench [requests] [rounds]
+ */
+
+// Memory limit for every storage, large enough for nothing to be evicted
+static constexpr std::size_t kMaxMemory = 64 * 1024 * 1024;
+
+struct Request {
+    std::string line;
+    std::string value;
+};
+
+static std::vector<Request> make_requests(std::size_t count) {
+    std::vector<Request> result;
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    for (std::size_t i = 0; i < count; i++) {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+
+        std::string key = "key" + std::to_string(random % 1000);
+        if (random % 10 == 0) {
+            result.push_back({"set " + key + " 0 0 5\r\n", "value"});
+        } else {
+            result.push_back({"get " + key + "\r\n", ""});
+        }
+    }
+    return result;
+}
+
+// Returns requests per second
+static double Measure(Storage &storage, const std::vector<Request> &requests, std::size_t rounds, bool variant) {
+    Protocol::Parser parser;
+    Execute::Variant command;
+    Execute::Executor execute = Execute::StaticExecutor(storage);
+    std::string out;
+    std::size_t checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; round++) {
+        for (const Request &request : requests) {
+            std::size_t parsed = 0, body = 0;
+            parser.Parse(request.line, parsed);
+            out.clear();
+            if (variant) {
+                parser.Build(command, body);
+                execute(storage, command, request.value, out);
+                command.Reset();
+            } else {
+                std::unique_ptr<Execute::Command> virtual_command = parser.Build(body);
+                virtual_command->Execute(storage, request.value, out);
+            }
+            parser.Reset();
+            checksum += out.size();
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Keep the work observable
+    if (checksum == 0) {
+        std::cerr << "nothing executed" << std::endl;
+    }
+    return requests.size() * rounds / elapsed;
+}
+
+static void Report(const std::string &name, Storage &storage, const std::vector<Request> &requests,
+                   std::size_t rounds) {
+    double virtual_rate = Measure(storage, requests, rounds, false);
+    double static_rate = Measure(storage, requests, rounds, true);
+    std::cerr << name << "\t" << virtual_rate << "\t" << static_rate << std::endl;
+}
+
+int main(int argc, char **argv) {
+    std::size_t count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::size_t rounds = argc > 2 ? std::atoi(argv[2]) : 10;
+
+    std::vector<Request> requests = make_requests(count);
+
+    std::cerr << "storage\tvirtual\tstatic (requests/s)" << std::endl;
+    Backend::SimpleLRU simple(kMaxMemory);
+    Report("st_lru", simple, requests, rounds);
+
+    Backend::ThreadSafeSimplLRU global(kMaxMemory);
+    Report("mt_lru", global, requests, rounds);
+
+    auto striped = Backend::StripedLRU::BuildStripedLRU(kMaxMemory, 8);
+    Report("mt_slru", *striped, requests, rounds);
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "network/st_stackless/ServerImpl.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Memory per connection benchmark
+ * Starts server in-process, opens a number of connections, makes a request on each one, so that server has
+ * set up everything it needs to serve it, and reports how much resident memory of the process has grown per
+ * connection. Kernel socket buffers are not counted, they are the same for every server.
+ *
+ * Usage: runMemoryBench [connections]
+ */
+
+// Logging service with only warnings enabled, so that server doesn't spend time on debug output
+static std::shared_ptr<Logging::Service> make_logging() {
+    std::shared_ptr<Logging::Config> cfg(new Logging::Config);
+    Logging::Appender &console = cfg->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+    console.color = false;
+
+    Logging::Logger &logger = cfg->loggers["root"];
+    logger.level = Logging::Logger::Level::WARNING;
+    logger.appenders.push_back("console");
+    logger.format = "[%H:%M:%S %z] [thread %t] [%n] [%l] %v";
+
+    std::shared_ptr<Logging::Service> result(new Logging::ServiceImpl(cfg));
+    result->Start();
+    return result;
+}
+
+// Resident set size of the process in bytes
+static std::size_t resident() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return std::strtoull(line.c_str() + 6, nullptr, 10) * 1024;
+        }
+    }
+    return 0;
+}
+
+static int connect_to(uint16_t port) {
+    int sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(sock);
+        throw std::runtime_error("Failed to connect: " + std::string(strerror(errno)));
+    }
+    return sock;
+}
+
+static void request(int sock) {
+    static const char get[] = "get key\r\n";
+    if (write(sock, get, sizeof(get) - 1) != sizeof(get) - 1) {
+        throw std::runtime_error("Failed to send request");
+    }
+
+    // Miss is answered with END alone
+    char buffer[5];
+    for (std::size_t received = 0; received < sizeof(buffer);) {
+        ssize_t n = read(sock, buffer + received, sizeof(buffer) - received);
+        if (n <= 0) {
+            throw std::runtime_error("Failed to receive response");
+        }
+        received += n;
+    }
+}
+
+static void run(const std::string &name, std::shared_ptr<Network::Server> server, uint16_t port,
+                std::size_t connections) {
+    server->Start(port, 1, 1);
+
+    // Warm up: the first connection allocates whatever is shared between all of them
+    int first = connect_to(port);
+    request(first);
+
+    malloc_trim(0);
+    std::size_t before = resident();
+
+    std::vector<int> sockets;
+    try {
+        for (std::size_t i = 0; i < connections; i++) {
+            sockets.push_back(connect_to(port));
+            request(sockets.back());
+        }
+    } catch (std::exception &ex) {
+        std::cerr << name << ": " << ex.what() << " after " << sockets.size() << " connections" << std::endl;
+    }
+    std::size_t after = resident();
+
+    std::cerr << name << ": " << sockets.size() << " connections, "
+              << (after - before) / std::max(std::size_t(1), sockets.size()) << " bytes of RSS per connection"
+              << std::endl;
+
+    for (int sock : sockets) {
+        close(sock);
+    }
+    close(first);
+    server->Stop();
+    server->Join();
+}
+
+int main(int argc, char **argv) {
+    std::size_t connections = argc > 1 ? std::atoi(argv[1]) : 1000;
+
+    // Both ends of every connection are in this process
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    auto logging = make_logging();
+    auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(64 * 1024 * 1024);
+
+    run("st_nonblock", std::make_shared<Network::STnonblock::ServerImpl>(storage, logging), 18091, connections);
+    run("st_coroutine", std::make_shared<Network::STcoroutine::ServerImpl>(storage, logging), 18092, connections);
+    run("st_stackless", std::make_shared<Network::STstackless::ServerImpl>(storage, logging), 18093, connections);
+
+    logging->Stop();
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+#include <afina/network/Server.h>
+
+#include "logging/ServiceImpl.h"
+#include "network/mt_coroutine/ServerImpl.h"
+#include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_sharded/ServerImpl.h"
+#include "network/st_coroutine/ServerImpl.h"
+#include "network/st_nonblocking/ServerImpl.h"
+#include "network/st_stackless/ServerImpl.h"
+#include "storage/SimpleLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Network throughput benchmark
+ * Starts server in-process and loads it with a number of clients, each one sends batches of pipelined
+ * get requests and waits for the whole batch to be answered before sending the next one. Round trip time
+ * of each batch is reported as well, so a single connection with pipeline of 1 is a ping-pong latency test.
+ *
+ * Usage: runNetworkBench [connections] [seconds] [pipeline] [workers]
+ */
+
+// Logging service with only warnings enabled, so that server doesn't spend time on debug output
+static std::shared_ptr<Logging::Service> make_logging() {
+    std::shared_ptr<Logging::Config> cfg(new Logging::Config);
+    Logging::Appender &console = cfg->appenders["console"];
+    console.type = Logging::Appender::Type::STDERR;
+    console.color = false;
+
+    Logging::Logger &logger = cfg->loggers["root"];
+    logger.level = Logging::Logger::Level::WARNING;
+    logger.appenders.push_back("console");
+    logger.format = "[%H:%M:%S %z] [thread %t] [%n] [%l] %v";
+
+    std::shared_ptr<Logging::Service> result(new Logging::ServiceImpl(cfg));
+    result->Start();
+    return result;
+}
+
+static int connect_to(uint16_t port) {
+    int sock = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == -1) {
+        close(sock);
+        throw std::runtime_error("Failed to connect: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &opts, sizeof(opts));
+    return sock;
+}
+
+static void send_all(int sock, const std::string &data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(sock, data.data() + sent, data.size() - sent);
+        if (n <= 0) {
+            throw std::runtime_error("Failed to send request");
+        }
+        sent += n;
+    }
+}
+
+static void recv_exactly(int sock, std::size_t size) {
+    char buffer[16 * 1024];
+    while (size > 0) {
+        ssize_t n = read(sock, buffer, std::min(size, sizeof(buffer)));
+        if (n <= 0) {
+            throw std::runtime_error("Failed to receive response");
+        }
+        size -= n;
+    }
+}
+
+// Runs single client until deadline, counts completed requests and records round trip of every batch
+static void client(uint16_t port, int id, std::size_t pipeline, std::chrono::steady_clock::time_point deadline,
+                   std::atomic<uint64_t> &total, std::vector<uint64_t> &latencies) {
+    try {
+        int sock = connect_to(port);
+
+        std::string key = "key_" + std::to_string(id);
+        std::string value(32, 'a' + (id % 26));
+        send_all(sock, "set " + key + " 0 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\n");
+        recv_exactly(sock, std::strlen("STORED\r\n"));
+
+        std::string request, response;
+        for (std::size_t i = 0; i < pipeline; i++) {
+            request += "get " + key + "\r\n";
+            response += "VALUE " + key + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\nEND\r\n";
+        }
+
+        uint64_t done = 0;
+        auto now = std::chrono::steady_clock::now();
+        while (now < deadline) {
+            send_all(sock, request);
+            recv_exactly(sock, response.size());
+            done += pipeline;
+
+            auto sent = now;
+            now = std::chrono::steady_clock::now();
+            latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sent).count());
+        }
+
+        total += done;
+        close(sock);
+    } catch (std::exception &ex) {
+        std::cerr << "Client " << id << " failed: " << ex.what() << std::endl;
+    }
+}
+
+static void run(const std::string &name, std::shared_ptr<Network::Server> server, uint16_t port,
+                std::size_t connections, std::size_t seconds, std::size_t pipeline, std::size_t workers) {
+    server->Start(port, 1, workers);
+
+    std::atomic<uint64_t> total(0);
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::seconds(seconds);
+
+    std::vector<std::vector<uint64_t>> latencies(connections);
+    std::vector<std::thread> clients;
+    for (std::size_t i = 0; i < connections; i++) {
+        clients.emplace_back(client, port, int(i), pipeline, deadline, std::ref(total), std::ref(latencies[i]));
+    }
+    for (auto &t : clients) {
+        t.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server->Stop();
+    server->Join();
+
+    std::vector<uint64_t> rtt;
+    for (auto &samples : latencies) {
+        rtt.insert(rtt.end(), samples.begin(), samples.end());
+    }
+    std::sort(rtt.begin(), rtt.end());
+    auto percentile = [&rtt](double p) { return rtt.empty() ? 0.0 : rtt[std::size_t(p * (rtt.size() - 1))] / 1000.0; };
+
+    std::cerr << name << ": " << connections << " connections, pipeline " << pipeline << ", " << workers
+              << " workers: " << uint64_t(total / elapsed) << " req/s, rtt p50 " << percentile(0.5) << " us, p99 "
+              << percentile(0.99) << " us, p99.9 " << percentile(0.999) << " us" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    std::size_t connections = argc > 1 ? std::atoi(argv[1]) : 16;
+    std::size_t seconds = argc > 2 ? std::atoi(argv[2]) : 5;
+    std::size_t pipeline = argc > 3 ? std::atoi(argv[3]) : 16;
+    std::size_t workers = argc > 4 ? std::atoi(argv[4]) : std::thread::hardware_concurrency();
+
+    auto logging = make_logging();
+    auto storage = std::make_shared<Backend::ThreadSafeSimplLRU>(64 * 1024 * 1024);
+
+    run("st_nonblock", std::make_shared<Network::STnonblock::ServerImpl>(storage, logging), 18081, connections,
+        seconds, pipeline, 1);
+    run("st_coroutine", std::make_shared<Network::STcoroutine::ServerImpl>(storage, logging), 18084, connections,
+        seconds, pipeline, 1);
+    run("st_stackless", std::make_shared<Network::STstackless::ServerImpl>(storage, logging), 18086, connections,
+        seconds, pipeline, 1);
+    run("mt_nonblock", std::make_shared<Network::MTnonblock::ServerImpl>(storage, logging), 18082, connections,
+        seconds, pipeline, workers);
+    run("mt_coroutine", std::make_shared<Network::MTcoroutine::ServerImpl>(storage, logging), 18085, connections,
+        seconds, pipeline, workers);
+
+    // Every shard owns private storage without locks, clients keys are spread between them. All shards together get
+    // as much memory as the storage shared by other servers
+    auto make_shard = [](std::size_t max_size) { return std::make_shared<Backend::SimpleLRU>(max_size); };
+    run("mt_shard",
+        std::make_shared<Network::MTshard::ServerImpl>(nullptr, logging, make_shard, 64 * 1024 * 1024), 18083,
+        connections, seconds, pipeline, workers);
+
+    logging->Stop();
+    return 0;
+}
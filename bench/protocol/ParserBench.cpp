@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <afina/execute/Command.h>
+
+#include "protocol/Parser.h"
+
+using namespace Afina;
+
+/**
+ * # Memcached parser benchmark
+ * Feeds parser with a stream of get/set command lines the way connection does and reports how many bytes it gets
+ * through per second. Values of set commands are not there, connection never passes them to the parser.
+ *
+ * Stream is parsed twice: with every command line available at once, and with every line split in two halves
+ * pushed one by one, the same happens to the line torn apart by read boundary.
+ *
+ * Usage: runParserBench [commands] [rounds]
+ */
+
+// Command lines, sizes of set values are random but values themselves are not needed
+static std::vector<std::string> make_requests(std::size_t count) {
+    std::vector<std::string> result;
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+    for (std::size_t i = 0; i < count; i++) {
+        random ^= random << 13;
+        random ^= random >> 7;
+        random ^= random << 17;
+
+        std::string key = "user:" + std::to_string(random % 100000) + ":profile";
+        if (random % 4 == 0) {
+            result.push_back("set " + key + " " + std::to_string(random % 65536) + " " +
+                             std::to_string(random % 3600) + " " + std::to_string(16 + random % 1024) + "\r\n");
+        } else {
+            std::string line = "get " + key;
+            for (std::size_t k = 0; k < random % 4; k++) {
+                line += " " + key + ":" + std::to_string(k);
+            }
+            result.push_back(line + "\r\n");
+        }
+    }
+    return result;
+}
+
+// Parse every request line, whole or in two halves, returns bytes per second
+static double Measure(const std::vector<std::string> &requests, std::size_t rounds, bool split, bool build) {
+    Protocol::Parser parser;
+    std::size_t bytes = 0, checksum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < rounds; round++) {
+        for (const std::string &line : requests) {
+            const char *data = line.data();
+            std::size_t size = line.size();
+            std::size_t piece = split ? size / 2 : size;
+            bool complete = false;
+            while (!complete) {
+                std::size_t parsed = 0;
+                complete = parser.Parse(data, std::min(size, piece), parsed);
+                piece = size;
+                data += parsed;
+                size -= parsed;
+            }
+
+            if (build) {
+                std::size_t body = 0;
+                std::unique_ptr<Execute::Command> command = parser.Build(body);
+                checksum += body + (command != nullptr);
+            } else {
+                checksum += parser.Name().size();
+            }
+            parser.Reset();
+            bytes += line.size();
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Keep the work observable
+    if (checksum == 0) {
+        std::cerr << "nothing parsed" << std::endl;
+    }
+    return bytes / elapsed;
+}
+
+int main(int argc, char **argv) {
+    std::size_t count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    std::size_t rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::vector<std::string> requests = make_requests(count);
+
+    std::cerr << "lines\tparse (GB/s)\tparse+build (GB/s)" << std::endl;
+    for (bool split : {false, true}) {
+        double parse = Measure(requests, rounds, split, false);
+        double build = Measure(requests, rounds, split, true);
+        std::cerr << (split ? "split" : "whole") << "\t" << parse / 1e9 << "\t" << build / 1e9 << std::endl;
+    }
+    return 0;
+}
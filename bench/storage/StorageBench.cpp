@@ -0,0 +1,88 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/FlatCombineLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+using namespace Afina;
+
+/**
+ * # Concurrent storage benchmark
+ * Threads hammer storage with 90% get / 10% set over a small hot set of keys, so everybody fights for the same
+ * lock (or stripe). Reports operations per second depending on the number of threads.
+ *
+ * Usage: runStorageBench [max threads] [operations per thread] [keys]
+ */
+
+// Memory limit for every storage, large enough for nothing to be evicted
+static constexpr std::size_t kMaxMemory = 64 * 1024 * 1024;
+
+static double Measure(Storage &storage, std::size_t threads, uint64_t operations, std::size_t keys) {
+    std::vector<std::string> names;
+    for (std::size_t i = 0; i < keys; i++) {
+        names.push_back("key" + std::to_string(i));
+        storage.Put(names.back(), "value");
+    }
+
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < threads; t++) {
+        workers.emplace_back([&go, &storage, &names, operations, t] {
+            uint64_t random = 0x9E3779B97F4A7C15ull * (t + 1);
+            std::string value;
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+
+            for (uint64_t i = 0; i < operations; i++) {
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+
+                const std::string &key = names[random % names.size()];
+                if (random % 10 == 0) {
+                    storage.Set(key, "value");
+                } else {
+                    storage.Get(key, value);
+                }
+            }
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go.store(true);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threads * operations / elapsed;
+}
+
+int main(int argc, char **argv) {
+    std::size_t max_threads = argc > 1 ? std::atoi(argv[1]) : 64;
+    uint64_t operations = argc > 2 ? std::atoll(argv[2]) : 200000;
+    std::size_t keys = argc > 3 ? std::atoi(argv[3]) : 64;
+
+    std::cerr << "threads\tmt_lru\tmt_slru\tmt_fclru (operations/s)" << std::endl;
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        Backend::ThreadSafeSimplLRU global(kMaxMemory);
+        double global_rate = Measure(global, threads, operations, keys);
+
+        auto striped = Backend::StripedLRU::BuildStripedLRU(kMaxMemory, 8);
+        double striped_rate = Measure(*striped, threads, operations, keys);
+
+        Backend::FlatCombineLRU combined(kMaxMemory);
+        double combined_rate = Measure(combined, threads, operations, keys);
+
+        std::cerr << threads << "\t" << uint64_t(global_rate) << "\t" << uint64_t(striped_rate) << "\t"
+                  << uint64_t(combined_rate) << std::endl;
+    }
+    return 0;
+}
@@ -1,7 +1,10 @@
 #ifndef AFINA_STORAGE_H
 #define AFINA_STORAGE_H
 
+#include <cstdint>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace Afina {
 
@@ -84,6 +87,14 @@ public:
      * @param value output parameter to copy value to
      */
     virtual bool Get(const std::string &key, std::string &value) = 0;
+
+    /**
+     * Append implementation specific counters to the list, "stats" command reports each one as
+     * STAT <name> <value>
+     *
+     * @param stats list to append name/value pairs to
+     */
+    virtual void Stats(std::vector<std::pair<std::string, uint64_t>> &stats) {}
 };
 
 } // namespace Afina
@@ -0,0 +1,89 @@
+#ifndef AFINA_CONCURRENCY_ADAPTIVE_LOCK_H
+#define AFINA_CONCURRENCY_ADAPTIVE_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Mutex for short critical sections
+ * Uncontended lock/unlock is a single atomic operation each. Once lock is busy, thread spins for a while with
+ * exponential backoff since holder is likely to leave soon, and only then parks on futex. Unlock makes syscall
+ * only if somebody is parked. Spinning is skipped on single CPU machine: holder can't make progress while we spin.
+ *
+ * Lock counts acquisitions, how many of them had to wait and total time spent waiting, so hot locks could be
+ * found. Counters are updated by the lock holder only, so that costs no extra atomic operations.
+ *
+ * Meets Lockable requirements, so works with std::lock_guard and std::unique_lock.
+ */
+class AdaptiveLock {
+public:
+    struct Stats {
+        uint64_t acquisitions;
+        uint64_t contended;
+        uint64_t wait_ns;
+    };
+
+    AdaptiveLock() : _state(kUnlocked), _acquisitions(0), _contended(0), _wait_ns(0) {}
+
+    AdaptiveLock(const AdaptiveLock &) = delete;
+    AdaptiveLock &operator=(const AdaptiveLock &) = delete;
+
+    inline void lock() {
+        int expected = kUnlocked;
+        if (!_state.compare_exchange_strong(expected, kLocked, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            LockContended();
+        }
+        Increment(_acquisitions, 1);
+    }
+
+    inline bool try_lock() {
+        int expected = kUnlocked;
+        if (!_state.compare_exchange_strong(expected, kLocked, std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            return false;
+        }
+        Increment(_acquisitions, 1);
+        return true;
+    }
+
+    inline void unlock() {
+        if (_state.exchange(kUnlocked, std::memory_order_release) == kParked) {
+            Wake();
+        }
+    }
+
+    /**
+     * Counters since lock creation, could be called without lock held
+     */
+    Stats GetStats() const;
+
+private:
+    enum : int { kUnlocked = 0, kLocked = 1, kParked = 2 };
+
+    // Slow path: spin, then park
+    void LockContended();
+
+    // Wake up one parked thread
+    void Wake();
+
+    // Counters are written under lock only, atomic just to let others read them
+    static inline void Increment(std::atomic<uint64_t> &counter, uint64_t value) {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Also futex word: kParked means somebody might be sleeping on it
+    std::atomic<int> _state;
+
+    std::atomic<uint64_t> _acquisitions;
+    std::atomic<uint64_t> _contended;
+    std::atomic<uint64_t> _wait_ns;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_ADAPTIVE_LOCK_H
@@ -1,10 +1,121 @@
 #ifndef AFINA_CONCURRENCY_CORE_LOCAL_H
 #define AFINA_CONCURRENCY_CORE_LOCAL_H
 
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+#include <sched.h>
+#include <unistd.h>
+
+#if defined(__has_include)
+#if __has_include(<sys/rseq.h>)
+#include <sys/rseq.h>
+#define AFINA_HAVE_RSEQ 1
+#endif
+#endif
+
+#include <afina/concurrency/ThreadLocal.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class CoreLocal {};
+/**
+ * CPU current thread is running on. Thread could be migrated right after the call, so that is only a hint.
+ *
+ * glibc 2.35+ registers rseq area for every thread and kernel keeps cpu id there up to date, so reading it is
+ * a plain load. Otherwise or if registration is disabled that is sched_getcpu, which is vDSO call on x86
+ */
+inline int CurrentCpu() {
+#if AFINA_HAVE_RSEQ
+    if (__rseq_size > 0) {
+        const struct rseq *area =
+            reinterpret_cast<const struct rseq *>(static_cast<char *>(__builtin_thread_pointer()) + __rseq_offset);
+        int cpu = static_cast<int>(__atomic_load_n(&area->cpu_id, __ATOMIC_RELAXED));
+        if (cpu >= 0) {
+            return cpu;
+        }
+    }
+#endif
+
+    int cpu = sched_getcpu();
+    return cpu < 0 ? 0 : cpu;
+}
+
+/**
+ * # Instance of T per CPU
+ * Thread gets copy of the CPU it is running on, copies are value initialized and passed to init function if any.
+ * Number of copies doesn't grow with the number of threads, so that fits state that should be sharded but is too
+ * large to keep per thread, like caches.
+ *
+ * Thread could be preempted or migrated at any point, so several threads could use the same copy at once:
+ * T must be thread safe, sharding only makes contention rare
+ */
+template <typename T> class CoreLocal {
+public:
+    explicit CoreLocal(std::function<void(T &)> init = nullptr) {
+        long cpus = sysconf(_SC_NPROCESSORS_CONF);
+        _size = cpus > 0 ? std::size_t(cpus) : 1;
+
+        void *memory = nullptr;
+        if (posix_memalign(&memory, alignof(Slot), _size * sizeof(Slot)) != 0) {
+            throw std::bad_alloc();
+        }
+
+        _slots = static_cast<Slot *>(memory);
+        for (std::size_t i = 0; i < _size; i++) {
+            new (&_slots[i]) Slot();
+            if (init) {
+                init(_slots[i].value);
+            }
+        }
+    }
+
+    ~CoreLocal() {
+        for (std::size_t i = 0; i < _size; i++) {
+            _slots[i].~Slot();
+        }
+        std::free(_slots);
+    }
+
+    CoreLocal(const CoreLocal &) = delete;
+    CoreLocal &operator=(const CoreLocal &) = delete;
+
+    /**
+     * Copy of the CPU current thread is running on
+     */
+    inline T &Get() { return _slots[std::size_t(CurrentCpu()) % _size].value; }
+
+    inline T &operator*() { return Get(); }
+    inline T *operator->() { return &Get(); }
+
+    /**
+     * Copy of the given CPU
+     */
+    inline T &At(std::size_t cpu) { return _slots[cpu % _size].value; }
+
+    inline std::size_t Size() const { return _size; }
+
+    /**
+     * Call func for every copy
+     */
+    template <typename F> void ForEach(F &&func) {
+        for (std::size_t i = 0; i < _size; i++) {
+            func(_slots[i].value);
+        }
+    }
+
+private:
+    struct alignas(kCacheLineSize) Slot {
+        Slot() : value() {}
+
+        T value;
+    };
+
+    Slot *_slots;
+    std::size_t _size;
+};
 
 } // namespace Concurrency
 } // namespace Afina
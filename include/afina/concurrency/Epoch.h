@@ -0,0 +1,146 @@
+#ifndef AFINA_CONCURRENCY_EPOCH_H
+#define AFINA_CONCURRENCY_EPOCH_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Epoch based memory reclamation
+ * Lets lock-free readers access shared objects that writers concurrently unlink and free. Reader wraps every
+ * access into critical section (see EpochGuard), writer unlinks object so that no new reader could reach it and
+ * retires it instead of deleting right away.
+ *
+ * Domain has global epoch counter, thread entering critical section announces epoch it has seen. Epoch is
+ * advanced only once every thread inside critical section has announced the current one, so object retired
+ * in epoch E could not be reached by anybody once epoch is E + 2 and gets freed.
+ *
+ * Each thread keeps retired objects in own limbo list and frees them in batches: every kCollectBatch retires
+ * it tries to advance epoch and releases whatever is old enough. Readers never wait for anything, the price is
+ * that a reader stuck inside critical section holds all frees back.
+ */
+class EpochDomain {
+public:
+    using Deleter = void (*)(void *);
+
+    // How many objects thread retires before trying to free some
+    static constexpr std::size_t kCollectBatch = 64;
+
+    EpochDomain();
+
+    /**
+     * No thread may be inside critical section or retire objects, frees everything still in limbo
+     */
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain &) = delete;
+    EpochDomain &operator=(const EpochDomain &) = delete;
+
+    /**
+     * Begin critical section, sections could be nested
+     */
+    inline void Enter() {
+        Participant &self = _participants.Get();
+        if (self.nesting++ > 0) {
+            return;
+        }
+
+        // Epoch might be advanced in between, announced one must be current once announcement is visible
+        uint64_t epoch = _epoch.load(std::memory_order_relaxed);
+        for (;;) {
+            self.state.store((epoch << 1) | 1);
+            uint64_t current = _epoch.load();
+            if (current == epoch) {
+                break;
+            }
+            epoch = current;
+        }
+    }
+
+    /**
+     * End critical section, pointers obtained inside are not safe to use anymore
+     */
+    inline void Leave() {
+        Participant &self = _participants.Get();
+        if (--self.nesting == 0) {
+            self.state.store(0, std::memory_order_release);
+        }
+    }
+
+    /**
+     * Free object once no thread could access it anymore. Object must be unlinked already, so that
+     * readers entering critical section from now on can't reach it
+     */
+    void Retire(void *ptr, Deleter deleter);
+
+    template <typename T> void Retire(T *ptr) { Retire(ptr, &DeleteObject<T>); }
+
+    /**
+     * Try to advance epoch and free objects retired by the current thread that are old enough, returns how many
+     * have been freed. Called automatically by Retire, but could be used to release memory sooner
+     */
+    std::size_t Collect();
+
+    /**
+     * Number of objects retired by the current thread and not freed yet
+     */
+    std::size_t Pending();
+
+    inline uint64_t Epoch() const { return _epoch.load(std::memory_order_relaxed); }
+
+private:
+    struct Retired {
+        void *ptr;
+        Deleter deleter;
+        uint64_t epoch;
+    };
+
+    // Thread state, slots of exited threads are handed to new ones together with not yet freed objects
+    struct Participant {
+        // Zero outside of critical section, otherwise epoch announced shifted left with the lowest bit set
+        std::atomic<uint64_t> state;
+
+        // Accessed by the owner only
+        unsigned nesting;
+        std::size_t retired;
+        std::deque<Retired> limbo;
+    };
+
+    template <typename T> static void DeleteObject(void *ptr) { delete static_cast<T *>(ptr); }
+
+    // Advance epoch if all threads in critical section have seen the current one
+    bool TryAdvance();
+
+    std::atomic<uint64_t> _epoch;
+
+    // Written on each advance only, keep readers of participants away from it
+    char _epoch_pad[kCacheLineSize];
+
+    ThreadLocal<Participant> _participants;
+};
+
+/**
+ * # Critical section of EpochDomain for the scope
+ */
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain &domain) : _domain(domain) { _domain.Enter(); }
+    ~EpochGuard() { _domain.Leave(); }
+
+    EpochGuard(const EpochGuard &) = delete;
+    EpochGuard &operator=(const EpochGuard &) = delete;
+
+private:
+    EpochDomain &_domain;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EPOCH_H
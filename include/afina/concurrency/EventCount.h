@@ -0,0 +1,68 @@
+#ifndef AFINA_CONCURRENCY_EVENT_COUNT_H
+#define AFINA_CONCURRENCY_EVENT_COUNT_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Lets threads block until lock-free structure changes
+ * Condition variable for code without mutex. Waiter announces itself with PrepareWait, rechecks condition and
+ * either calls CancelWait or sleeps in Wait. Notifier changes structure and calls Notify, which is just a fence
+ * and a load unless somebody waits, so non-blocking users of the structure pay almost nothing.
+ *
+ * Epoch and number of waiters share one futex word. Notify bumps epoch, drops waiters count to zero and wakes
+ * everybody up, so until woken threads come back to wait again the following notifications are free. Wakeup
+ * could not be lost: either waiter sees the change during recheck, or notifier sees the waiter and bumps epoch,
+ * then Wait returns right away. Caller must recheck condition after Wait in a loop anyway.
+ */
+class EventCount {
+public:
+    EventCount() : _state(0) {}
+
+    EventCount(const EventCount &) = delete;
+    EventCount &operator=(const EventCount &) = delete;
+
+    /**
+     * Announce intent to wait, returns key to be passed into Wait or CancelWait
+     */
+    inline uint32_t PrepareWait() { return _state.fetch_add(1) + 1; }
+
+    /**
+     * Condition is met after PrepareWait, no need to sleep
+     */
+    void CancelWait(uint32_t key);
+
+    /**
+     * Sleep until Notify called after PrepareWait returned the key
+     */
+    void Wait(uint32_t key);
+
+    /**
+     * Wake up all waiting threads, must be called after structure has been changed
+     */
+    inline void Notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((_state.load(std::memory_order_relaxed) & kWaitersMask) != 0) {
+            Wake();
+        }
+    }
+
+private:
+    // Low bits count waiters, high ones are epoch. Epoch wraps around, but 64K notifications between
+    // PrepareWait and futex call are not something to worry about
+    static constexpr uint32_t kWaitersMask = 0xffff;
+    static constexpr uint32_t kEpochStep = kWaitersMask + 1;
+
+    void Wake();
+
+    // Futex word
+    std::atomic<uint32_t> _state;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_EVENT_COUNT_H
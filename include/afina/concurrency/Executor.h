@@ -1,7 +1,9 @@
 #ifndef AFINA_CONCURRENCY_EXECUTOR_H
 #define AFINA_CONCURRENCY_EXECUTOR_H
 
+#include <chrono>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -9,13 +11,22 @@
 #include <string>
 #include <thread>
 
+#include <afina/concurrency/Task.h>
+
 namespace Afina {
 namespace Concurrency {
 
 /**
  * # Thread pool
+ * Pool keeps at least low_watermark threads alive. Once task is added while all threads are busy, new one is
+ * spawned unless there are high_watermark threads already. Thread that has no task for idle_time exits as long as
+ * there are more than low_watermark threads left.
+ *
+ * Tasks waiting for a free thread are kept in the queue of max_queue_size entries at most, once it is full new tasks
+ * are handled according to the rejection policy.
  */
 class Executor {
+public:
     enum class State {
         // Threadpool is fully operational, tasks could be added and get executed
         kRun,
@@ -28,7 +39,19 @@ class Executor {
         kStopped
     };
 
-    Executor(std::string name, int size);
+    /**
+     * What to do with the task once queue is full
+     */
+    enum class RejectPolicy {
+        // Task is dropped, Execute returns false
+        kAbort,
+
+        // Task is executed right in the caller thread, which also slows producer down
+        kCallerRuns
+    };
+
+    Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark, std::size_t max_queue_size,
+             std::chrono::milliseconds idle_time, RejectPolicy policy = RejectPolicy::kAbort);
     ~Executor();
 
     /**
@@ -47,36 +70,79 @@ class Executor {
      * execution finished by itself
      */
     template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
-        // Prepare "task"
-        auto exec = std::bind(std::forward<F>(func), std::forward<Types>(args)...);
+        // Prepare "task", small enough callable is kept inline so that doesn't allocate
+        Task exec(std::bind(std::forward<F>(func), std::forward<Types>(args)...));
 
         std::unique_lock<std::mutex> lock(this->mutex);
         if (state != State::kRun) {
             return false;
         }
 
-        // Enqueue new task
-        tasks.push_back(exec);
+        if (tasks.size() >= max_queue_size) {
+            if (policy == RejectPolicy::kAbort) {
+                return false;
+            }
+
+            lock.unlock();
+            exec();
+            return true;
+        }
+
+        // Enqueue new task, grow the pool if there is nobody to pick it up
+        tasks.push_back(std::move(exec));
+        if (free_threads < tasks.size() && threads < high_watermark) {
+            StartThread();
+        }
         empty_condition.notify_one();
         return true;
     }
 
+    /**
+     * Number of threads in the pool and how many of them are waiting for a task
+     */
+    std::size_t Threads() const;
+    std::size_t FreeThreads() const;
+
+    /**
+     * Number of tasks waiting for a free thread
+     */
+    std::size_t Queued() const;
+
 private:
     // No copy/move/assign allowed
-    Executor(const Executor &);            // = delete;
-    Executor(Executor &&);                 // = delete;
-    Executor &operator=(const Executor &); // = delete;
-    Executor &operator=(Executor &&);      // = delete;
+    Executor(const Executor &) = delete;
+    Executor(Executor &&) = delete;
+    Executor &operator=(const Executor &) = delete;
+    Executor &operator=(Executor &&) = delete;
+
+    /**
+     * Spawn one more pool thread, must be called with mutex locked
+     */
+    void StartThread();
 
     /**
      * Main function that all pool threads are running. It polls internal task queue and execute tasks
      */
     friend void perform(Executor *executor);
 
+    /**
+     * Pool name, threads are named after it
+     */
+    const std::string name;
+
+    /**
+     * Pool size limits, see class description
+     */
+    const std::size_t low_watermark;
+    const std::size_t high_watermark;
+    const std::size_t max_queue_size;
+    const std::chrono::milliseconds idle_time;
+    const RejectPolicy policy;
+
     /**
      * Mutex to protect state below from concurrent modification
      */
-    std::mutex mutex;
+    mutable std::mutex mutex;
 
     /**
      * Conditional variable to await new data in case of empty queue
@@ -84,14 +150,21 @@ private:
     std::condition_variable empty_condition;
 
     /**
-     * Vector of actual threads that perorm execution
+     * Conditional variable to await the last thread to exit on stop
+     */
+    std::condition_variable stop_condition;
+
+    /**
+     * Number of threads alive and how many of them are waiting for a task. Threads are detached, each one
+     * leaves the pool by itself
      */
-    std::vector<std::thread> threads;
+    std::size_t threads;
+    std::size_t free_threads;
 
     /**
      * Task queue
      */
-    std::deque<std::function<void()>> tasks;
+    std::deque<Task> tasks;
 
     /**
      * Flag to stop bg threads
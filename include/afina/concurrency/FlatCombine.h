@@ -1,10 +1,129 @@
 #ifndef AFINA_CONCURRENCY_FLAT_COMBINE_H
 #define AFINA_CONCURRENCY_FLAT_COMBINE_H
 
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <afina/concurrency/ThreadLocal.h>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename Op> class FlatCombine {};
+/**
+ * # Flat combining
+ * Instead of fighting for the lock, threads publish operations into their own slots. Whoever manages to take
+ * the lock becomes combiner: it collects everything published so far and passes that as a single batch to the
+ * apply function, then marks operations done. Others just wait for their slot to be cleared, so the protected
+ * structure and lock cache lines stay with a single core and everybody else spins on own slot only.
+ *
+ * Op is whatever apply needs to perform operation and report result back, it is owned by the caller and is not
+ * copied. Apply is only called by one thread at a time and must not throw: report errors through Op instead.
+ */
+template <typename Op> class FlatCombine {
+public:
+    using Apply = std::function<void(Op *const *batch, std::size_t size)>;
+
+    explicit FlatCombine(Apply apply)
+        : _apply(std::move(apply)), _combining(false), _head(nullptr),
+          _records([this](Record &record) { Publish(record); }) {}
+
+    FlatCombine(const FlatCombine &) = delete;
+    FlatCombine &operator=(const FlatCombine &) = delete;
+
+    /**
+     * Perform operation, returns once apply has been called on it by this or any other thread
+     */
+    void Execute(Op &op) {
+        Record &record = _records.Get();
+        record.request.store(&op, std::memory_order_release);
+
+        for (int spin = 0;; spin++) {
+            if (record.request.load(std::memory_order_acquire) == nullptr) {
+                return;
+            }
+
+            if (!_combining.load(std::memory_order_relaxed) && !_combining.exchange(true, std::memory_order_acquire)) {
+                Combine();
+                _combining.store(false, std::memory_order_release);
+                continue;
+            }
+
+            // Combiner is busy. Batch is short, so it is worth to spin a bit, but not too long: on oversubscribed
+            // machine combiner itself could need this CPU to finish
+            if (spin >= kSpinRounds) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    // How many times waiter rechecks its slot before giving CPU away
+    static constexpr int kSpinRounds = 64;
+
+    // How many times combiner rescans slots for requests published while it was busy
+    static constexpr int kCombineRounds = 3;
+
+    // Slot of the thread, slots are never removed from the list: ThreadLocal hands slot of exited thread to
+    // the next one, so list is as long as max number of threads ever alive at once
+    struct Record {
+        std::atomic<Op *> request;
+        Record *next;
+    };
+
+    void Publish(Record &record) {
+        record.next = _head.load(std::memory_order_relaxed);
+        while (!_head.compare_exchange_weak(record.next, &record, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    // Must be called by the combiner only
+    void Combine() {
+        for (int round = 0; round < kCombineRounds; round++) {
+            _batch.clear();
+            _owners.clear();
+            for (Record *record = _head.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+                Op *op = record->request.load(std::memory_order_acquire);
+                if (op != nullptr) {
+                    _batch.push_back(op);
+                    _owners.push_back(record);
+                }
+            }
+
+            if (_batch.empty()) {
+                return;
+            }
+
+            _apply(_batch.data(), _batch.size());
+            for (auto record : _owners) {
+                record->request.store(nullptr, std::memory_order_release);
+            }
+
+            // Nobody else was waiting, chances are there is nothing new either
+            if (_batch.size() == 1) {
+                return;
+            }
+        }
+    }
+
+    const Apply _apply;
+
+    // Combiner lock, set by the thread performing batch
+    std::atomic<bool> _combining;
+
+    // List of all slots
+    std::atomic<Record *> _head;
+
+    // Current batch and where it came from, used by combiner only
+    std::vector<Op *> _batch;
+    std::vector<Record *> _owners;
+
+    ThreadLocal<Record> _records;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,254 @@
+#ifndef AFINA_CONCURRENCY_MPMC_QUEUE_H
+#define AFINA_CONCURRENCY_MPMC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include <afina/concurrency/EventCount.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Bounded lock-free queue for any number of producers and consumers
+ * Ring buffer of capacity rounded up to the power of two, each slot carries sequence number telling whose turn
+ * it is: slot at position P is free for producer of P when sequence is P and ready for consumer of P when it
+ * is P + 1. Producers claim positions by CAS on tail, consumers by CAS on head, so the only contended cache lines
+ * are the two indexes and slots themselves are handed over without locks. Failed operation never modifies
+ * anything shared.
+ *
+ * Batch operations claim several adjacent positions with single CAS. Blocking operations sleep on futex through
+ * EventCount and are woken up by the other side, Close releases everybody waiting.
+ *
+ * For exactly one producer and one consumer see SpscQueue, it needs no atomic RMW at all.
+ */
+template <typename T> class MpmcQueue {
+public:
+    explicit MpmcQueue(std::size_t capacity) : _tail(0), _head(0), _closed(false) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _cells.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; i++) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcQueue(const MpmcQueue &) = delete;
+    MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+    /**
+     * Returns false if queue is full, value is left untouched then
+     */
+    bool Push(T &&value) {
+        std::size_t pos = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = _cells[pos & _mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+            if (diff == 0) {
+                if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    _not_empty.Notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Slot still holds value from the previous lap
+                return false;
+            } else {
+                pos = _tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool Push(const T &value) {
+        T copy(value);
+        return Push(std::move(copy));
+    }
+
+    /**
+     * Returns false if queue is empty
+     */
+    bool Pop(T &value) {
+        std::size_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = _cells[pos & _mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+            if (diff == 0) {
+                if (_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + _mask + 1, std::memory_order_release);
+                    _not_full.Notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Move up to count values from the array into queue in order, returns how many have been pushed. Values are
+     * taken from the beginning of the array, the rest is left untouched
+     */
+    std::size_t PushBatch(T *values, std::size_t count) {
+        std::size_t pos = _tail.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t ready = CountSlots(pos, 0, count);
+            if (ready == 0) {
+                intptr_t diff = intptr_t(_cells[pos & _mask].sequence.load(std::memory_order_acquire)) - intptr_t(pos);
+                if (diff < 0 || count == 0) {
+                    return 0;
+                }
+                pos = _tail.load(std::memory_order_relaxed);
+            } else if (_tail.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < ready; i++) {
+                    Cell &cell = _cells[(pos + i) & _mask];
+                    cell.value = std::move(values[i]);
+                    cell.sequence.store(pos + i + 1, std::memory_order_release);
+                }
+                _not_empty.Notify();
+                return ready;
+            }
+        }
+    }
+
+    /**
+     * Move up to count values from queue into the array in order, returns how many have been popped
+     */
+    std::size_t PopBatch(T *values, std::size_t count) {
+        std::size_t pos = _head.load(std::memory_order_relaxed);
+        for (;;) {
+            std::size_t ready = CountSlots(pos, 1, count);
+            if (ready == 0) {
+                intptr_t diff =
+                    intptr_t(_cells[pos & _mask].sequence.load(std::memory_order_acquire)) - intptr_t(pos + 1);
+                if (diff < 0 || count == 0) {
+                    return 0;
+                }
+                pos = _head.load(std::memory_order_relaxed);
+            } else if (_head.compare_exchange_weak(pos, pos + ready, std::memory_order_relaxed)) {
+                for (std::size_t i = 0; i < ready; i++) {
+                    Cell &cell = _cells[(pos + i) & _mask];
+                    values[i] = std::move(cell.value);
+                    cell.sequence.store(pos + i + _mask + 1, std::memory_order_release);
+                }
+                _not_full.Notify();
+                return ready;
+            }
+        }
+    }
+
+    /**
+     * Block until value is pushed, returns false without touching value if queue is closed
+     */
+    bool BlockingPush(T &&value) {
+        for (;;) {
+            if (_closed.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (Push(std::move(value))) {
+                return true;
+            }
+
+            uint32_t key = _not_full.PrepareWait();
+            if (Push(std::move(value))) {
+                _not_full.CancelWait(key);
+                return true;
+            }
+            if (_closed.load(std::memory_order_acquire)) {
+                _not_full.CancelWait(key);
+                return false;
+            }
+            _not_full.Wait(key);
+        }
+    }
+
+    /**
+     * Block until value is popped, returns false if queue is closed and nothing is left in it
+     */
+    bool BlockingPop(T &value) {
+        for (;;) {
+            if (Pop(value)) {
+                return true;
+            }
+
+            uint32_t key = _not_empty.PrepareWait();
+            if (Pop(value)) {
+                _not_empty.CancelWait(key);
+                return true;
+            }
+            if (_closed.load(std::memory_order_acquire)) {
+                _not_empty.CancelWait(key);
+                return Pop(value);
+            }
+            _not_empty.Wait(key);
+        }
+    }
+
+    /**
+     * Fail all blocking pushes and let blocking pops fail once queue is drained. Non-blocking operations are
+     * not affected
+     */
+    void Close() {
+        _closed.store(true, std::memory_order_release);
+        _not_empty.Notify();
+        _not_full.Notify();
+    }
+
+    bool Closed() const { return _closed.load(std::memory_order_acquire); }
+
+    /**
+     * Could be called from any thread, result could be outdated once returned
+     */
+    bool Empty() const { return _head.load(std::memory_order_acquire) >= _tail.load(std::memory_order_acquire); }
+
+    std::size_t Capacity() const { return _mask + 1; }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Number of adjacent slots starting at pos whose sequence is position plus shift, at most count
+    std::size_t CountSlots(std::size_t pos, std::size_t shift, std::size_t count) const {
+        std::size_t ready = 0;
+        while (ready < count && ready <= _mask &&
+               _cells[(pos + ready) & _mask].sequence.load(std::memory_order_acquire) == pos + ready + shift) {
+            ready++;
+        }
+        return ready;
+    }
+
+    // Producers side. Padding instead of alignas: over-aligned types could not be allocated with new before C++17
+    std::atomic<std::size_t> _tail;
+    char _producer_pad[kCacheLineSize];
+
+    // Consumers side
+    std::atomic<std::size_t> _head;
+    char _consumer_pad[kCacheLineSize];
+
+    // Read-mostly from here on
+    std::size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+    std::atomic<bool> _closed;
+
+    EventCount _not_empty;
+    EventCount _not_full;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_MPMC_QUEUE_H
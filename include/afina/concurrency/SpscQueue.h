@@ -0,0 +1,139 @@
+#ifndef AFINA_CONCURRENCY_SPSC_QUEUE_H
+#define AFINA_CONCURRENCY_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <afina/concurrency/ThreadLocal.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Bounded lock-free queue for exactly one producer and one consumer
+ * Ring buffer of capacity rounded up to the power of two. Producer owns tail and consumer owns head, each one keeps
+ * a private copy of the other's index and rereads shared one only when copy says queue is full (or empty), so in
+ * steady state every Push/Pop touches only own cache line and the slot.
+ */
+template <typename T> class SpscQueue {
+public:
+    explicit SpscQueue(std::size_t capacity) : _head(0), _tail_cache(0), _tail(0), _head_cache(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _mask = size - 1;
+        _buffer.reset(new T[size]);
+    }
+
+    SpscQueue(const SpscQueue &) = delete;
+    SpscQueue &operator=(const SpscQueue &) = delete;
+
+    /**
+     * Producer side, returns false if queue is full
+     */
+    bool Push(T &&value) {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head_cache > _mask) {
+            _head_cache = _head.load(std::memory_order_acquire);
+            if (tail - _head_cache > _mask) {
+                return false;
+            }
+        }
+
+        _buffer[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool Push(const T &value) {
+        T copy(value);
+        return Push(std::move(copy));
+    }
+
+    /**
+     * Consumer side, returns false if queue is empty
+     */
+    bool Pop(T &value) {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail_cache) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (head == _tail_cache) {
+                return false;
+            }
+        }
+
+        value = std::move(_buffer[head & _mask]);
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Producer side, moves up to count values from the array into queue and publishes them at once. Returns how
+     * many have been pushed, the rest of the array is left untouched
+     */
+    std::size_t PushBatch(T *values, std::size_t count) {
+        std::size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head_cache + count > _mask + 1) {
+            _head_cache = _head.load(std::memory_order_acquire);
+        }
+        std::size_t space = _mask + 1 - (tail - _head_cache);
+        if (count > space) {
+            count = space;
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
+            _buffer[(tail + i) & _mask] = std::move(values[i]);
+        }
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Consumer side, moves up to count values from queue into the array, returns how many have been popped
+     */
+    std::size_t PopBatch(T *values, std::size_t count) {
+        std::size_t head = _head.load(std::memory_order_relaxed);
+        if (_tail_cache - head < count) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+        }
+        std::size_t available = _tail_cache - head;
+        if (count > available) {
+            count = available;
+        }
+
+        for (std::size_t i = 0; i < count; i++) {
+            values[i] = std::move(_buffer[(head + i) & _mask]);
+        }
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Could be called from any thread, result could be outdated once returned
+     */
+    bool Empty() const { return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire); }
+
+    std::size_t Capacity() const { return _mask + 1; }
+
+private:
+    // Consumer side. Padding instead of alignas: over-aligned types could not be allocated with new before C++17
+    std::atomic<std::size_t> _head;
+    std::size_t _tail_cache;
+    char _consumer_pad[kCacheLineSize];
+
+    // Producer side
+    std::atomic<std::size_t> _tail;
+    std::size_t _head_cache;
+    char _producer_pad[kCacheLineSize];
+
+    std::size_t _mask;
+    std::unique_ptr<T[]> _buffer;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_SPSC_QUEUE_H
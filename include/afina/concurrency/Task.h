@@ -0,0 +1,136 @@
+#ifndef AFINA_CONCURRENCY_TASK_H
+#define AFINA_CONCURRENCY_TASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Unit of work for the thread pools
+ * Move-only replacement for std::function<void()>. Callable that fits into kInlineSize bytes and could be
+ * moved without exceptions is kept right inside the task, so wrapping std::bind result or a lambda with a
+ * few captures doesn't allocate. Larger ones are moved to the heap.
+ *
+ * Being move-only task also accepts callables that own move-only state, which std::function rejects.
+ */
+class Task {
+public:
+    // Task occupies a single cache line
+    static constexpr std::size_t kInlineSize = 64 - alignof(std::max_align_t);
+
+    Task() noexcept : _ops(nullptr) {}
+
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, Task>::value>::type>
+    Task(F &&func) : _ops(&Ops<typename std::decay<F>::type>::table) {
+        Ops<typename std::decay<F>::type>::Create(&_storage, std::forward<F>(func));
+    }
+
+    Task(Task &&other) noexcept : _ops(other._ops) {
+        if (_ops != nullptr) {
+            _ops->move(&_storage, &other._storage);
+            other._ops = nullptr;
+        }
+    }
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            Reset();
+            _ops = other._ops;
+            if (_ops != nullptr) {
+                _ops->move(&_storage, &other._storage);
+                other._ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { Reset(); }
+
+    /**
+     * Run the callable, task must not be empty
+     */
+    void operator()() { _ops->invoke(&_storage); }
+
+    explicit operator bool() const noexcept { return _ops != nullptr; }
+
+    /**
+     * Destroy the callable, task becomes empty
+     */
+    void Reset() noexcept {
+        if (_ops != nullptr) {
+            _ops->destroy(&_storage);
+            _ops = nullptr;
+        }
+    }
+
+private:
+    using Storage = typename std::aligned_storage<kInlineSize, alignof(std::max_align_t)>::type;
+
+    // Type erased operations on the stored callable
+    struct Table {
+        void (*invoke)(Storage *);
+        void (*move)(Storage *dst, Storage *src);
+        void (*destroy)(Storage *);
+    };
+
+    template <typename F>
+    using IsInline = std::integral_constant<bool, sizeof(F) <= kInlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                                                      std::is_nothrow_move_constructible<F>::value>;
+
+    template <typename F, bool = IsInline<F>::value> struct Ops;
+
+    // Callable lives in the task storage
+    template <typename F> struct Ops<F, true> {
+        template <typename G> static void Create(Storage *storage, G &&func) { new (storage) F(std::forward<G>(func)); }
+
+        static F *Get(Storage *storage) { return reinterpret_cast<F *>(storage); }
+
+        static void Invoke(Storage *storage) { (*Get(storage))(); }
+
+        static void Move(Storage *dst, Storage *src) {
+            new (dst) F(std::move(*Get(src)));
+            Get(src)->~F();
+        }
+
+        static void Destroy(Storage *storage) { Get(storage)->~F(); }
+
+        static const Table table;
+    };
+
+    // Task storage keeps pointer to the callable on heap
+    template <typename F> struct Ops<F, false> {
+        template <typename G> static void Create(Storage *storage, G &&func) {
+            Get(storage) = new F(std::forward<G>(func));
+        }
+
+        static F *&Get(Storage *storage) { return *reinterpret_cast<F **>(storage); }
+
+        static void Invoke(Storage *storage) { (*Get(storage))(); }
+
+        static void Move(Storage *dst, Storage *src) { Get(dst) = Get(src); }
+
+        static void Destroy(Storage *storage) { delete Get(storage); }
+
+        static const Table table;
+    };
+
+    const Table *_ops;
+    Storage _storage;
+};
+
+template <typename F> const Task::Table Task::Ops<F, true>::table = {&Invoke, &Move, &Destroy};
+
+template <typename F> const Task::Table Task::Ops<F, false>::table = {&Invoke, &Move, &Destroy};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_TASK_H
@@ -1,10 +1,178 @@
 #ifndef AFINA_CONCURRENCY_THREAD_LOCAL_H
 #define AFINA_CONCURRENCY_THREAD_LOCAL_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
 namespace Afina {
 namespace Concurrency {
 
-template <typename T> class ThreadLocal {};
+// Size slots are padded to, so that neighbour slots never share a cache line
+static constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * # Bookkeeping shared by all ThreadLocal instantiations
+ * Every instance gets a small id, each thread keeps an array indexed by id with pointers to its slots. Ids
+ * are reused once instance is destroyed, so array entries carry generation of the instance to tell stale
+ * ones. On exit thread returns its slots to instances still alive, so they could be reused.
+ */
+class ThreadLocalBase {
+protected:
+    ThreadLocalBase();
+    ~ThreadLocalBase();
+
+    /**
+     * Slot of the current thread or nullptr if thread has not accessed instance yet
+     */
+    inline void *Lookup() const {
+        const Entry *entries = _cache.entries;
+        if (_id < _cache.size && entries[_id].generation == _generation) {
+            return entries[_id].slot;
+        }
+        return nullptr;
+    }
+
+    /**
+     * Bind slot to the current thread
+     */
+    void Remember(void *slot);
+
+    /**
+     * Must be called first thing in the derived destructor, once it returns no Release call could happen
+     */
+    void Unregister();
+
+    /**
+     * Called on exit of the thread owning given slot, with registry lock held
+     */
+    virtual void Release(void *slot) = 0;
+
+private:
+    friend struct ThreadLocalCache;
+
+    struct Entry {
+        uint64_t generation;
+        void *slot;
+    };
+
+    // Per thread array of slots. Declared __thread since it has no dynamic initialization, so access is a plain
+    // TLS load instead of thread_local wrapper call
+    struct Cache {
+        Entry *entries;
+        std::size_t size;
+    };
+
+    std::size_t _id;
+    uint64_t _generation;
+
+    static __thread Cache _cache;
+};
+
+/**
+ * # Instance of T per thread
+ * Each thread accessing the object gets its own value initialized copy of T, optionally passed to init function
+ * right after. Access is a couple of loads once thread has touched the object. Unlike thread_local variable,
+ * object could be a class member and all copies could be visited by any thread, for example to aggregate
+ * sharded counters.
+ *
+ * Copies live as long as the object does. Once thread exits its copy is kept with the value and handed to
+ * the next thread accessing the object, so aggregates don't lose anything.
+ *
+ * Visiting runs concurrently with owners, so T must tolerate that, e.g be an atomic that owner updates
+ * with relaxed load + store.
+ */
+template <typename T> class ThreadLocal : private ThreadLocalBase {
+public:
+    ThreadLocal() = default;
+    explicit ThreadLocal(std::function<void(T &)> init) : _init(std::move(init)) {}
+
+    ~ThreadLocal() {
+        Unregister();
+        for (auto slot : _slots) {
+            slot->~Slot();
+            std::free(slot);
+        }
+    }
+
+    ThreadLocal(const ThreadLocal &) = delete;
+    ThreadLocal &operator=(const ThreadLocal &) = delete;
+
+    /**
+     * Copy of the current thread
+     */
+    inline T &Get() {
+        void *slot = Lookup();
+        if (slot != nullptr) {
+            return static_cast<Slot *>(slot)->value;
+        }
+        return Attach()->value;
+    }
+
+    inline T &operator*() { return Get(); }
+    inline T *operator->() { return &Get(); }
+
+    /**
+     * Call func for every copy ever created, including ones of exited threads
+     */
+    template <typename F> void ForEach(F &&func) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        for (auto slot : _slots) {
+            func(slot->value);
+        }
+    }
+
+private:
+    struct alignas(kCacheLineSize) Slot {
+        Slot() : value() {}
+
+        T value;
+    };
+
+    Slot *Attach() {
+        Slot *slot = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (!_free.empty()) {
+                slot = _free.back();
+                _free.pop_back();
+            } else {
+                // Over-aligned new is not guaranteed before C++17
+                void *memory = nullptr;
+                if (posix_memalign(&memory, alignof(Slot), sizeof(Slot)) != 0) {
+                    throw std::bad_alloc();
+                }
+                slot = new (memory) Slot();
+                if (_init) {
+                    _init(slot->value);
+                }
+                _slots.push_back(slot);
+            }
+        }
+
+        Remember(slot);
+        return slot;
+    }
+
+    void Release(void *slot) override {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _free.push_back(static_cast<Slot *>(slot));
+    }
+
+    const std::function<void(T &)> _init;
+
+    // Guards slot lists
+    std::mutex _mutex;
+
+    // All slots ever created and ones left by exited threads
+    std::vector<Slot *> _slots;
+    std::vector<Slot *> _free;
+};
 
 } // namespace Concurrency
 } // namespace Afina
@@ -0,0 +1,126 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
+#define AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Task.h>
+#include <afina/concurrency/WorkStealingQueue.h>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Thread pool with work stealing
+ * Same contract as Executor, but without single queue all threads contend on. Every thread owns a deque,
+ * tasks submitted from pool threads go to the submitter own deque, tasks submitted from outside go to the
+ * global injection queue. Thread takes work from its own deque first, then from injection queue and then
+ * tries to steal from other threads starting with a random one.
+ *
+ * Pool has fixed number of threads and no bound on the number of queued tasks.
+ */
+class WorkStealingExecutor {
+public:
+    WorkStealingExecutor(std::string name, std::size_t size);
+    ~WorkStealingExecutor();
+
+    /**
+     * Signal thread pool to stop, it will stop accepting new jobs and close threads once there is no more
+     * work. All enqueued jobs will be complete.
+     *
+     * In case if await flag is true, call won't return until all background jobs are done and all threads are stopped
+     */
+    void Stop(bool await = false);
+
+    /**
+     * Add function to be executed on the threadpool. Method returns true in case if task has been placed
+     * onto execution queue, i.e scheduled for execution and false otherwise.
+     */
+    template <typename F, typename... Types> bool Execute(F &&func, Types... args) {
+        return Submit(Task(std::bind(std::forward<F>(func), std::forward<Types>(args)...)));
+    }
+
+    /**
+     * Same as Execute for the task prepared already
+     */
+    bool Submit(Task &&task);
+
+    std::size_t Threads() const { return _workers.size(); }
+
+private:
+    // Per thread state
+    struct Worker {
+        explicit Worker(WorkStealingExecutor *owner, uint64_t seed) : executor(owner), random(seed) {}
+
+        WorkStealingExecutor *executor;
+        WorkStealingQueue<Task *> deque;
+
+        // xorshift state to choose victim
+        uint64_t random;
+
+        std::thread thread;
+    };
+
+    // No copy/move/assign allowed
+    WorkStealingExecutor(const WorkStealingExecutor &) = delete;
+    WorkStealingExecutor &operator=(const WorkStealingExecutor &) = delete;
+
+    /**
+     * Main function of the pool thread
+     */
+    void OnRun(Worker *self);
+
+    /**
+     * Find something to run: own deque, injection queue, other threads
+     */
+    Task *FindTask(Worker *self);
+
+    /**
+     * Announce new work available and wake up one sleeping thread if there is any
+     */
+    void Notify();
+
+    const std::string _name;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Tasks submitted from outside of the pool
+    std::mutex _inject_mutex;
+    std::deque<Task *> _inject;
+    std::atomic<std::size_t> _inject_size;
+
+    // Bumped every time work shows up: task submitted or batch taken from the injection queue to be stolen.
+    // Sleeping thread checks it didn't change since it has started to look for work
+    std::atomic<uint64_t> _wakeups;
+
+    // Number of threads going to sleep or sleeping
+    std::atomic<std::size_t> _sleepers;
+
+    std::mutex _sleep_mutex;
+    std::condition_variable _sleep_condition;
+
+    // Pool accepts new tasks while true
+    std::atomic<bool> _running;
+
+    // Submit calls in progress, pool thread couldn't exit on stop while there are any
+    std::atomic<std::size_t> _submitting;
+
+    // Pool thread current thread is, if any
+    static thread_local Worker *_current;
+
+    // Guards joining threads
+    std::mutex _join_mutex;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_EXECUTOR_H
@@ -0,0 +1,149 @@
+#ifndef AFINA_CONCURRENCY_WORK_STEALING_QUEUE_H
+#define AFINA_CONCURRENCY_WORK_STEALING_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace Afina {
+namespace Concurrency {
+
+/**
+ * # Chase-Lev work stealing deque
+ * Owner thread pushes and pops at the bottom end without any locks, other threads steal from the top end
+ * using single CAS. Memory orders follow "Correct and Efficient Work-Stealing for Weak Memory Models" by
+ * Le, Pop, Cohen and Zappa Nardelli.
+ *
+ * Elements are read by thieves before they win the race for them, so T must be trivially copyable,
+ * normally it is a pointer. Once full the buffer doubles, old buffers are kept until deque is destroyed
+ * since a slow thief could still read from them.
+ */
+template <typename T> class WorkStealingQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "Elements are copied racily, must be trivially copyable");
+
+public:
+    explicit WorkStealingQueue(std::size_t capacity = 256) : _top(0), _bottom(0) {
+        std::size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        _buffer.store(new Buffer(size), std::memory_order_relaxed);
+    }
+
+    ~WorkStealingQueue() {
+        delete _buffer.load(std::memory_order_relaxed);
+        for (auto buffer : _retired) {
+            delete buffer;
+        }
+    }
+
+    WorkStealingQueue(const WorkStealingQueue &) = delete;
+    WorkStealingQueue &operator=(const WorkStealingQueue &) = delete;
+
+    /**
+     * Add element to the bottom, owner thread only
+     */
+    void Push(T value) {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_acquire);
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        if (b - t > int64_t(buffer->mask)) {
+            buffer = Grow(buffer, t, b);
+        }
+
+        buffer->Put(b, value);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Take element from the bottom, owner thread only. Returns false if deque is empty
+     */
+    bool Pop(T &value) {
+        int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        value = buffer->Get(b);
+        if (t == b) {
+            // The last element, race against thieves for it
+            bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /**
+     * Take element from the top, could be called by any thread. Returns false if deque is empty or
+     * another thread won the race for the element
+     */
+    bool Steal(T &value) {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = _bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return false;
+        }
+
+        Buffer *buffer = _buffer.load(std::memory_order_consume);
+        value = buffer->Get(t);
+        return _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    /**
+     * Approximate number of elements, exact for the owner while nobody steals
+     */
+    std::size_t Size() const {
+        int64_t b = _bottom.load(std::memory_order_relaxed);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? std::size_t(b - t) : 0;
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+private:
+    struct Buffer {
+        explicit Buffer(std::size_t size) : mask(size - 1), slots(new std::atomic<T>[size]) {}
+        ~Buffer() { delete[] slots; }
+
+        T Get(int64_t index) const { return slots[index & mask].load(std::memory_order_relaxed); }
+        void Put(int64_t index, T value) { slots[index & mask].store(value, std::memory_order_relaxed); }
+
+        const std::size_t mask;
+        std::atomic<T> *slots;
+    };
+
+    Buffer *Grow(Buffer *buffer, int64_t t, int64_t b) {
+        Buffer *bigger = new Buffer((buffer->mask + 1) * 2);
+        for (int64_t i = t; i < b; i++) {
+            bigger->Put(i, buffer->Get(i));
+        }
+        _retired.push_back(buffer);
+        _buffer.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    // Thieves and owner touch different ends, keep them on separate cache lines
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    alignas(64) std::atomic<Buffer *> _buffer;
+
+    // Buffers replaced by larger ones, owned by the owner thread
+    std::vector<Buffer *> _retired;
+};
+
+} // namespace Concurrency
+} // namespace Afina
+
+#endif // AFINA_CONCURRENCY_WORK_STEALING_QUEUE_H
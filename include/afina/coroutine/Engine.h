@@ -1,13 +1,14 @@
 #ifndef AFINA_COROUTINE_ENGINE_H
 #define AFINA_COROUTINE_ENGINE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
-#include <iostream>
-#include <map>
-#include <tuple>
+#include <memory>
+#include <utility>
+#include <vector>
 
-#include <setjmp.h>
+#include <afina/coroutine/Routine.h>
 
 namespace Afina {
 namespace Coroutine {
@@ -15,11 +16,24 @@ namespace Coroutine {
 /**
  * # Entry point of coroutine library
  * Allows to run coroutine and schedule its execution. Not threadsafe
+ *
+ * Every coroutine runs on a stack of its own mapped with mmap, lowest page of the stack is protected, so
+ * overflow crashes right away instead of corrupting neighbour memory. Stacks of completed coroutines are kept in
+ * the pool and reused. Switch between coroutines saves callee-saved registers on the stack being left and loads
+ * them from the stack being entered, so nothing is copied and the cost is close to a function call.
+ *
+ * Context switch is written for x86-64 System V ABI only.
  */
 class Engine final {
 public:
     using unblocker_func = std::function<void(Engine &)>;
 
+    // Default size of the coroutine stack, pages are committed by the kernel on first touch only
+    static constexpr std::size_t kDefaultStackSize = 128 * 1024;
+
+    // How many unused stacks engine keeps mapped for the future coroutines
+    static constexpr std::size_t kStackPoolSize = 64;
+
 private:
     /**
      * A single coroutine instance which could be scheduled for execution
@@ -27,17 +41,17 @@ private:
      */
     struct context;
     typedef struct context {
-        // coroutine stack start address
-        char *Low = nullptr;
+        // Stack pointer saved on switch, registers are stored on the stack itself
+        void *SP = nullptr;
 
-        // coroutine stack end address
-        char *Hight = nullptr;
+        // Lowest address of the stack mapping including guard page, nullptr for the idle context
+        char *Stack = nullptr;
 
-        // coroutine stack copy buffer
-        std::tuple<char *, uint32_t> Stack = std::make_tuple(nullptr, 0);
+        // Function to be called once coroutine starts
+        std::unique_ptr<Routine> Body;
 
-        // Saved coroutine context (registers)
-        jmp_buf Environment;
+        // Coroutine is in "blocked" list rather than "alive" one
+        bool Blocked = false;
 
         // To include routine in the different lists, such as "alive", "blocked", e.t.c
         struct context *prev = nullptr;
@@ -45,11 +59,16 @@ private:
     } context;
 
     /**
-     * Where coroutines stack begins
+     * Size of each coroutine stack mapping, including guard page
+     */
+    std::size_t StackSize;
+
+    /**
+     * Stacks of completed coroutines ready for reuse
      */
-    char *StackBottom;
+    std::vector<char *> StackPool;
 
-    /**const int&
+    /**
      * Current coroutine
      */
     context *cur_routine;
@@ -65,10 +84,16 @@ private:
     context *blocked;
 
     /**
-     * Context to be returned finally
+     * Context to be returned finally, runs on the stack of the thread called start
      */
     context *idle_ctx;
 
+    /**
+     * Coroutine completed but not freed yet: it can't release its stack while running on it, so whoever gets
+     * control next does that
+     */
+    context *finished;
+
     /**
      * Call when all coroutines are blocked
      */
@@ -76,22 +101,42 @@ private:
 
 protected:
     /**
-     * Save stack of the current coroutine in the given context
+     * Create context for the new coroutine with stack prepared to start the body on the first switch
+     */
+    context *Create(std::unique_ptr<Routine> body);
+
+    /**
+     * Suspend current context and pass control to the given one
+     */
+    void Switch(context *to);
+
+    /**
+     * Pass control to coroutines until all of them are done, or blocked with unblocker being unable to help
+     */
+    void Schedule();
+
+    /**
+     * Release resources of the coroutine completed just before the switch, if any
      */
-    void Store(context &ctx);
+    void Reap();
 
     /**
-     * Restore stack of the given context and pass control to coroutinne
+     * Free coroutine and return its stack into the pool
      */
-    void Restore(context &ctx);
+    void Destroy(context *ctx);
+
+    /**
+     * First function executed on the new coroutine stack with context and engine, never returns
+     */
+    static void Entry(void *ctx, void *engine);
 
     static void null_unblocker(Engine &) {}
 
 public:
-    Engine(unblocker_func unblocker = null_unblocker)
-        : StackBottom(0), cur_routine(nullptr), alive(nullptr), _unblocker(unblocker) {}
+    Engine(unblocker_func unblocker = null_unblocker, std::size_t stack_size = kDefaultStackSize);
     Engine(Engine &&) = delete;
     Engine(const Engine &) = delete;
+    ~Engine();
 
     /**
      * Gives up current routine execution and let engine to schedule other one. It is not defined when
@@ -108,7 +153,7 @@ public:
      * when it has been suspended previously.
      *
      * If routine to pass execution to is not specified (nullptr) then method should behaves like yield. In case
-     * if passed routine is the current one method does nothing
+     * if passed routine is the current one or it is blocked method does nothing
      */
     void sched(void *routine);
 
@@ -125,106 +170,58 @@ public:
      */
     void unblock(void *coro);
 
+    /**
+     * Currently running coroutine, nullptr outside of coroutines
+     */
+    void *current() const { return cur_routine == idle_ctx ? nullptr : cur_routine; }
+
     /**
      * Entry point into the engine. Prepare all internal mechanics and starts given function which is
      * considered as main.
      *
      * Once control returns back to caller of start all coroutines are done execution, in other words,
-     * this function doesn't return control until all coroutines are done.
+     * this function doesn't return control until all coroutines are done. Exception is the case when all
+     * routines are blocked and unblocker didn't wake any of them up: such routines are destroyed without
+     * unwinding their stacks.
      *
      * @param pointer to the main coroutine
      * @param arguments to be passed to the main coroutine
      */
     template <typename... Ta> void start(void (*main)(Ta...), Ta &&... args) {
-        // To acquire stack begin, create variable on stack and remember its address
-        char StackStartsHere;
-        this->StackBottom = &StackStartsHere;
-
-        // Start routine execution
-        void *pc = run(main, std::forward<Ta>(args)...);
+        if (idle_ctx != nullptr) {
+            // Engine is running already
+            return;
+        }
 
         idle_ctx = new context();
-        if (setjmp(idle_ctx->Environment) > 0) {
-            if (alive == nullptr) {
-                _unblocker(*this);
-            }
-
-            // Here: correct finish of the coroutine section
-            yield();
-        } else if (pc != nullptr) {
-            Store(*idle_ctx);
-            sched(pc);
+        cur_routine = idle_ctx;
+
+        // Start routine execution
+        if (run(main, std::forward<Ta>(args)...) != nullptr) {
+            Schedule();
         }
 
         // Shutdown runtime
         delete idle_ctx;
-        this->StackBottom = 0;
+        idle_ctx = nullptr;
+        cur_routine = nullptr;
     }
 
     /**
      * Register new coroutine. It won't receive control until scheduled explicitely or implicitly. In case of some
-     * errors function returns -1
+     * errors function returns nullptr.
+     *
+     * Arguments passed by reference must outlive the coroutine. Exception escaping coroutine terminates the
+     * program
      */
     template <typename... Ta> void *run(void (*func)(Ta...), Ta &&... args) {
-        if (this->StackBottom == 0) {
+        if (idle_ctx == nullptr) {
             // Engine wasn't initialized yet
             return nullptr;
         }
 
-        // New coroutine context that carries around all information enough to call function
-        context *pc = new context();
-
-        // Store current state right here, i.e just before enter new coroutine, later, once it gets scheduled
-        // execution starts here. Note that we have to acquire stack of the current function call to ensure
-        // that function parameters will be passed along
-        if (setjmp(pc->Environment) > 0) {
-            // Created routine got control in order to start execution. Note that all variables, such as
-            // context pointer, arguments and a pointer to the function comes from restored stack
-
-            // invoke routine
-            func(std::forward<Ta>(args)...);
-
-            // Routine has completed its execution, time to delete it. Note that we should be extremely careful in where
-            // to pass control after that. We never want to go backward by stack as that would mean to go backward in
-            // time. Function run() has already return once (when setjmp returns 0), so return second return from run
-            // would looks a bit awkward
-            if (pc->prev != nullptr) {
-                pc->prev->next = pc->next;
-            }
-
-            if (pc->next != nullptr) {
-                pc->next->prev = pc->prev;
-            }
-
-            if (alive == cur_routine) {
-                alive = alive->next;
-            }
-
-            // current coroutine finished, and the pointer is not relevant now
-            cur_routine = nullptr;
-            pc->prev = pc->next = nullptr;
-            delete std::get<0>(pc->Stack);
-            delete pc;
-
-            // We cannot return here, as this function "returned" once already, so here we must select some other
-            // coroutine to run. As current coroutine is completed and can't be scheduled anymore, it is safe to
-            // just give up and ask scheduler code to select someone else, control will never returns to this one
-            Restore(*idle_ctx);
-        }
-
-        // setjmp remembers position from which routine could starts execution, but to make it correctly
-        // it is neccessary to save arguments, pointer to body function, pointer to context, e.t.c - i.e
-        // save stack.
-        Store(*pc);
-
-        // Add routine as alive double-linked list
-        pc->next = alive;
-        alive = pc;
-        if (pc->next != nullptr) {
-            pc->next->prev = pc;
-        }
-
-        return pc;
+        std::unique_ptr<Routine> body(new Call<Ta...>(func, std::forward<Ta>(args)...));
+        return Create(std::move(body));
     }
 };
 
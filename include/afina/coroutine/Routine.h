@@ -0,0 +1,42 @@
+#ifndef AFINA_COROUTINE_ROUTINE_H
+#define AFINA_COROUTINE_ROUTINE_H
+
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # Type erased coroutine body: function and arguments to call it with
+ * Coroutine starts later on a stack of its own, so arguments must be kept somewhere. Arguments passed by
+ * reference are kept as references and must outlive the coroutine, the rest are copied.
+ */
+class Routine {
+public:
+    virtual ~Routine() {}
+    virtual void Run() = 0;
+};
+
+template <std::size_t... I> struct Indices {};
+template <std::size_t N, std::size_t... I> struct MakeIndices : MakeIndices<N - 1, N - 1, I...> {};
+template <std::size_t... I> struct MakeIndices<0, I...> { using type = Indices<I...>; };
+
+template <typename... Ta> class Call : public Routine {
+public:
+    Call(void (*func)(Ta...), Ta &&... args) : _func(func), _args(std::forward<Ta>(args)...) {}
+
+    void Run() override { Invoke(typename MakeIndices<sizeof...(Ta)>::type()); }
+
+private:
+    template <std::size_t... I> void Invoke(Indices<I...>) { _func(std::forward<Ta>(std::get<I>(_args))...); }
+
+    void (*_func)(Ta...);
+    std::tuple<Ta...> _args;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_ROUTINE_H
@@ -0,0 +1,306 @@
+#ifndef AFINA_COROUTINE_SCHEDULER_H
+#define AFINA_COROUTINE_SCHEDULER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <afina/concurrency/WorkStealingQueue.h>
+#include <afina/coroutine/Routine.h>
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * # M:N coroutine scheduler
+ * Runs coroutines on a fixed pool of threads. Every thread owns a work stealing deque of runnable coroutines,
+ * coroutines spawned or woken up on a pool thread go to that thread deque, ones from outside go to the global
+ * injection queue. Idle thread steals from others, so coroutines migrate between threads freely: code running
+ * in coroutine must not keep thread local state across Yield, Block and blocking I/O.
+ *
+ * Every thread has an epoll reactor of its own. Descriptor is registered in the reactor of the thread it was
+ * registered on and coroutine waiting for it is woken up there, wherever it has been running before. Thread
+ * polls its reactor when it runs out of work and once in a while in between, idle thread sleeps in
+ * epoll_wait, other threads wake it up through eventfd.
+ *
+ * Stacks are the same as in Engine: mmap with a guard page, completed coroutine stacks are cached per thread.
+ */
+class Scheduler final {
+public:
+    // Default size of the coroutine stack, pages are committed by the kernel on first touch only
+    static constexpr std::size_t kDefaultStackSize = 128 * 1024;
+
+    // How many unused stacks every thread keeps mapped for the future coroutines
+    static constexpr std::size_t kStackPoolSize = 64;
+
+    /**
+     * Descriptor registered in one of reactors, opaque for the users
+     */
+    struct Handle;
+
+    Scheduler(std::string name, std::size_t threads, std::size_t stack_size = kDefaultStackSize);
+    ~Scheduler();
+
+    Scheduler(const Scheduler &) = delete;
+    Scheduler &operator=(const Scheduler &) = delete;
+
+    /**
+     * Stop accepting new coroutines, threads exit once all coroutines are done. Nobody forces coroutines to
+     * complete, whoever stops scheduler must make them return, for example by shutting sockets down.
+     *
+     * In case if await flag is true, call won't return until all threads are stopped
+     */
+    void Stop(bool await = false);
+
+    /**
+     * Block calling thread until all threads are stopped, that is until scheduler is stopped and all coroutines
+     * are done
+     */
+    void Join();
+
+    /**
+     * Start new coroutine, could be called from any thread. Returns nullptr if scheduler is stopped or there
+     * is no memory for the stack.
+     *
+     * Arguments passed by reference must outlive the coroutine. Exception escaping coroutine terminates the
+     * program
+     */
+    template <typename... Ta> void *Spawn(void (*func)(Ta...), Ta &&... args) {
+        std::unique_ptr<Routine> body(new Call<Ta...>(func, std::forward<Ta>(args)...));
+        return Create(std::move(body));
+    }
+
+    /**
+     * Currently running coroutine of this scheduler, nullptr outside of coroutines
+     */
+    void *Current() const;
+
+    /**
+     * Put current coroutine to the end of the thread queue and let others run
+     */
+    void Yield();
+
+    /**
+     * Suspend current coroutine until Unblock. If Unblock has been called since the coroutine got control
+     * last time, returns immediately: wakeup can't be lost in between checking the condition and blocking
+     */
+    void Block();
+
+    /**
+     * Wake up coroutine blocked in Block, could be called from any thread. Call made while coroutine isn't
+     * blocked is remembered for its next Block, several such calls are merged. Coroutine must not complete
+     * while somebody could unblock it
+     */
+    void Unblock(void *coroutine);
+
+    /**
+     * Start to track non-blocking descriptor in the reactor of the current thread, or one of them if called
+     * outside of pool. Throws std::runtime_error on failure
+     */
+    Handle *Register(int fd);
+
+    /**
+     * Stop to track descriptor, must be called before it gets closed. Nobody could wait for it at that moment
+     */
+    void Unregister(Handle *handle);
+
+    /**
+     * Block current coroutine until descriptor is ready for EPOLLIN or EPOLLOUT. Could return spuriously,
+     * for example on error or hang up. Only one coroutine could wait for each direction at a time and it
+     * must not be unblocked by anybody else meanwhile
+     */
+    void Wait(Handle *handle, uint32_t events);
+
+    /**
+     * Same as read/writev/accept4, but block current coroutine instead of returning EAGAIN. Accepted
+     * descriptor is non-blocking already
+     */
+    ssize_t Read(Handle *handle, void *buffer, std::size_t size);
+    ssize_t Writev(Handle *handle, const struct iovec *iov, int iovcnt);
+    int Accept(Handle *handle, struct sockaddr *addr, socklen_t *addrlen);
+
+    std::size_t Threads() const { return _workers.size(); }
+
+private:
+    // What coroutine asked worker to do once it has switched back
+    enum Action { kYield, kPark, kFinish };
+
+    // Coroutine state, kNotified bit is the permit left by Unblock for the next Block
+    enum State { kRunnable = 0, kNotified = 1, kRunning = 2, kParked = 4 };
+
+    struct Fiber {
+        // Stack pointer saved on switch, registers are stored on the stack itself
+        void *sp = nullptr;
+
+        // Lowest address of the stack mapping including guard page
+        char *stack = nullptr;
+
+        std::unique_ptr<Routine> body;
+
+        std::atomic<int> state{kRunnable};
+    };
+
+    // Per thread state
+    struct Worker {
+        Worker(Scheduler *owner, uint64_t seed) : scheduler(owner), random(seed) {}
+
+        Scheduler *scheduler;
+        Afina::Concurrency::WorkStealingQueue<Fiber *> deque;
+
+        // xorshift state to choose victim
+        uint64_t random;
+
+        // Context of the worker loop and coroutine it runs now
+        void *sp = nullptr;
+        Fiber *current = nullptr;
+        Action action = kYield;
+
+        // Coroutines run since the last look at the reactor and injection queue
+        unsigned ticks = 0;
+
+        // Stacks of completed coroutines ready for reuse, owner thread only
+        std::vector<char *> stacks;
+
+        // Reactor and eventfd to wake thread up while it sleeps in epoll_wait
+        int epoll_fd = -1;
+        int event_fd = -1;
+
+        // Thread sleeps or is going to, whoever clears the flag must write to eventfd
+        std::atomic<bool> sleeping{false};
+
+        // Unregistered handles: epoll_wait could have returned them already, so they are freed by the owner
+        // thread before the next poll
+        std::mutex garbage_mutex;
+        std::vector<Handle *> garbage;
+        std::atomic<bool> has_garbage{false};
+
+        std::thread thread;
+    };
+
+    /**
+     * Allocate coroutine and make it runnable
+     */
+    void *Create(std::unique_ptr<Routine> body);
+
+    /**
+     * Put coroutine into queue of the current thread or injection queue and wake up somebody to run it
+     */
+    void Schedule(Fiber *fiber);
+
+    /**
+     * Wake up one sleeping thread if there is any
+     */
+    void Notify();
+
+    /**
+     * Write into eventfd of the thread
+     */
+    void Wake(Worker *worker);
+
+    /**
+     * Main function of the pool thread
+     */
+    void OnRun(Worker *self);
+
+    /**
+     * Find something to run: own deque, injection queue, own reactor, other threads
+     */
+    Fiber *FindFiber(Worker *self);
+
+    /**
+     * Take coroutine from the injection queue moving a batch more into own deque
+     */
+    Fiber *TakeInjected(Worker *self);
+
+    /**
+     * Some work could be taken by the thread
+     */
+    bool HasWork(Worker *self) const;
+
+    /**
+     * Sleep in epoll_wait until there is work
+     */
+    void Sleep(Worker *self);
+
+    /**
+     * Process reactor events, timeout is the same as for epoll_wait
+     */
+    void Poll(Worker *self, int timeout);
+
+    /**
+     * Switch to coroutine and do what it asked for once it gets back
+     */
+    void Run(Worker *self, Fiber *fiber);
+
+    /**
+     * Switch from the current coroutine back to the worker loop
+     */
+    static void Suspend(Worker *self, Action action);
+
+    /**
+     * Free coroutine and return its stack into the pool
+     */
+    void Destroy(Worker *self, Fiber *fiber);
+
+    /**
+     * First function executed on the new coroutine stack with coroutine and scheduler, never returns
+     */
+    static void Entry(void *fiber, void *scheduler);
+
+    /**
+     * Worker of the current thread, if any. Coroutine could move to another thread on every switch, so the
+     * result must not be kept across them
+     */
+    static Worker *CurrentWorker();
+
+    /**
+     * Worker of the current thread if it belongs to this scheduler
+     */
+    Worker *LocalWorker() const;
+
+    const std::string _name;
+
+    // Size of each coroutine stack mapping, including guard page
+    const std::size_t _stack_size;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Coroutines spawned or unblocked from outside of the pool
+    std::mutex _inject_mutex;
+    std::deque<Fiber *> _inject;
+    std::atomic<std::size_t> _inject_size;
+
+    // Number of threads going to sleep or sleeping
+    std::atomic<std::size_t> _sleepers;
+
+    // Number of coroutines not completed yet
+    std::atomic<std::size_t> _fibers;
+
+    // Scheduler accepts new coroutines while true
+    std::atomic<bool> _running;
+
+    // Reactor to register descriptors in when called outside of pool
+    std::atomic<std::size_t> _next_reactor;
+
+    // Pool thread current thread is, if any
+    static thread_local Worker *_current;
+
+    // Guards joining threads
+    std::mutex _join_mutex;
+};
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_SCHEDULER_H
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -20,10 +21,21 @@ namespace Execute {
  */
 class Add : public InsertCommand {
 public:
-    Add(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Add(std::string key, uint32_t flags, int32_t expire, bool noreply = false)
+        : InsertCommand(std::move(key), flags, expire, noreply) {}
     ~Add() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        bool stored = storage.PutIfAbsent(_key, args);
+        if (!_noreply) {
+            out = stored ? "STORED\r\n" : "NOT_STORED\r\n";
+        }
+    }
 };
 
 } // namespace Execute
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -21,10 +22,22 @@ namespace Execute {
  */
 class Append : public InsertCommand {
 public:
-    Append(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Append(std::string key, uint32_t flags, int32_t expire, bool noreply = false)
+        : InsertCommand(std::move(key), flags, expire, noreply) {}
     ~Append() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        std::string value;
+        bool stored = storage.Get(_key, value) && storage.Put(_key, value + args);
+        if (!_noreply) {
+            out.assign(stored ? "STORED\r\n" : "NOT_STORED\r\n");
+        }
+    }
 };
 
 } // namespace Execute
@@ -0,0 +1,235 @@
+#ifndef AFINA_EXECUTE_BINARY_H
+#define AFINA_EXECUTE_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Add.h"
+#include "Append.h"
+#include "Command.h"
+#include "Prepend.h"
+#include "Replace.h"
+#include "Set.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Request of memcached binary protocol
+ * Every packet starts with 24 bytes header: magic, opcode, key and extras lengths, total body length and opaque
+ * value that is echoed back in the response. Body is extras, key and value one after another.
+ *
+ * Parser collects the whole request packet, command executes it and writes the response packet. Storage
+ * requests are executed by the text protocol commands, their results are translated to status codes. Quiet
+ * variants don't respond on success, so client could pipeline a batch of them followed by noop.
+ *
+ * Quit closes the connection, so it is never executed: parser answers it through Parser::Error the same way
+ * it answers a request refused before its body is read.
+ */
+class Binary : public Command {
+public:
+    static constexpr uint8_t kRequestMagic = 0x80;
+    static constexpr uint8_t kResponseMagic = 0x81;
+    static constexpr std::size_t kHeaderSize = 24;
+
+    enum Opcode : uint8_t {
+        oGet = 0x00,
+        oSet = 0x01,
+        oAdd = 0x02,
+        oReplace = 0x03,
+        oDelete = 0x04,
+        oQuit = 0x07,
+        oGetQ = 0x09,
+        oNoop = 0x0a,
+        oVersion = 0x0b,
+        oGetK = 0x0c,
+        oGetKQ = 0x0d,
+        oAppend = 0x0e,
+        oPrepend = 0x0f,
+        oStat = 0x10,
+        oSetQ = 0x11,
+        oAddQ = 0x12,
+        oReplaceQ = 0x13,
+        oDeleteQ = 0x14,
+        oQuitQ = 0x17,
+        oAppendQ = 0x19,
+        oPrependQ = 0x1a
+    };
+
+    enum Status : uint16_t {
+        sSuccess = 0x00,
+        sKeyNotFound = 0x01,
+        sKeyExists = 0x02,
+        sValueTooLarge = 0x03,
+        sInvalidArguments = 0x04,
+        sNotStored = 0x05,
+        sUnknownCommand = 0x81
+    };
+
+    /**
+     * Total length of the packet, header must be there already
+     */
+    static std::size_t PacketSize(const char *header);
+
+    /**
+     * Response packet to the request with the given header, for requests answered without being executed
+     */
+    static std::string Response(const char *header, Status status, const std::string &value);
+
+    /**
+     * Decode complete request packet, throws std::runtime_error if lengths in the header don't add up
+     */
+    explicit Binary(const std::string &packet);
+    ~Binary() {}
+
+    inline uint8_t opcode() const { return _opcode; }
+    inline const std::string &key() const { return _key; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type. Value
+     * comes with the packet, so args are ignored
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        switch (_opcode) {
+        case Opcode::oGet:
+        case Opcode::oGetQ:
+        case Opcode::oGetK:
+        case Opcode::oGetKQ: {
+            if (!Expect(out, 0, true, false)) {
+                return;
+            }
+
+            // Flags are not stored, so they are always zero
+            const std::string &key = (_opcode == Opcode::oGetK || _opcode == Opcode::oGetKQ) ? _key : kEmpty;
+            std::string value;
+            if (storage.Get(_key, value)) {
+                Respond(out, Status::sSuccess, std::string(4, '\0'), key, value);
+            } else if (_opcode == Opcode::oGet || _opcode == Opcode::oGetK) {
+                Respond(out, Status::sKeyNotFound, kEmpty, key, "Not found");
+            }
+            return;
+        }
+
+        case Opcode::oSet:
+        case Opcode::oSetQ:
+        case Opcode::oAdd:
+        case Opcode::oAddQ:
+        case Opcode::oReplace:
+        case Opcode::oReplaceQ: {
+            if (!Expect(out, 8, true, true)) {
+                return;
+            }
+
+            std::string result;
+            if (_opcode == Opcode::oSet || _opcode == Opcode::oSetQ) {
+                Set(_key, _flags, _expire).Run(storage, _value, result);
+            } else if (_opcode == Opcode::oAdd || _opcode == Opcode::oAddQ) {
+                Add(_key, _flags, _expire).Run(storage, _value, result);
+            } else {
+                Replace(_key, _flags, _expire).Run(storage, _value, result);
+            }
+            Stored(out, result);
+            return;
+        }
+
+        case Opcode::oAppend:
+        case Opcode::oAppendQ:
+        case Opcode::oPrepend:
+        case Opcode::oPrependQ: {
+            if (!Expect(out, 0, true, true)) {
+                return;
+            }
+
+            std::string result;
+            if (_opcode == Opcode::oAppend || _opcode == Opcode::oAppendQ) {
+                Append(_key, 0, 0).Run(storage, _value, result);
+            } else {
+                Prepend(_key, 0, 0).Run(storage, _value, result);
+            }
+            Stored(out, result);
+            return;
+        }
+
+        case Opcode::oDelete:
+        case Opcode::oDeleteQ:
+            if (!Expect(out, 0, true, false)) {
+                return;
+            } else if (!storage.Delete(_key)) {
+                Respond(out, Status::sKeyNotFound, kEmpty, kEmpty, "Not found");
+            } else if (_opcode == Opcode::oDelete) {
+                Respond(out, Status::sSuccess, kEmpty, kEmpty, kEmpty);
+            }
+            return;
+
+        case Opcode::oStat: {
+            std::vector<std::pair<std::string, uint64_t>> stats;
+            storage.Stats(stats);
+            for (auto &stat : stats) {
+                Respond(out, Status::sSuccess, kEmpty, stat.first, std::to_string(stat.second));
+            }
+            Respond(out, Status::sSuccess, kEmpty, kEmpty, kEmpty);
+            return;
+        }
+
+        case Opcode::oNoop:
+            Respond(out, Status::sSuccess, kEmpty, kEmpty, kEmpty);
+            return;
+
+        case Opcode::oVersion:
+            Respond(out, Status::sSuccess, kEmpty, kEmpty, "afina");
+            return;
+
+        default:
+            Respond(out, Status::sUnknownCommand, kEmpty, kEmpty, "Unknown command");
+            return;
+        }
+    }
+
+private:
+    static const std::string kEmpty;
+
+    /**
+     * Check extras length and presence of key and value, respond with error if they don't match opcode
+     */
+    bool Expect(std::string &out, std::size_t extras, bool key, bool value);
+
+    /**
+     * Translate result of the text storage command
+     */
+    void Stored(std::string &out, const std::string &result);
+
+    /**
+     * Append response packet to the output
+     */
+    void Respond(std::string &out, Status status, const std::string &extras, const std::string &key,
+                 const std::string &value) {
+        Pack(out, _opcode, _opaque, status, extras, key, value);
+    }
+
+    /**
+     * Same for the request with the given opcode and opaque value
+     */
+    static void Pack(std::string &out, uint8_t opcode, uint32_t opaque, Status status, const std::string &extras,
+                     const std::string &key, const std::string &value);
+
+    uint8_t _opcode;
+    uint32_t _opaque;
+
+    // Extras of storage requests
+    std::size_t _extras_size;
+    uint32_t _flags;
+    int32_t _expire;
+
+    std::string _key;
+    std::string _value;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_BINARY_H
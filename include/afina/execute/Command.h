@@ -1,6 +1,7 @@
 #ifndef AFINA_EXECUTE_COMMAND_H
 #define AFINA_EXECUTE_COMMAND_H
 
+#include <cstddef>
 #include <string>
 
 namespace Afina {
@@ -18,7 +19,47 @@ public:
     Command() {}
     virtual ~Command() {}
 
+    /**
+     * Execute command on the storage with the given data block. Complete response, terminators included, goes to
+     * out; it stays empty if client must get nothing back
+     */
     virtual void Execute(Storage &storage, const std::string &args, std::string &out) = 0;
+
+    /**
+     * Response could be too large to be built at once, command produces it in parts then: while this is true
+     * after Execute, caller must send out what it has got and call Execute again with the same arguments to get
+     * the next part. False until the first Execute
+     */
+    virtual bool HasMore() const { return false; }
+
+    /**
+     * Command is created and destroyed for every request, so memory for it comes from the pool of the thread:
+     * free blocks are kept per size class and the next command of the same size takes one without malloc.
+     * Command could be destroyed on other thread than the one created it, block goes to that thread pool then
+     */
+    static void *operator new(std::size_t size);
+    static void operator delete(void *command, std::size_t size) noexcept;
+
+private:
+    // Sizes are rounded up to the granularity, classes cover commands up to kGranularity * kClasses bytes
+    static constexpr std::size_t kGranularity = 16;
+    static constexpr std::size_t kClasses = 16;
+
+    // Free blocks kept per class, the rest is returned to the heap
+    static constexpr std::size_t kMaxFree = 256;
+
+    struct Node {
+        Node *next;
+    };
+
+    struct Lists {
+        ~Lists();
+
+        Node *head[kClasses] = {};
+        std::size_t count[kClasses] = {};
+    };
+
+    static thread_local Lists _lists;
 };
 
 } // namespace Execute
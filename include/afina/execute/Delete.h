@@ -1,6 +1,9 @@
 #ifndef AFINA_EXECUTE_DELETE_H
 #define AFINA_EXECUTE_DELETE_H
 
+#include <string>
+#include <utility>
+
 #include "Command.h"
 
 namespace Afina {
@@ -14,13 +17,32 @@ namespace Execute {
  * Command must write result to the output, which could be:
  * - "DELETED" to indicate success
  * - "NOT_FOUND" to indicate that the item with this key was not found
+ *
+ * Client could ask for no reply, command writes nothing to the output then
  */
 class Delete : public Command {
 public:
-    Delete();
-    ~Delete();
+    Delete(std::string key, bool noreply = false) : _key(std::move(key)), _noreply(noreply) {}
+    ~Delete() {}
+
+    inline const std::string &key() const { return _key; }
+    inline bool noreply() const { return _noreply; }
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        bool deleted = storage.Delete(_key);
+        if (!_noreply) {
+            out = deleted ? "DELETED\r\n" : "NOT_FOUND\r\n";
+        }
+    }
+
+private:
+    const std::string _key;
+    const bool _noreply;
 };
 
 } // namespace Execute
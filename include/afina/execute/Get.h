@@ -1,7 +1,9 @@
 #ifndef AFINA_EXECUTE_GET_H
 #define AFINA_EXECUTE_GET_H
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Command.h"
@@ -31,18 +33,66 @@ namespace Execute {
  * hold items with such keys (because they were never stored, or stored
  * but deleted to make space for more items, or expired, or explicitly
  * deleted by a client).
+ *
+ * Values of many keys could take a lot of memory, so response is produced in batches of about kBatchSize bytes:
+ * the next batch is fetched from the storage only once the caller has sent the previous one
  */
 class Get : public Command {
 public:
-    Get(const std::vector<std::string> &keys) : _keys(keys) {}
-    ~Get() {}
+    // Response bytes fetched by one Execute call, the last value could exceed it
+    static constexpr std::size_t kBatchSize = 64 * 1024;
+
+    Get(std::vector<std::string> keys) : _keys(std::move(keys)), _next(0) {}
+    ~Get();
 
     inline const std::vector<std::string> &keys() const { return _keys; }
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
 
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        std::string value;
+        std::size_t start = out.size();
+        for (; _next < _keys.size() && out.size() - start < kBatchSize; _next++) {
+            if (!storage.Get(_keys[_next], value)) {
+                continue;
+            }
+            out.append("VALUE ").append(_keys[_next]).append(" 0 ").append(std::to_string(value.size())).append("\r\n");
+            out.append(value).append("\r\n");
+        }
+
+        if (_next == _keys.size()) {
+            out.append("END\r\n");
+            _next++;
+        }
+    }
+
+    bool HasMore() const override { return _next > 0 && _next <= _keys.size(); }
+
+    /**
+     * Empty vector to collect keys of the next command in. Completed commands leave their vectors to the thread,
+     * so keys are moved from parser into command and back without allocations
+     */
+    static std::vector<std::string> SpareKeys();
+
+    /**
+     * Leave vector of the completed command to the thread for the next one. Called from destructors, so it never
+     * throws: vector goes back to the heap if the thread has no room for it
+     */
+    static void ReturnKeys(std::vector<std::string> &keys) noexcept;
+
 private:
+    // Vectors kept by the thread, the rest is returned to the heap
+    static constexpr std::size_t kMaxSpareKeys = 64;
+
     std::vector<std::string> _keys;
+
+    // Index of the key to be fetched by the next Execute call, past the end once END is written
+    std::size_t _next;
+
+    static thread_local std::vector<std::vector<std::string>> _spare_keys;
 };
 
 } // namespace Execute
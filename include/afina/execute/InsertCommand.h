@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "Command.h"
 
@@ -11,21 +12,24 @@ namespace Execute {
 
 /**
  * # Basic class for all insert commands
- *
+ * Client could ask for no reply, command writes nothing to the output then
  */
 class InsertCommand : public Command {
 public:
-    InsertCommand(const std::string &key, uint32_t flags, int32_t expire) : _key(key), _flags(flags), _expire(expire) {}
+    InsertCommand(std::string key, uint32_t flags, int32_t expire, bool noreply = false)
+        : _key(std::move(key)), _flags(flags), _expire(expire), _noreply(noreply) {}
     ~InsertCommand() {}
 
     inline const std::string &key() const { return _key; }
     inline const uint32_t flags() const { return _flags; }
     inline const int32_t expire() const { return _expire; }
+    inline bool noreply() const { return _noreply; }
 
 protected:
     const std::string _key;
     const uint32_t _flags;
     const int32_t _expire;
+    const bool _noreply;
 };
 
 } // namespace Execute
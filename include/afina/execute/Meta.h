@@ -0,0 +1,147 @@
+#ifndef AFINA_EXECUTE_META_H
+#define AFINA_EXECUTE_META_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Command.h"
+#include "Get.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Meta commands of memcached protocol
+ * Compact commands driven by single letter flags, each one is a key followed by flags:
+ * mg <key> <flags>*\r\n
+ * ms <key> <datalen> <flags>*\r\n<data>\r\n
+ * md <key> <flags>*\r\n
+ * ma <key> <flags>*\r\n
+ * mn\r\n
+ *
+ * Response is a two letter code followed by return flags: k adds key, O echoes opaque token. Get returns
+ * "VA <size> <flags>*\r\n<data>\r\n" if value is asked with v flag, "HD <flags>*\r\n" otherwise and "EN\r\n" on
+ * miss, f, t, s and c flags ask for client flags, TTL, size and CAS. Set stores value in the mode given by M flag:
+ * S set, E add, A append, P prepend, R replace. Arithmetic increments value by 1 or delta from D flag, MD or M-
+ * flag makes it decrement, v flag asks for the result. Other codes are "NS" for not stored and "NF" for not
+ * found. Noop answers "MN\r\n", so client could tell all responses to the requests before it have arrived.
+ *
+ * Flag q makes command quiet: get doesn't report misses, the rest don't report success. Storage keeps neither
+ * client flags nor TTL nor CAS, so F and T flags are accepted and ignored, and values are reported as zero flags,
+ * no TTL and zero CAS
+ */
+class Meta : public Command {
+public:
+    /**
+     * Command is the second letter of its name, tokens are the key and flags, if any
+     */
+    Meta(char command, std::vector<std::string> tokens) : _command(command), _tokens(std::move(tokens)) {}
+    ~Meta() { Get::ReturnKeys(_tokens); }
+
+    inline char command() const { return _command; }
+
+    /**
+     * Key command works with, empty for noop
+     */
+    inline const std::string &key() const { return _tokens.empty() ? kEmpty : _tokens[0]; }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        if (!Valid()) {
+            out.assign("CLIENT_ERROR bad command line format\r\n");
+            return;
+        }
+
+        const std::string &key = _tokens.empty() ? kEmpty : _tokens[0];
+        std::string value;
+        switch (_command) {
+        case 'g':
+            if (!storage.Get(key, value)) {
+                Respond(out, "EN", nullptr);
+            } else if (Flag('v') != nullptr) {
+                Respond(out, "VA", &value);
+            } else {
+                Respond(out, "HD", &value);
+            }
+            return;
+
+        case 's': {
+            const std::string *mode = Flag('M');
+            char m = mode == nullptr ? 'S' : (*mode)[1];
+            bool stored = false;
+            if (m == 'S' || m == 's') {
+                stored = storage.Put(key, args);
+            } else if (m == 'E' || m == 'e') {
+                stored = storage.PutIfAbsent(key, args);
+            } else if (m == 'R' || m == 'r') {
+                stored = storage.Set(key, args);
+            } else if (storage.Get(key, value)) {
+                stored = storage.Put(key, (m == 'A' || m == 'a') ? value + args : args + value);
+            }
+            Respond(out, stored ? "HD" : "NS", nullptr);
+            return;
+        }
+
+        case 'd':
+            Respond(out, storage.Delete(key) ? "HD" : "NF", nullptr);
+            return;
+
+        case 'a': {
+            uint64_t number;
+            if (!storage.Get(key, value)) {
+                Respond(out, "NF", nullptr);
+            } else if (!Arithmetic(value, number)) {
+                out.assign("CLIENT_ERROR cannot increment or decrement non-numeric value\r\n");
+            } else {
+                value = std::to_string(number);
+                storage.Put(key, value);
+                Respond(out, Flag('v') != nullptr ? "VA" : "HD", &value);
+            }
+            return;
+        }
+
+        default:
+            out.assign("MN\r\n");
+            return;
+        }
+    }
+
+private:
+    static const std::string kEmpty;
+
+    /**
+     * Check that command has a key and knows all the flags
+     */
+    bool Valid() const;
+
+    /**
+     * Flag token starting with the given letter, nullptr if there is none
+     */
+    const std::string *Flag(char flag) const;
+
+    /**
+     * Apply arithmetic to the stored value, false if it isn't a number
+     */
+    bool Arithmetic(const std::string &value, uint64_t &result) const;
+
+    /**
+     * Write response code with return flags, value is appended for VA. Quiet command skips the code it is asked
+     * to keep silent about
+     */
+    void Respond(std::string &out, const char *code, const std::string *value) const;
+
+    char _command;
+    std::vector<std::string> _tokens;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_META_H
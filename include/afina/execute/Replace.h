@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -21,10 +22,22 @@ namespace Execute {
  */
 class Replace : public InsertCommand {
 public:
-    Replace(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Replace(std::string key, uint32_t flags, int32_t expire, bool noreply = false)
+        : InsertCommand(std::move(key), flags, expire, noreply) {}
     ~Replace() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        std::string value;
+        bool stored = storage.Get(_key, value) && storage.Set(_key, args);
+        if (!_noreply) {
+            out = stored ? "STORED\r\n" : "NOT_STORED\r\n";
+        }
+    }
 };
 
 } // namespace Execute
@@ -0,0 +1,180 @@
+#ifndef AFINA_EXECUTE_RESP_H
+#define AFINA_EXECUTE_RESP_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Command.h"
+#include "Get.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Request of Redis protocol (RESP2)
+ * Command is an array of bulk strings: name followed by arguments. Supported commands are
+ * - GET key: bulk string or null bulk string if there is no key
+ * - SET key value [NX | XX] [EX seconds | PX milliseconds | KEEPTTL]: "+OK", null bulk string if condition failed
+ * - DEL key [key ...], integer number of keys removed
+ * - MGET key [key ...]: array of bulk strings, null ones for missing keys
+ * - MSET key value [key value ...]: "+OK"
+ * - EXPIRE key seconds: integer 1 if key exists, 0 otherwise
+ * - APPEND key value: integer length of the new value, missing key is created
+ * - INCR key: integer result, missing key counts as 0
+ * - PING [message]: "+PONG" or the message
+ *
+ * Errors are "-ERR <message>". Storage has no expiration, so TTLs of SET are accepted and ignored as exptime of
+ * memcached commands is. EXPIRE with non-positive TTL removes key right away, positive one leaves it to LRU
+ */
+class Resp : public Command {
+public:
+    explicit Resp(std::vector<std::string> tokens);
+    ~Resp() { Get::ReturnKeys(_tokens); }
+
+    /**
+     * Keys command works with, in order
+     */
+    std::vector<std::string> keys() const;
+
+    /**
+     * Make command answer with the error instead of execution
+     */
+    void Refuse(std::string error) { _error = std::move(error); }
+
+    void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type. Arguments
+     * come with the request, so args are ignored
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        if (!_error.empty()) {
+            out.append("-ERR ").append(_error).append("\r\n");
+            return;
+        }
+
+        std::string value;
+        switch (_op) {
+        case Op::oGet:
+            if (storage.Get(_tokens[1], value)) {
+                Bulk(out, value);
+            } else {
+                out.append("$-1\r\n");
+            }
+            return;
+
+        case Op::oSet: {
+            bool stored;
+            if (_condition == 'N') {
+                stored = storage.PutIfAbsent(_tokens[1], _tokens[2]);
+            } else if (_condition == 'X') {
+                stored = storage.Set(_tokens[1], _tokens[2]);
+            } else {
+                stored = storage.Put(_tokens[1], _tokens[2]);
+            }
+            out.append(stored ? "+OK\r\n" : "$-1\r\n");
+            return;
+        }
+
+        case Op::oDel: {
+            int64_t removed = 0;
+            for (std::size_t i = 1; i < _tokens.size(); i++) {
+                removed += storage.Delete(_tokens[i]);
+            }
+            Integer(out, removed);
+            return;
+        }
+
+        case Op::oMget:
+            out.append("*").append(std::to_string(_tokens.size() - 1)).append("\r\n");
+            for (std::size_t i = 1; i < _tokens.size(); i++) {
+                if (storage.Get(_tokens[i], value)) {
+                    Bulk(out, value);
+                } else {
+                    out.append("$-1\r\n");
+                }
+            }
+            return;
+
+        case Op::oMset:
+            for (std::size_t i = 1; i < _tokens.size(); i += 2) {
+                storage.Put(_tokens[i], _tokens[i + 1]);
+            }
+            out.append("+OK\r\n");
+            return;
+
+        case Op::oExpire:
+            if (!storage.Get(_tokens[1], value)) {
+                Integer(out, 0);
+            } else {
+                if (_ttl <= 0) {
+                    storage.Delete(_tokens[1]);
+                }
+                Integer(out, 1);
+            }
+            return;
+
+        case Op::oAppend:
+            storage.Get(_tokens[1], value);
+            value.append(_tokens[2]);
+            if (storage.Put(_tokens[1], value)) {
+                Integer(out, value.size());
+            } else {
+                out.append("-ERR value is too large\r\n");
+            }
+            return;
+
+        case Op::oIncr: {
+            int64_t number = 0;
+            if (storage.Get(_tokens[1], value) && !ParseInteger(value, number)) {
+                out.append("-ERR value is not an integer or out of range\r\n");
+            } else if (number == std::numeric_limits<int64_t>::max()) {
+                out.append("-ERR increment or decrement would overflow\r\n");
+            } else {
+                storage.Put(_tokens[1], std::to_string(++number));
+                Integer(out, number);
+            }
+            return;
+        }
+
+        default:
+            if (_tokens.size() > 1) {
+                Bulk(out, _tokens[1]);
+            } else {
+                out.append("+PONG\r\n");
+            }
+            return;
+        }
+    }
+
+private:
+    enum Op : uint8_t { oGet, oSet, oDel, oMget, oMset, oExpire, oAppend, oIncr, oPing };
+
+    /**
+     * Decimal signed 64 bit integer taking the whole string
+     */
+    static bool ParseInteger(const std::string &value, int64_t &result);
+
+    static void Bulk(std::string &out, const std::string &value);
+    static void Integer(std::string &out, int64_t value);
+
+    std::vector<std::string> _tokens;
+    Op _op;
+
+    // SET condition: N for NX, X for XX, zero for none
+    char _condition;
+
+    // EXPIRE argument
+    int64_t _ttl;
+
+    // Error to answer with, if any
+    std::string _error;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_RESP_H
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <utility>
 
 #include "InsertCommand.h"
 
@@ -21,10 +22,21 @@ namespace Execute {
  */
 class Set : public InsertCommand {
 public:
-    Set(const std::string &key, uint32_t flags, int32_t expire) : InsertCommand(key, flags, expire) {}
+    Set(std::string key, uint32_t flags, int32_t expire, bool noreply = false)
+        : InsertCommand(std::move(key), flags, expire, noreply) {}
     ~Set() {}
 
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        storage.Put(_key, args);
+        if (!_noreply) {
+            out = "STORED\r\n";
+        }
+    }
 };
 
 } // namespace Execute
@@ -0,0 +1,43 @@
+#ifndef AFINA_EXECUTE_STATIC_STORAGE_H
+#define AFINA_EXECUTE_STATIC_STORAGE_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Storage policy bound at compile time
+ * Has the same methods as Storage, but calls the ones of backend class S directly: qualified calls are not
+ * dispatched through the virtual table, so compiler is free to inline them. Backend must be the exact dynamic
+ * type of the object, otherwise overrides of the derived class are skipped.
+ *
+ * Commands are executed with either Storage itself or this policy, see Variant
+ */
+template <typename S> class StaticStorage {
+public:
+    explicit StaticStorage(S &storage) : _storage(storage) {}
+
+    bool Put(const std::string &key, const std::string &value) { return _storage.S::Put(key, value); }
+
+    bool PutIfAbsent(const std::string &key, const std::string &value) { return _storage.S::PutIfAbsent(key, value); }
+
+    bool Set(const std::string &key, const std::string &value) { return _storage.S::Set(key, value); }
+
+    bool Delete(const std::string &key) { return _storage.S::Delete(key); }
+
+    bool Get(const std::string &key, std::string &value) { return _storage.S::Get(key, value); }
+
+    void Stats(std::vector<std::pair<std::string, uint64_t>> &stats) { _storage.S::Stats(stats); }
+
+private:
+    S &_storage;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_STATIC_STORAGE_H
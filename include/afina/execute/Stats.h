@@ -1,7 +1,11 @@
 #ifndef AFINA_EXECUTE_STATS_H
 #define AFINA_EXECUTE_STATS_H
 
+#include <cstdint>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "Command.h"
 
@@ -13,6 +17,22 @@ public:
     Stats() {}
     ~Stats() {}
     void Execute(Storage &storage, const std::string &args, std::string &out) override;
+
+    /**
+     * Body of Execute for any storage policy: Storage itself or StaticStorage of the exact backend type
+     */
+    template <typename S> void Run(S &storage, const std::string &args, std::string &out) {
+        std::vector<std::pair<std::string, uint64_t>> stats;
+        storage.Stats(stats);
+
+        std::stringstream outStream;
+        for (auto &stat : stats) {
+            outStream << "STAT " << stat.first << " " << stat.second << "\r\n";
+        }
+        outStream << "END\r\n";
+
+        out = outStream.str();
+    }
 };
 
 } // namespace Execute
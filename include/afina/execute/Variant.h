@@ -0,0 +1,163 @@
+#ifndef AFINA_EXECUTE_VARIANT_H
+#define AFINA_EXECUTE_VARIANT_H
+
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "Add.h"
+#include "Append.h"
+#include "Binary.h"
+#include "Delete.h"
+#include "Get.h"
+#include "Meta.h"
+#include "Prepend.h"
+#include "Replace.h"
+#include "Resp.h"
+#include "Set.h"
+#include "Stats.h"
+
+namespace Afina {
+namespace Execute {
+
+/**
+ * # Closed set of commands parser builds
+ * Holds one of them in place, so building a command takes no allocation, and executes it through a switch
+ * instead of virtual call. Commands are executed on the storage policy given as template argument: with
+ * StaticStorage of the backend type nothing on the way from command to the storage is dispatched at runtime.
+ *
+ * Commands keep their virtual interface, Variant is an alternative for the code that knows the set of commands
+ * in advance
+ */
+class Variant {
+public:
+    enum Type : uint8_t { tNone, tSet, tAdd, tAppend, tPrepend, tReplace, tDelete, tGet, tStats, tMeta, tBinary, tResp };
+
+    Variant() : _type(Type::tNone) {}
+    ~Variant() { Reset(); }
+
+    Variant(const Variant &) = delete;
+    Variant &operator=(const Variant &) = delete;
+
+    /**
+     * Replace current command, if any, with the new one constructed from the given arguments
+     */
+    template <typename T, typename... Ta> T &Emplace(Ta &&... args) {
+        Reset();
+        T *command = ::new (&_storage) T(std::forward<Ta>(args)...);
+        _type = TypeOf(command);
+        return *command;
+    }
+
+    /**
+     * Destroy current command
+     */
+    void Reset() {
+        switch (_type) {
+        case Type::tSet:
+            As<Set>().~Set();
+            break;
+        case Type::tAdd:
+            As<Add>().~Add();
+            break;
+        case Type::tAppend:
+            As<Append>().~Append();
+            break;
+        case Type::tPrepend:
+            As<Prepend>().~Prepend();
+            break;
+        case Type::tReplace:
+            As<Replace>().~Replace();
+            break;
+        case Type::tDelete:
+            As<Delete>().~Delete();
+            break;
+        case Type::tGet:
+            As<Get>().~Get();
+            break;
+        case Type::tStats:
+            As<Stats>().~Stats();
+            break;
+        case Type::tMeta:
+            As<Meta>().~Meta();
+            break;
+        case Type::tBinary:
+            As<Binary>().~Binary();
+            break;
+        case Type::tResp:
+            As<Resp>().~Resp();
+            break;
+        default:
+            break;
+        }
+        _type = Type::tNone;
+    }
+
+    inline Type type() const { return _type; }
+    inline bool Empty() const { return _type == Type::tNone; }
+
+    /**
+     * Response of the current command isn't complete, see Command::HasMore. Only multi-get streams its response
+     */
+    inline bool HasMore() const { return _type == Type::tGet && As<Get>().HasMore(); }
+
+    /**
+     * Execute current command on the storage policy, either Storage or StaticStorage
+     */
+    template <typename S> void Execute(S &storage, const std::string &args, std::string &out) {
+        switch (_type) {
+        case Type::tSet:
+            return As<Set>().Run(storage, args, out);
+        case Type::tAdd:
+            return As<Add>().Run(storage, args, out);
+        case Type::tAppend:
+            return As<Append>().Run(storage, args, out);
+        case Type::tPrepend:
+            return As<Prepend>().Run(storage, args, out);
+        case Type::tReplace:
+            return As<Replace>().Run(storage, args, out);
+        case Type::tDelete:
+            return As<Delete>().Run(storage, args, out);
+        case Type::tGet:
+            return As<Get>().Run(storage, args, out);
+        case Type::tStats:
+            return As<Stats>().Run(storage, args, out);
+        case Type::tMeta:
+            return As<Meta>().Run(storage, args, out);
+        case Type::tBinary:
+            return As<Binary>().Run(storage, args, out);
+        case Type::tResp:
+            return As<Resp>().Run(storage, args, out);
+        default:
+            throw std::runtime_error("No command to execute");
+        }
+    }
+
+private:
+    static Type TypeOf(const Set *) { return Type::tSet; }
+    static Type TypeOf(const Add *) { return Type::tAdd; }
+    static Type TypeOf(const Append *) { return Type::tAppend; }
+    static Type TypeOf(const Prepend *) { return Type::tPrepend; }
+    static Type TypeOf(const Replace *) { return Type::tReplace; }
+    static Type TypeOf(const Delete *) { return Type::tDelete; }
+    static Type TypeOf(const Get *) { return Type::tGet; }
+    static Type TypeOf(const Stats *) { return Type::tStats; }
+    static Type TypeOf(const Meta *) { return Type::tMeta; }
+    static Type TypeOf(const Binary *) { return Type::tBinary; }
+    static Type TypeOf(const Resp *) { return Type::tResp; }
+
+    template <typename T> T &As() { return *reinterpret_cast<T *>(&_storage); }
+    template <typename T> const T &As() const { return *reinterpret_cast<const T *>(&_storage); }
+
+    typename std::aligned_union<0, Set, Add, Append, Prepend, Replace, Delete, Get, Stats, Meta, Binary,
+                                  Resp>::type _storage;
+    Type _type;
+};
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_VARIANT_H
@@ -9,6 +9,14 @@ class Storage;
 namespace Logging {
 class Service;
 }
+namespace Protocol {
+
+/**
+ * Protocol clients of the server speak
+ */
+enum class Type { Memcached, Resp };
+
+} // namespace Protocol
 namespace Network {
 
 /**
@@ -21,6 +29,12 @@ public:
         : pStorage(ps), pLogging(pl) {}
     virtual ~Server() {}
 
+    /**
+     * Choose protocol for the connections, must be called before Start. Server speaks memcached protocol unless
+     * said otherwise
+     */
+    void SetProtocol(Protocol::Type value) { protocol = value; }
+
     /**
      * Starts network service. After method returns process should
      * listen on the given interface/port pair to process  incomming
@@ -55,6 +69,11 @@ protected:
      * Logging service to be used in order to report application progress
      */
     std::shared_ptr<Afina::Logging::Service> pLogging;
+
+    /**
+     * Protocol to parse requests and write responses in
+     */
+    Protocol::Type protocol = Protocol::Type::Memcached;
 };
 
 } // namespace Network
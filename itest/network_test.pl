@@ -2,7 +2,7 @@
 use 5.016;
 use warnings;
 use threads;
-use Test::More tests => 85;
+use Test::More tests => 90;
 use IO::Socket::INET;
 use Getopt::Long;
 
@@ -145,41 +145,43 @@ afina_test(
 	0
 );
 
-TODO: {
-	local $TODO = "Replace command isn't yet implemented in the parser";
-
-	afina_test(
-		"replace test_ 0 0 3\r\nwtf\r\n",
-		"NOT_STORED\r\n",
-		"Don't replace non-existent key",
-		1
-	);
+afina_test(
+	"replace test_ 0 0 3\r\nwtf\r\n",
+	"NOT_STORED\r\n",
+	"Don't replace non-existent key",
+	1
+);
 
-	afina_test(
-		"replace test 0 0 3\r\nzzz\r\n",
-		"STORED\r\n",
-		"Replace an existent key",
-		1
-	);
+afina_test(
+	"replace test 0 0 3\r\nzzz\r\n",
+	"STORED\r\n",
+	"Replace an existent key",
+	1
+);
 
-	afina_test(
-		"get test\r\n",
-		"VALUE test 0 3\r\nzzz\r\nEND\r\n",
-		"Verify replace",
-		0
-	);
-}
+afina_test(
+	"get test\r\n",
+	"VALUE test 0 3\r\nzzz\r\nEND\r\n",
+	"Verify replace",
+	0
+);
 
-TODO: {
-	local $TODO = "Delete command isn't yet implemented";
+afina_test(
+	"delete test\r\n",
+	"DELETED\r\n",
+	"Delete a key",
+	1
+);
 
-	afina_test(
-		"delete test\r\n",
-		"DELETED\r\n",
-		"Delete a key",
-		1
-	);
-}
+afina_test(
+	"set quiet 0 0 2 noreply\r\nhi\r\n"
+	."append quiet 0 0 1 noreply\r\n!\r\n"
+	."delete foo noreply\r\n"
+	."get quiet foo\r\n",
+	"VALUE quiet 0 3\r\nhi!\r\nEND\r\n",
+	"No reply to commands with noreply",
+	1
+);
 
 afina_test(
 	"blablabla 0 0 0\r\n",
@@ -0,0 +1,70 @@
+#include <afina/concurrency/AdaptiveLock.h>
+
+#include <chrono>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Concurrency {
+
+// Spin rounds before parking, round N pauses 2^N times: about a microsecond in total
+static constexpr int kSpinRounds = 8;
+
+static inline void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static bool MultipleCpus() {
+    static const bool result = sysconf(_SC_NPROCESSORS_ONLN) > 1;
+    return result;
+}
+
+// See AdaptiveLock.h
+AdaptiveLock::Stats AdaptiveLock::GetStats() const {
+    return Stats{_acquisitions.load(std::memory_order_relaxed), _contended.load(std::memory_order_relaxed),
+                 _wait_ns.load(std::memory_order_relaxed)};
+}
+
+// See AdaptiveLock.h
+void AdaptiveLock::LockContended() {
+    auto start = std::chrono::steady_clock::now();
+
+    bool acquired = false;
+    if (MultipleCpus()) {
+        for (int round = 0; round < kSpinRounds && !acquired; round++) {
+            for (int i = 0; i < (1 << round); i++) {
+                Pause();
+            }
+
+            // Read first, so that waiters don't bounce cache line with failing CAS
+            int expected = kUnlocked;
+            acquired = _state.load(std::memory_order_relaxed) == kUnlocked &&
+                       _state.compare_exchange_weak(expected, kLocked, std::memory_order_acquire,
+                                                    std::memory_order_relaxed);
+        }
+    }
+
+    // Lock is taken as parked even if nobody else waits: we can't know whether there are other sleepers,
+    // so the cost is one spare wake up
+    if (!acquired) {
+        while (_state.exchange(kParked, std::memory_order_acquire) != kUnlocked) {
+            syscall(SYS_futex, reinterpret_cast<int *>(&_state), FUTEX_WAIT_PRIVATE, kParked, nullptr, nullptr, 0);
+        }
+    }
+
+    auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    Increment(_contended, 1);
+    Increment(_wait_ns, waited.count());
+}
+
+// See AdaptiveLock.h
+void AdaptiveLock::Wake() {
+    syscall(SYS_futex, reinterpret_cast<int *>(&_state), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+} // namespace Concurrency
+} // namespace Afina
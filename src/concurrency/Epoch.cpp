@@ -0,0 +1,74 @@
+#include <afina/concurrency/Epoch.h>
+
+namespace Afina {
+namespace Concurrency {
+
+constexpr std::size_t EpochDomain::kCollectBatch;
+
+// See Epoch.h
+EpochDomain::EpochDomain() : _epoch(0) {}
+
+// See Epoch.h
+EpochDomain::~EpochDomain() {
+    // Deleters are called outside of ForEach: they could retire more objects, which takes the same lock
+    std::deque<Retired> rest;
+    do {
+        rest.clear();
+        _participants.ForEach([&rest](Participant &participant) {
+            rest.insert(rest.end(), participant.limbo.begin(), participant.limbo.end());
+            participant.limbo.clear();
+        });
+
+        for (auto &retired : rest) {
+            retired.deleter(retired.ptr);
+        }
+    } while (!rest.empty());
+}
+
+// See Epoch.h
+void EpochDomain::Retire(void *ptr, Deleter deleter) {
+    Participant &self = _participants.Get();
+    self.limbo.push_back(Retired{ptr, deleter, _epoch.load()});
+    if (++self.retired >= kCollectBatch) {
+        Collect();
+    }
+}
+
+// See Epoch.h
+std::size_t EpochDomain::Collect() {
+    Participant &self = _participants.Get();
+    self.retired = 0;
+    TryAdvance();
+
+    // Limbo is ordered by epoch. Deleter could retire more objects, so entry is removed before the call
+    std::size_t freed = 0;
+    uint64_t epoch = _epoch.load();
+    while (!self.limbo.empty() && self.limbo.front().epoch + 2 <= epoch) {
+        Retired retired = self.limbo.front();
+        self.limbo.pop_front();
+        retired.deleter(retired.ptr);
+        freed++;
+    }
+    return freed;
+}
+
+// See Epoch.h
+std::size_t EpochDomain::Pending() { return _participants.Get().limbo.size(); }
+
+// See Epoch.h
+bool EpochDomain::TryAdvance() {
+    uint64_t epoch = _epoch.load();
+
+    bool ready = true;
+    _participants.ForEach([epoch, &ready](Participant &participant) {
+        uint64_t state = participant.state.load();
+        if ((state & 1) && (state >> 1) != epoch) {
+            ready = false;
+        }
+    });
+
+    return ready && _epoch.compare_exchange_strong(epoch, epoch + 1);
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,50 @@
+#include <afina/concurrency/EventCount.h>
+
+#include <climits>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Concurrency {
+
+// See EventCount.h
+void EventCount::CancelWait(uint32_t key) {
+    // Once epoch has changed notifier has already taken us out of waiters
+    uint32_t state = _state.load(std::memory_order_relaxed);
+    while (((state ^ key) & ~kWaitersMask) == 0) {
+        if (_state.compare_exchange_weak(state, state - 1, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+// See EventCount.h
+void EventCount::Wait(uint32_t key) {
+    for (;;) {
+        uint32_t state = _state.load(std::memory_order_acquire);
+        if (((state ^ key) & ~kWaitersMask) != 0) {
+            return;
+        }
+
+        // Word also changes when other threads start to wait, then just retry with the new value
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAIT_PRIVATE, state, nullptr, nullptr, 0);
+    }
+}
+
+// See EventCount.h
+void EventCount::Wake() {
+    uint32_t state = _state.load(std::memory_order_relaxed);
+    while ((state & kWaitersMask) != 0) {
+        if (_state.compare_exchange_weak(state, (state & ~kWaitersMask) + kEpochStep, std::memory_order_release,
+                                         std::memory_order_relaxed)) {
+            syscall(SYS_futex, reinterpret_cast<uint32_t *>(&_state), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr,
+                    0);
+            return;
+        }
+    }
+}
+
+} // namespace Concurrency
+} // namespace Afina
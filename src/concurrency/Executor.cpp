@@ -1,5 +1,114 @@
 #include <afina/concurrency/Executor.h>
 
+#include <algorithm>
+
+#include <pthread.h>
+
 namespace Afina {
-namespace Concurrency {}
+namespace Concurrency {
+
+// See Executor.h
+void perform(Executor *executor);
+
+// See Executor.h
+Executor::Executor(std::string name, std::size_t low_watermark, std::size_t high_watermark,
+                   std::size_t max_queue_size, std::chrono::milliseconds idle_time, RejectPolicy policy)
+    : name(std::move(name)), low_watermark(low_watermark), high_watermark(std::max(std::size_t(1), high_watermark)),
+      max_queue_size(max_queue_size), idle_time(idle_time), policy(policy), threads(0), free_threads(0),
+      state(State::kRun) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (threads < std::min(this->low_watermark, this->high_watermark)) {
+        StartThread();
+    }
+}
+
+// See Executor.h
+Executor::~Executor() { Stop(true); }
+
+// See Executor.h
+void Executor::Stop(bool await) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (state == State::kRun) {
+        state = threads > 0 ? State::kStopping : State::kStopped;
+        empty_condition.notify_all();
+    }
+
+    if (await) {
+        while (state != State::kStopped) {
+            stop_condition.wait(lock);
+        }
+    }
+}
+
+// See Executor.h
+std::size_t Executor::Threads() const {
+    std::unique_lock<std::mutex> lock(mutex);
+    return threads;
+}
+
+// See Executor.h
+std::size_t Executor::FreeThreads() const {
+    std::unique_lock<std::mutex> lock(mutex);
+    return free_threads;
+}
+
+// See Executor.h
+std::size_t Executor::Queued() const {
+    std::unique_lock<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+// See Executor.h
+void Executor::StartThread() {
+    std::thread thread(perform, this);
+    pthread_setname_np(thread.native_handle(), name.substr(0, 15).c_str());
+    thread.detach();
+
+    threads++;
+    free_threads++;
+}
+
+// See Executor.h
+void perform(Executor *executor) {
+    std::unique_lock<std::mutex> lock(executor->mutex);
+    for (;;) {
+        if (executor->tasks.empty()) {
+            if (executor->state != Executor::State::kRun) {
+                break;
+            }
+
+            auto status = executor->empty_condition.wait_for(lock, executor->idle_time);
+            if (status == std::cv_status::timeout && executor->tasks.empty() &&
+                executor->state == Executor::State::kRun && executor->threads > executor->low_watermark) {
+                // Idle for too long and the pool could live without us
+                break;
+            }
+            continue;
+        }
+
+        Task task = std::move(executor->tasks.front());
+        executor->tasks.pop_front();
+        executor->free_threads--;
+        lock.unlock();
+
+        try {
+            task();
+        } catch (...) {
+            // There is nobody to report to, task must take care of its errors by itself. Anyway thread
+            // should stay in the pool
+        }
+
+        lock.lock();
+        executor->free_threads++;
+    }
+
+    executor->free_threads--;
+    executor->threads--;
+    if (executor->threads == 0 && executor->state == Executor::State::kStopping) {
+        executor->state = Executor::State::kStopped;
+        executor->stop_condition.notify_all();
+    }
+}
+
+} // namespace Concurrency
 } // namespace Afina
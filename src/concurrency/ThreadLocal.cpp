@@ -0,0 +1,116 @@
+#include <afina/concurrency/ThreadLocal.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Afina {
+namespace Concurrency {
+
+namespace {
+
+// Instances alive, indexed by id
+struct Registered {
+    uint64_t generation;
+    ThreadLocalBase *owner;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<Registered> instances;
+    std::vector<std::size_t> free_ids;
+    uint64_t next_generation = 1;
+};
+
+// Function local so that instances with static storage could be created in any order
+Registry &GetRegistry() {
+    static Registry *registry = new Registry;
+    return *registry;
+}
+
+} // namespace
+
+/**
+ * Releases slots of the exiting thread. Thread local with destructor is constructed on the first use only,
+ * so Remember touches it
+ */
+struct ThreadLocalCache {
+    ~ThreadLocalCache() {
+        ThreadLocalBase::Cache &cache = ThreadLocalBase::_cache;
+
+        Registry &registry = GetRegistry();
+        {
+            std::unique_lock<std::mutex> lock(registry.mutex);
+            for (std::size_t id = 0; id < cache.size && id < registry.instances.size(); id++) {
+                const ThreadLocalBase::Entry &entry = cache.entries[id];
+                const Registered &instance = registry.instances[id];
+                if (entry.generation != 0 && entry.generation == instance.generation) {
+                    instance.owner->Release(entry.slot);
+                }
+            }
+        }
+
+        std::free(cache.entries);
+        cache.entries = nullptr;
+        cache.size = 0;
+    }
+
+    bool armed = false;
+};
+
+static thread_local ThreadLocalCache thread_cleanup;
+
+// See ThreadLocal.h
+__thread ThreadLocalBase::Cache ThreadLocalBase::_cache = {nullptr, 0};
+
+// See ThreadLocal.h
+ThreadLocalBase::ThreadLocalBase() {
+    Registry &registry = GetRegistry();
+    std::unique_lock<std::mutex> lock(registry.mutex);
+
+    _generation = registry.next_generation++;
+    if (!registry.free_ids.empty()) {
+        _id = registry.free_ids.back();
+        registry.free_ids.pop_back();
+        registry.instances[_id] = Registered{_generation, this};
+    } else {
+        _id = registry.instances.size();
+        registry.instances.push_back(Registered{_generation, this});
+    }
+}
+
+// See ThreadLocal.h
+ThreadLocalBase::~ThreadLocalBase() { Unregister(); }
+
+// See ThreadLocal.h
+void ThreadLocalBase::Unregister() {
+    Registry &registry = GetRegistry();
+    std::unique_lock<std::mutex> lock(registry.mutex);
+
+    Registered &instance = registry.instances[_id];
+    if (instance.generation == _generation) {
+        instance = Registered{0, nullptr};
+        registry.free_ids.push_back(_id);
+    }
+}
+
+// See ThreadLocal.h
+void ThreadLocalBase::Remember(void *slot) {
+    thread_cleanup.armed = true;
+
+    if (_id >= _cache.size) {
+        std::size_t size = std::max(_id + 1, _cache.size * 2);
+        Entry *entries = static_cast<Entry *>(std::realloc(_cache.entries, size * sizeof(Entry)));
+        if (entries == nullptr) {
+            throw std::bad_alloc();
+        }
+        std::memset(entries + _cache.size, 0, (size - _cache.size) * sizeof(Entry));
+
+        _cache.entries = entries;
+        _cache.size = size;
+    }
+
+    _cache.entries[_id] = Entry{_generation, slot};
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,235 @@
+#include <afina/concurrency/WorkStealingExecutor.h>
+
+#include <algorithm>
+
+#include <pthread.h>
+
+namespace Afina {
+namespace Concurrency {
+
+// Queued tasks are kept by pointer, released ones are cached per thread for reuse so that steady flow of
+// tasks doesn't allocate
+static constexpr std::size_t kTaskCacheSize = 1024;
+
+// How many tasks to move from injection queue into own deque at once, others are free to steal them
+static constexpr std::size_t kInjectBatch = 32;
+
+// How many times idle thread rescans queues before going to sleep, waking it up costs much more
+static constexpr int kSpinRounds = 16;
+
+namespace {
+
+struct TaskCache {
+    ~TaskCache() {
+        for (auto task : free) {
+            delete task;
+        }
+    }
+
+    std::vector<Task *> free;
+};
+
+thread_local TaskCache task_cache;
+
+Task *AllocateTask(Task &&task) {
+    auto &free = task_cache.free;
+    if (free.empty()) {
+        return new Task(std::move(task));
+    }
+
+    Task *result = free.back();
+    free.pop_back();
+    *result = std::move(task);
+    return result;
+}
+
+void ReleaseTask(Task *task) {
+    task->Reset();
+    if (task_cache.free.size() < kTaskCacheSize) {
+        task_cache.free.push_back(task);
+    } else {
+        delete task;
+    }
+}
+
+} // namespace
+
+// See WorkStealingExecutor.h
+thread_local WorkStealingExecutor::Worker *WorkStealingExecutor::_current = nullptr;
+
+// See WorkStealingExecutor.h
+WorkStealingExecutor::WorkStealingExecutor(std::string name, std::size_t size)
+    : _name(std::move(name)), _inject_size(0), _wakeups(0), _sleepers(0), _running(true), _submitting(0) {
+    size = std::max(std::size_t(1), size);
+    for (std::size_t i = 0; i < size; i++) {
+        _workers.emplace_back(new Worker(this, 0x9E3779B97F4A7C15ull * (i + 1)));
+    }
+
+    // All deques must exist before anybody tries to steal
+    for (auto &worker : _workers) {
+        worker->thread = std::thread(&WorkStealingExecutor::OnRun, this, worker.get());
+        pthread_setname_np(worker->thread.native_handle(), _name.substr(0, 15).c_str());
+    }
+}
+
+// See WorkStealingExecutor.h
+WorkStealingExecutor::~WorkStealingExecutor() {
+    Stop(true);
+    for (auto task : _inject) {
+        delete task;
+    }
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::Stop(bool await) {
+    _running.store(false);
+    {
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _sleep_condition.notify_all();
+    }
+
+    if (await) {
+        std::unique_lock<std::mutex> lock(_join_mutex);
+        for (auto &worker : _workers) {
+            if (worker->thread.joinable() && worker->thread.get_id() != std::this_thread::get_id()) {
+                worker->thread.join();
+            }
+        }
+    }
+}
+
+// See WorkStealingExecutor.h
+bool WorkStealingExecutor::Submit(Task &&task) {
+    _submitting.fetch_add(1);
+    if (!_running.load()) {
+        _submitting.fetch_sub(1);
+        return false;
+    }
+
+    Task *queued = AllocateTask(std::move(task));
+    Worker *self = _current;
+    if (self != nullptr && self->executor == this) {
+        self->deque.Push(queued);
+    } else {
+        std::unique_lock<std::mutex> lock(_inject_mutex);
+        _inject.push_back(queued);
+        _inject_size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    _submitting.fetch_sub(1);
+    Notify();
+    return true;
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::Notify() {
+    // Counter goes first, so either sleeper is seen here or it sees the counter changed
+    _wakeups.fetch_add(1);
+    if (_sleepers.load() > 0) {
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _sleep_condition.notify_one();
+    }
+}
+
+// See WorkStealingExecutor.h
+Task *WorkStealingExecutor::FindTask(Worker *self) {
+    Task *task = nullptr;
+    if (self->deque.Pop(task)) {
+        return task;
+    }
+
+    if (_inject_size.load(std::memory_order_relaxed) > 0) {
+        std::unique_lock<std::mutex> lock(_inject_mutex);
+        if (!_inject.empty()) {
+            task = _inject.front();
+            _inject.pop_front();
+
+            std::size_t batch = std::min(kInjectBatch, _inject.size());
+            for (std::size_t i = 0; i < batch; i++) {
+                self->deque.Push(_inject.front());
+                _inject.pop_front();
+            }
+            _inject_size.fetch_sub(batch + 1, std::memory_order_relaxed);
+            lock.unlock();
+
+            // Let sleeping threads to steal the batch
+            if (batch > 0) {
+                Notify();
+            }
+            return task;
+        }
+    }
+
+    // Random victim first, then everybody else in order. Steal could fail due to race with another thief,
+    // so there is a second round
+    std::size_t count = _workers.size();
+    if (count > 1) {
+        self->random ^= self->random << 13;
+        self->random ^= self->random >> 7;
+        self->random ^= self->random << 17;
+        std::size_t start = self->random % count;
+
+        for (int round = 0; round < 2; round++) {
+            for (std::size_t i = 0; i < count; i++) {
+                Worker *victim = _workers[(start + i) % count].get();
+                if (victim != self && victim->deque.Steal(task)) {
+                    return task;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+// See WorkStealingExecutor.h
+void WorkStealingExecutor::OnRun(Worker *self) {
+    _current = self;
+    for (;;) {
+        uint64_t seen = _wakeups.load();
+        Task *task = FindTask(self);
+        for (int spin = 0; task == nullptr && spin < kSpinRounds && _running.load(); spin++) {
+            std::this_thread::yield();
+            task = FindTask(self);
+        }
+
+        if (task == nullptr && !_running.load()) {
+            // Once pool is stopped no new tasks could appear, except from Submit calls that have passed the
+            // check already. Wait for them and scan the last time
+            if (_submitting.load() > 0) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            task = FindTask(self);
+            if (task == nullptr) {
+                break;
+            }
+        }
+
+        if (task != nullptr) {
+            try {
+                (*task)();
+            } catch (...) {
+                // There is nobody to report to, task must take care of its errors by itself
+            }
+            ReleaseTask(task);
+            continue;
+        }
+
+        // Nothing to do. Whoever makes work available increments counter before it checks for sleepers, so
+        // either it sees us or we see the counter changed: both new task and batch moved from injection queue
+        // into a deque wake us up
+        _sleepers.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(_sleep_mutex);
+            while (_running.load() && _wakeups.load() == seen) {
+                _sleep_condition.wait(lock);
+            }
+        }
+        _sleepers.fetch_sub(1);
+    }
+    _current = nullptr;
+}
+
+} // namespace Concurrency
+} // namespace Afina
@@ -0,0 +1,97 @@
+#include "Context.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+asm(R"(
+    .text
+    .globl afina_coroutine_switch
+    .hidden afina_coroutine_switch
+    .type afina_coroutine_switch, @function
+afina_coroutine_switch:
+    .cfi_startproc
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .cfi_endproc
+    .size afina_coroutine_switch, .-afina_coroutine_switch
+
+    .globl afina_coroutine_trampoline
+    .hidden afina_coroutine_trampoline
+    .type afina_coroutine_trampoline, @function
+afina_coroutine_trampoline:
+    .cfi_startproc
+    .cfi_undefined rip
+    movq %r12, %rdi
+    movq %r13, %rsi
+    andq $-16, %rsp
+    callq *%r14
+    ud2
+    .cfi_endproc
+    .size afina_coroutine_trampoline, .-afina_coroutine_trampoline
+)");
+
+namespace Afina {
+namespace Coroutine {
+
+// Order of registers afina_coroutine_switch pops from the stack, followed by return address
+enum Frame { kR15, kR14, kR13, kR12, kRbx, kRbp, kReturn, kFrameSize = 8 };
+
+static std::size_t PageSize() {
+    static const std::size_t result = sysconf(_SC_PAGESIZE);
+    return result;
+}
+
+// See Context.h
+std::size_t StackMappingSize(std::size_t stack_size) {
+    std::size_t page = PageSize();
+    return (stack_size + page - 1) / page * page + page;
+}
+
+// See Context.h
+char *MapStack(std::size_t mapping_size) {
+    void *mapping =
+        mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    if (mapping == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Stack grows down, overflow hits the lowest page
+    if (mprotect(mapping, PageSize(), PROT_NONE) != 0) {
+        munmap(mapping, mapping_size);
+        return nullptr;
+    }
+    return static_cast<char *>(mapping);
+}
+
+// See Context.h
+void UnmapStack(char *stack, std::size_t mapping_size) { munmap(stack, mapping_size); }
+
+// See Context.h
+void *PrepareStack(char *stack, std::size_t mapping_size, void (*entry)(void *, void *), void *arg0, void *arg1) {
+    // Frame as if afina_coroutine_switch has been called by trampoline, top of the mapping is page aligned
+    void **frame = reinterpret_cast<void **>(stack + mapping_size) - kFrameSize;
+    for (int i = 0; i < kFrameSize; i++) {
+        frame[i] = nullptr;
+    }
+    frame[kR12] = arg0;
+    frame[kR13] = arg1;
+    frame[kR14] = reinterpret_cast<void *>(entry);
+    frame[kReturn] = reinterpret_cast<void *>(&afina_coroutine_trampoline);
+    return frame;
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -0,0 +1,52 @@
+#ifndef AFINA_COROUTINE_CONTEXT_H
+#define AFINA_COROUTINE_CONTEXT_H
+
+#include <cstddef>
+
+#if !defined(__x86_64__)
+#error "Coroutine context switch is implemented for x86-64 only"
+#endif
+
+extern "C" {
+
+/**
+ * Save callee-saved registers on the current stack, store stack pointer into *save_sp, switch to load_sp and
+ * restore registers saved there. Returns into whatever called switch on the target stack last time
+ */
+void afina_coroutine_switch(void **save_sp, void *load_sp);
+
+/**
+ * First return address on the new stack: calls r14(r12, r13), which never returns. Return address is marked
+ * undefined, so unwinders and debuggers stop here
+ */
+void afina_coroutine_trampoline();
+}
+
+namespace Afina {
+namespace Coroutine {
+
+/**
+ * Size of the stack mapping for the given usable size: rounded up to pages plus the guard page
+ */
+std::size_t StackMappingSize(std::size_t stack_size);
+
+/**
+ * Map stack of the given mapping size with the lowest page protected, returns nullptr on failure
+ */
+char *MapStack(std::size_t mapping_size);
+
+/**
+ * Release stack mapped by MapStack
+ */
+void UnmapStack(char *stack, std::size_t mapping_size);
+
+/**
+ * Prepare stack so that the first switch to the returned stack pointer calls entry(arg0, arg1) on it. Entry
+ * must never return, it leaves the stack by switching somewhere else
+ */
+void *PrepareStack(char *stack, std::size_t mapping_size, void (*entry)(void *, void *), void *arg0, void *arg1);
+
+} // namespace Coroutine
+} // namespace Afina
+
+#endif // AFINA_COROUTINE_CONTEXT_H
@@ -1,19 +1,178 @@
 #include <afina/coroutine/Engine.h>
 
-#include <setjmp.h>
-#include <stdio.h>
-#include <string.h>
+#include "Context.h"
 
 namespace Afina {
 namespace Coroutine {
 
-void Engine::Store(context &ctx) {}
+template <typename T> static void Link(T *&head, T *node) {
+    node->prev = nullptr;
+    node->next = head;
+    if (head != nullptr) {
+        head->prev = node;
+    }
+    head = node;
+}
 
-void Engine::Restore(context &ctx) {}
+template <typename T> static void Unlink(T *&head, T *node) {
+    if (node->prev != nullptr) {
+        node->prev->next = node->next;
+    }
+    if (node->next != nullptr) {
+        node->next->prev = node->prev;
+    }
+    if (head == node) {
+        head = node->next;
+    }
+    node->prev = node->next = nullptr;
+}
 
-void Engine::yield() {}
+// See Engine.h
+Engine::Engine(unblocker_func unblocker, std::size_t stack_size)
+    : StackSize(StackMappingSize(stack_size)), cur_routine(nullptr), alive(nullptr), blocked(nullptr),
+      idle_ctx(nullptr), finished(nullptr), _unblocker(unblocker) {}
 
-void Engine::sched(void *routine_) {}
+// See Engine.h
+Engine::~Engine() {
+    for (char *stack : StackPool) {
+        UnmapStack(stack, StackSize);
+    }
+}
+
+// See Engine.h
+Engine::context *Engine::Create(std::unique_ptr<Routine> body) {
+    char *stack = nullptr;
+    if (!StackPool.empty()) {
+        stack = StackPool.back();
+        StackPool.pop_back();
+    } else if ((stack = MapStack(StackSize)) == nullptr) {
+        return nullptr;
+    }
+
+    context *ctx = new context();
+    ctx->Stack = stack;
+    ctx->Body = std::move(body);
+    ctx->SP = PrepareStack(stack, StackSize, &Engine::Entry, ctx, this);
+
+    Link(alive, ctx);
+    return ctx;
+}
+
+// See Engine.h
+void Engine::Switch(context *to) {
+    context *from = cur_routine;
+    cur_routine = to;
+    afina_coroutine_switch(&from->SP, to->SP);
+
+    // Back in from: somebody has switched to it
+    Reap();
+}
+
+// See Engine.h
+void Engine::Schedule() {
+    for (;;) {
+        if (alive == nullptr) {
+            if (blocked == nullptr) {
+                break;
+            }
+
+            _unblocker(*this);
+            if (alive == nullptr) {
+                break;
+            }
+        }
+        Switch(alive);
+    }
+
+    // Nobody is going to wake them up
+    while (blocked != nullptr) {
+        context *ctx = blocked;
+        Unlink(blocked, ctx);
+        Destroy(ctx);
+    }
+}
+
+// See Engine.h
+void Engine::Reap() {
+    if (finished != nullptr) {
+        Destroy(finished);
+        finished = nullptr;
+    }
+}
+
+// See Engine.h
+void Engine::Destroy(context *ctx) {
+    if (StackPool.size() < kStackPoolSize) {
+        StackPool.push_back(ctx->Stack);
+    } else {
+        UnmapStack(ctx->Stack, StackSize);
+    }
+    delete ctx;
+}
+
+// See Engine.h
+void Engine::Entry(void *ctx_, void *engine_) {
+    context *ctx = static_cast<context *>(ctx_);
+    Engine *engine = static_cast<Engine *>(engine_);
+    engine->Reap();
+    ctx->Body->Run();
+    ctx->Body.reset();
+
+    // Stack can't be freed while we are on it, so the next one to run does it
+    Unlink(engine->alive, ctx);
+    engine->finished = ctx;
+    engine->Switch(engine->alive != nullptr ? engine->alive : engine->idle_ctx);
+}
+
+// See Engine.h
+void Engine::yield() {
+    context *next = cur_routine->next != nullptr ? cur_routine->next : alive;
+    if (next == nullptr || next == cur_routine) {
+        return;
+    }
+    Switch(next);
+}
+
+// See Engine.h
+void Engine::sched(void *routine_) {
+    context *routine = static_cast<context *>(routine_);
+    if (routine == nullptr) {
+        yield();
+        return;
+    }
+    if (routine == cur_routine || routine->Blocked) {
+        return;
+    }
+    Switch(routine);
+}
+
+// See Engine.h
+void Engine::block(void *coro) {
+    context *ctx = coro != nullptr ? static_cast<context *>(coro) : cur_routine;
+    if (ctx == nullptr || ctx == idle_ctx || ctx->Blocked) {
+        return;
+    }
+
+    Unlink(alive, ctx);
+    ctx->Blocked = true;
+    Link(blocked, ctx);
+
+    if (ctx == cur_routine) {
+        Switch(alive != nullptr ? alive : idle_ctx);
+    }
+}
+
+// See Engine.h
+void Engine::unblock(void *coro) {
+    context *ctx = static_cast<context *>(coro);
+    if (ctx == nullptr || !ctx->Blocked) {
+        return;
+    }
+
+    Unlink(blocked, ctx);
+    ctx->Blocked = false;
+    Link(alive, ctx);
+}
 
 } // namespace Coroutine
 } // namespace Afina
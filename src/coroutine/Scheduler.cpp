@@ -0,0 +1,581 @@
+#include <afina/coroutine/Scheduler.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "Context.h"
+
+namespace Afina {
+namespace Coroutine {
+
+// Events descriptor is always registered for
+static constexpr uint32_t kReadEvents = EPOLLIN | EPOLLRDHUP | EPOLLET;
+
+// Value of the handle waiter slot: edge came while nobody waited. Otherwise slot holds nothing or the waiter
+static constexpr uintptr_t kReady = 1;
+
+// Once in that many coroutines thread looks into its reactor and injection queue even if own deque isn't
+// empty, so that neither I/O nor coroutines from outside starve behind busy ones
+static constexpr unsigned kFairnessInterval = 61;
+
+// How many coroutines to move from injection queue into own deque at once, others are free to steal them
+static constexpr std::size_t kInjectBatch = 32;
+
+// See Scheduler.h
+struct Scheduler::Handle {
+    Handle(int fd_, Worker *owner_) : fd(fd_), owner(owner_), reader(0), writer(0) {}
+
+    int fd;
+    Worker *owner;
+
+    // Coroutine waiting for the direction, kReady or nothing
+    std::atomic<uintptr_t> reader;
+    std::atomic<uintptr_t> writer;
+};
+
+// See Scheduler.h
+thread_local Scheduler::Worker *Scheduler::_current = nullptr;
+
+// Signal waiter slot, returns coroutine to wake up if there was any
+static uintptr_t Signal(std::atomic<uintptr_t> &slot) {
+    uintptr_t waiter = slot.exchange(kReady);
+    return waiter > kReady ? waiter : 0;
+}
+
+// epoll_ctl for the handle, returns false on failure
+static bool Control(int epoll_fd, int op, int fd, void *data, uint32_t events) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.ptr = data;
+    return epoll_ctl(epoll_fd, op, fd, &event) == 0;
+}
+
+// See Scheduler.h
+Scheduler::Scheduler(std::string name, std::size_t threads, std::size_t stack_size)
+    : _name(std::move(name)), _stack_size(StackMappingSize(stack_size)), _inject_size(0), _sleepers(0), _fibers(0),
+      _running(true), _next_reactor(0) {
+    threads = std::max(std::size_t(1), threads);
+    for (std::size_t i = 0; i < threads; i++) {
+        std::unique_ptr<Worker> worker(new Worker(this, 0x9E3779B97F4A7C15ull * (i + 1)));
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        worker->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        bool registered = worker->epoll_fd != -1 && worker->event_fd != -1 &&
+                          Control(worker->epoll_fd, EPOLL_CTL_ADD, worker->event_fd, nullptr, EPOLLIN);
+        _workers.push_back(std::move(worker));
+        if (!registered) {
+            std::string error = strerror(errno);
+            for (auto &w : _workers) {
+                close(w->epoll_fd);
+                close(w->event_fd);
+            }
+            throw std::runtime_error("Failed to create reactor: " + error);
+        }
+    }
+
+    // All deques must exist before anybody tries to steal
+    for (auto &worker : _workers) {
+        worker->thread = std::thread(&Scheduler::OnRun, this, worker.get());
+        pthread_setname_np(worker->thread.native_handle(), _name.substr(0, 15).c_str());
+    }
+}
+
+// See Scheduler.h
+Scheduler::~Scheduler() {
+    Stop(true);
+    for (auto &worker : _workers) {
+        for (char *stack : worker->stacks) {
+            UnmapStack(stack, _stack_size);
+        }
+        for (Handle *handle : worker->garbage) {
+            delete handle;
+        }
+        close(worker->epoll_fd);
+        close(worker->event_fd);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Stop(bool await) {
+    _running.store(false);
+    for (auto &worker : _workers) {
+        Wake(worker.get());
+    }
+
+    if (await) {
+        Join();
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Join() {
+    std::unique_lock<std::mutex> lock(_join_mutex);
+    for (auto &worker : _workers) {
+        if (worker->thread.joinable() && worker->thread.get_id() != std::this_thread::get_id()) {
+            worker->thread.join();
+        }
+    }
+}
+
+// See Scheduler.h
+void *Scheduler::Create(std::unique_ptr<Routine> body) {
+    // Counted first, so that threads can't see zero and exit while coroutine is being created
+    _fibers.fetch_add(1);
+    if (!_running.load()) {
+        _fibers.fetch_sub(1);
+        return nullptr;
+    }
+
+    Worker *self = LocalWorker();
+    char *stack = nullptr;
+    if (self != nullptr && !self->stacks.empty()) {
+        stack = self->stacks.back();
+        self->stacks.pop_back();
+    } else if ((stack = MapStack(_stack_size)) == nullptr) {
+        _fibers.fetch_sub(1);
+        return nullptr;
+    }
+
+    Fiber *fiber = new Fiber();
+    fiber->stack = stack;
+    fiber->body = std::move(body);
+    fiber->sp = PrepareStack(stack, _stack_size, &Scheduler::Entry, fiber, this);
+    Schedule(fiber);
+    return fiber;
+}
+
+// See Scheduler.h
+void Scheduler::Schedule(Fiber *fiber) {
+    Worker *self = LocalWorker();
+    if (self != nullptr) {
+        self->deque.Push(fiber);
+
+        // Owner runs the only queued coroutine soon enough by itself, bothering others is worth it for the
+        // surplus only
+        if (self->deque.Size() < 2) {
+            return;
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(_inject_mutex);
+        _inject.push_back(fiber);
+        _inject_size.fetch_add(1, std::memory_order_relaxed);
+    }
+    Notify();
+}
+
+// See Scheduler.h
+void Scheduler::Notify() {
+    // Pairs with the fence in Sleep: either sleeper sees the work or we see the sleeper
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepers.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    for (auto &worker : _workers) {
+        if (worker->sleeping.load(std::memory_order_relaxed) && worker->sleeping.exchange(false)) {
+            Wake(worker.get());
+            return;
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Wake(Worker *worker) { eventfd_write(worker->event_fd, 1); }
+
+// See Scheduler.h
+void *Scheduler::Current() const {
+    Worker *self = LocalWorker();
+    return self != nullptr ? self->current : nullptr;
+}
+
+// See Scheduler.h
+void Scheduler::Yield() {
+    Worker *self = LocalWorker();
+    if (self != nullptr && self->current != nullptr) {
+        Suspend(self, kYield);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Block() {
+    Worker *self = LocalWorker();
+    if (self == nullptr || self->current == nullptr) {
+        return;
+    }
+
+    // Permit left by Unblock
+    int notified = kRunning | kNotified;
+    if (!self->current->state.compare_exchange_strong(notified, kRunning)) {
+        Suspend(self, kPark);
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Unblock(void *coroutine) {
+    Fiber *fiber = static_cast<Fiber *>(coroutine);
+    if (fiber == nullptr) {
+        return;
+    }
+
+    int state = fiber->state.load();
+    for (;;) {
+        if (state == kParked) {
+            if (fiber->state.compare_exchange_weak(state, kRunnable)) {
+                Schedule(fiber);
+                return;
+            }
+        } else if ((state & kNotified) || fiber->state.compare_exchange_weak(state, state | kNotified)) {
+            // Coroutine isn't parked yet, worker parking it sees the permit, see Run
+            return;
+        }
+    }
+}
+
+// See Scheduler.h
+Scheduler::Handle *Scheduler::Register(int fd) {
+    Worker *owner = LocalWorker();
+    if (owner == nullptr) {
+        owner = _workers[_next_reactor.fetch_add(1, std::memory_order_relaxed) % _workers.size()].get();
+    }
+
+    Handle *handle = new Handle(fd, owner);
+    if (!Control(owner->epoll_fd, EPOLL_CTL_ADD, fd, handle, kReadEvents)) {
+        delete handle;
+        throw std::runtime_error("Failed to add file descriptor to epoll: " + std::string(strerror(errno)));
+    }
+    return handle;
+}
+
+// See Scheduler.h
+void Scheduler::Unregister(Handle *handle) {
+    Worker *owner = handle->owner;
+    epoll_ctl(owner->epoll_fd, EPOLL_CTL_DEL, handle->fd, nullptr);
+
+    std::unique_lock<std::mutex> lock(owner->garbage_mutex);
+    owner->garbage.push_back(handle);
+    owner->has_garbage.store(true, std::memory_order_release);
+}
+
+// See Scheduler.h
+void Scheduler::Wait(Handle *handle, uint32_t events) {
+    Worker *self = LocalWorker();
+    if (self == nullptr || self->current == nullptr) {
+        return;
+    }
+
+    std::atomic<uintptr_t> &slot = (events & EPOLLIN) ? handle->reader : handle->writer;
+    int epoll_fd = handle->owner->epoll_fd;
+
+    // Socket is writable almost always, so EPOLLOUT is watched only while somebody waits for it. Otherwise
+    // every ACK would wake epoll_wait up for nothing. Re-arming reports the current state right away
+    bool output = !(events & EPOLLIN);
+    if (output && !Control(epoll_fd, EPOLL_CTL_MOD, handle->fd, handle, kReadEvents | EPOLLOUT)) {
+        return;
+    }
+
+    // Edge that came before we got here is kept in the slot, so it can't be lost
+    uintptr_t expected = 0;
+    if (slot.compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(self->current))) {
+        Block();
+    }
+
+    // Caller retries operation anyway, so the edge consumed here isn't lost either
+    slot.store(0);
+    if (output) {
+        Control(epoll_fd, EPOLL_CTL_MOD, handle->fd, handle, kReadEvents);
+    }
+}
+
+// See Scheduler.h
+ssize_t Scheduler::Read(Handle *handle, void *buffer, std::size_t size) {
+    for (;;) {
+        ssize_t result = read(handle->fd, buffer, size);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLIN);
+        }
+    }
+}
+
+// See Scheduler.h
+ssize_t Scheduler::Writev(Handle *handle, const struct iovec *iov, int iovcnt) {
+    for (;;) {
+        ssize_t result = writev(handle->fd, iov, iovcnt);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLOUT);
+        }
+    }
+}
+
+// See Scheduler.h
+int Scheduler::Accept(Handle *handle, struct sockaddr *addr, socklen_t *addrlen) {
+    for (;;) {
+        socklen_t len = *addrlen;
+        int result = accept4(handle->fd, addr, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (result >= 0) {
+            *addrlen = len;
+            return result;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLIN);
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::OnRun(Worker *self) {
+    _current = self;
+    for (;;) {
+        Fiber *fiber = FindFiber(self);
+        if (fiber != nullptr) {
+            Run(self, fiber);
+            continue;
+        }
+
+        if (!_running.load() && _fibers.load() == 0) {
+            break;
+        }
+        Sleep(self);
+    }
+    _current = nullptr;
+}
+
+// See Scheduler.h
+Scheduler::Fiber *Scheduler::FindFiber(Worker *self) {
+    Fiber *fiber = nullptr;
+    if (++self->ticks >= kFairnessInterval) {
+        self->ticks = 0;
+        Poll(self, 0);
+        if ((fiber = TakeInjected(self)) != nullptr) {
+            return fiber;
+        }
+    }
+
+    if (self->deque.Pop(fiber) || (fiber = TakeInjected(self)) != nullptr) {
+        return fiber;
+    }
+
+    Poll(self, 0);
+    if (self->deque.Pop(fiber)) {
+        return fiber;
+    }
+
+    // Random victim first, then everybody else in order. Steal could fail due to race with another thief,
+    // so there is a second round
+    std::size_t count = _workers.size();
+    if (count > 1) {
+        self->random ^= self->random << 13;
+        self->random ^= self->random >> 7;
+        self->random ^= self->random << 17;
+        std::size_t start = self->random % count;
+
+        for (int round = 0; round < 2; round++) {
+            for (std::size_t i = 0; i < count; i++) {
+                Worker *victim = _workers[(start + i) % count].get();
+                if (victim != self && victim->deque.Steal(fiber)) {
+                    return fiber;
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+// See Scheduler.h
+Scheduler::Fiber *Scheduler::TakeInjected(Worker *self) {
+    if (_inject_size.load(std::memory_order_relaxed) == 0) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(_inject_mutex);
+    if (_inject.empty()) {
+        return nullptr;
+    }
+
+    Fiber *fiber = _inject.front();
+    _inject.pop_front();
+
+    std::size_t batch = std::min(kInjectBatch, _inject.size());
+    for (std::size_t i = 0; i < batch; i++) {
+        self->deque.Push(_inject.front());
+        _inject.pop_front();
+    }
+    _inject_size.fetch_sub(batch + 1, std::memory_order_relaxed);
+    lock.unlock();
+
+    // Let sleeping threads to steal the batch
+    if (batch > 0) {
+        Notify();
+    }
+    return fiber;
+}
+
+// See Scheduler.h
+bool Scheduler::HasWork(Worker *self) const {
+    if (_inject_size.load(std::memory_order_relaxed) > 0 || (!_running.load() && _fibers.load() == 0)) {
+        return true;
+    }
+    for (auto &worker : _workers) {
+        if (!worker->deque.Empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// See Scheduler.h
+void Scheduler::Sleep(Worker *self) {
+    self->sleeping.store(true);
+    _sleepers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Work could have appeared while we were looking for it. Once the flag is set, whoever schedules a coroutine
+    // later sees it and writes into eventfd, so epoll_wait can't miss it
+    if (!HasWork(self)) {
+        Poll(self, -1);
+    }
+
+    self->sleeping.store(false);
+    _sleepers.fetch_sub(1);
+}
+
+// See Scheduler.h
+void Scheduler::Poll(Worker *self, int timeout) {
+    // Nobody could get these handles from epoll_wait anymore and the events got from it before are processed
+    if (self->has_garbage.load(std::memory_order_acquire)) {
+        std::vector<Handle *> garbage;
+        {
+            std::unique_lock<std::mutex> lock(self->garbage_mutex);
+            garbage.swap(self->garbage);
+            self->has_garbage.store(false, std::memory_order_relaxed);
+        }
+        for (Handle *handle : garbage) {
+            delete handle;
+        }
+    }
+
+    std::array<struct epoll_event, 64> events;
+    int count = epoll_wait(self->epoll_fd, events.data(), events.size(), timeout);
+    for (int i = 0; i < count; i++) {
+        Handle *handle = static_cast<Handle *>(events[i].data.ptr);
+        if (handle == nullptr) {
+            eventfd_t value;
+            eventfd_read(self->event_fd, &value);
+            continue;
+        }
+
+        // Errors wake up both sides, so they notice it on the next call
+        uint32_t ready = events[i].events;
+        uintptr_t reader = 0, writer = 0;
+        if (ready & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) {
+            reader = Signal(handle->reader);
+        }
+        if (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+            writer = Signal(handle->writer);
+        }
+
+        if (reader != 0) {
+            Unblock(reinterpret_cast<Fiber *>(reader));
+        }
+        if (writer != 0) {
+            Unblock(reinterpret_cast<Fiber *>(writer));
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Run(Worker *self, Fiber *fiber) {
+    fiber->state.fetch_or(kRunning);
+    self->current = fiber;
+    afina_coroutine_switch(&self->sp, fiber->sp);
+    self->current = nullptr;
+
+    // Coroutine stack is saved completely by now, so it is safe to let other threads resume it. Once they
+    // could, fiber must not be touched anymore: it could be running or even completed already
+    switch (self->action) {
+    case kYield:
+        // Permit is kept till the next Block
+        fiber->state.fetch_and(kNotified);
+        Schedule(fiber);
+        break;
+
+    case kPark: {
+        int expected = kRunning;
+        if (!fiber->state.compare_exchange_strong(expected, kParked)) {
+            // Unblock came while coroutine was parking, nobody else changes notified state
+            fiber->state.store(kRunnable);
+            Schedule(fiber);
+        }
+        break;
+    }
+
+    case kFinish:
+        Destroy(self, fiber);
+        break;
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Suspend(Worker *self, Action action) {
+    self->action = action;
+    afina_coroutine_switch(&self->current->sp, self->sp);
+}
+
+// See Scheduler.h
+void Scheduler::Destroy(Worker *self, Fiber *fiber) {
+    if (self->stacks.size() < kStackPoolSize) {
+        self->stacks.push_back(fiber->stack);
+    } else {
+        UnmapStack(fiber->stack, _stack_size);
+    }
+    delete fiber;
+
+    // The last one after stop, let everybody exit
+    if (_fibers.fetch_sub(1) == 1 && !_running.load()) {
+        for (auto &worker : _workers) {
+            Wake(worker.get());
+        }
+    }
+}
+
+// See Scheduler.h
+void Scheduler::Entry(void *fiber_, void *scheduler_) {
+    Fiber *fiber = static_cast<Fiber *>(fiber_);
+    fiber->body->Run();
+    fiber->body.reset();
+
+    // Stack can't be freed while we are on it, so the worker does it
+    Suspend(CurrentWorker(), kFinish);
+}
+
+// See Scheduler.h
+__attribute__((noinline)) Scheduler::Worker *Scheduler::CurrentWorker() {
+    // Not inlined: address of thread local must be computed anew after every switch, while compiler assumes it
+    // is the same within function
+    return _current;
+}
+
+// See Scheduler.h
+Scheduler::Worker *Scheduler::LocalWorker() const {
+    Worker *self = CurrentWorker();
+    return self != nullptr && self->scheduler == this ? self : nullptr;
+}
+
+} // namespace Coroutine
+} // namespace Afina
@@ -0,0 +1,113 @@
+#include <afina/Storage.h>
+#include <afina/execute/Binary.h>
+
+#include <stdexcept>
+
+namespace Afina {
+namespace Execute {
+
+constexpr uint8_t Binary::kRequestMagic;
+constexpr uint8_t Binary::kResponseMagic;
+constexpr std::size_t Binary::kHeaderSize;
+
+const std::string Binary::kEmpty;
+
+// Numbers in packets are in network byte order
+static uint32_t Load(const char *packet, std::size_t offset, std::size_t size) {
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < size; i++) {
+        value = (value << 8) | uint8_t(packet[offset + i]);
+    }
+    return value;
+}
+
+static void Store(std::string &out, uint32_t value, std::size_t size) {
+    for (std::size_t i = size; i > 0; i--) {
+        out.push_back(char(value >> (8 * (i - 1))));
+    }
+}
+
+// See Binary.h
+std::size_t Binary::PacketSize(const char *header) { return kHeaderSize + Load(header, 8, 4); }
+
+// See Binary.h
+std::string Binary::Response(const char *header, Status status, const std::string &value) {
+    std::string out;
+    Pack(out, uint8_t(header[1]), Load(header, 12, 4), status, kEmpty, kEmpty, value);
+    return out;
+}
+
+// See Binary.h
+Binary::Binary(const std::string &packet) : _flags(0), _expire(0) {
+    if (packet.size() < kHeaderSize || uint8_t(packet[0]) != kRequestMagic) {
+        throw std::runtime_error("Malformed binary request");
+    }
+
+    _opcode = uint8_t(packet[1]);
+    std::size_t key_size = Load(packet.data(), 2, 2);
+    _extras_size = uint8_t(packet[4]);
+    std::size_t body_size = Load(packet.data(), 8, 4);
+    _opaque = Load(packet.data(), 12, 4);
+    if (packet.size() != kHeaderSize + body_size || _extras_size + key_size > body_size) {
+        throw std::runtime_error("Malformed binary request lengths");
+    }
+
+    if (_extras_size == 8) {
+        _flags = Load(packet.data(), kHeaderSize, 4);
+        _expire = int32_t(Load(packet.data(), kHeaderSize + 4, 4));
+    }
+    _key.assign(packet, kHeaderSize + _extras_size, key_size);
+    _value.assign(packet, kHeaderSize + _extras_size + key_size, std::string::npos);
+}
+
+// memcached binary protocol: the same commands as text ones, packed into frames with opaque request id.
+void Binary::Execute(Storage &storage, const std::string &args, std::string &out) { Run(storage, args, out); }
+
+// See Binary.h
+bool Binary::Expect(std::string &out, std::size_t extras, bool key, bool value) {
+    if (_extras_size != extras || _key.empty() != !key || (!value && !_value.empty())) {
+        Respond(out, Status::sInvalidArguments, kEmpty, kEmpty, "Invalid arguments");
+        return false;
+    }
+    return true;
+}
+
+// See Binary.h
+void Binary::Stored(std::string &out, const std::string &result) {
+    bool quiet = _opcode == Opcode::oSetQ || _opcode == Opcode::oAddQ || _opcode == Opcode::oReplaceQ ||
+                 _opcode == Opcode::oAppendQ || _opcode == Opcode::oPrependQ;
+    if (result == "STORED\r\n") {
+        if (!quiet) {
+            Respond(out, Status::sSuccess, kEmpty, kEmpty, kEmpty);
+        }
+    } else if (_opcode == Opcode::oAdd || _opcode == Opcode::oAddQ) {
+        Respond(out, Status::sKeyExists, kEmpty, kEmpty, "Data exists for key");
+    } else if (_opcode == Opcode::oReplace || _opcode == Opcode::oReplaceQ) {
+        Respond(out, Status::sKeyNotFound, kEmpty, kEmpty, "Not found");
+    } else {
+        Respond(out, Status::sNotStored, kEmpty, kEmpty, "Not stored");
+    }
+}
+
+// See Binary.h
+void Binary::Pack(std::string &out, uint8_t opcode, uint32_t opaque, Status status, const std::string &extras,
+                  const std::string &key, const std::string &value) {
+    out.reserve(out.size() + kHeaderSize + extras.size() + key.size() + value.size());
+    out.push_back(char(kResponseMagic));
+    out.push_back(char(opcode));
+    Store(out, key.size(), 2);
+    Store(out, extras.size(), 1);
+
+    // Data type is always raw bytes, CAS isn't supported
+    Store(out, 0, 1);
+    Store(out, status, 2);
+    Store(out, extras.size() + key.size() + value.size(), 4);
+    Store(out, opaque, 4);
+    Store(out, 0, 4);
+    Store(out, 0, 4);
+
+    out.append(extras).append(key).append(value);
+}
+
+} // namespace Execute
+} // namespace Afina
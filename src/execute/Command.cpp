@@ -1 +1,53 @@
 #include <afina/execute/Command.h>
+
+#include <new>
+
+namespace Afina {
+namespace Execute {
+
+// See Command.h
+thread_local Command::Lists Command::_lists;
+
+// See Command.h
+Command::Lists::~Lists() {
+    for (std::size_t i = 0; i < kClasses; i++) {
+        while (head[i] != nullptr) {
+            Node *node = head[i];
+            head[i] = node->next;
+            ::operator delete(node);
+        }
+    }
+}
+
+// See Command.h
+void *Command::operator new(std::size_t size) {
+    std::size_t index = (size + kGranularity - 1) / kGranularity - 1;
+    if (index >= kClasses) {
+        return ::operator new(size);
+    }
+
+    Node *node = _lists.head[index];
+    if (node == nullptr) {
+        return ::operator new((index + 1) * kGranularity);
+    }
+    _lists.head[index] = node->next;
+    _lists.count[index]--;
+    return node;
+}
+
+// See Command.h
+void Command::operator delete(void *command, std::size_t size) noexcept {
+    std::size_t index = (size + kGranularity - 1) / kGranularity - 1;
+    if (index >= kClasses || _lists.count[index] >= kMaxFree) {
+        ::operator delete(command);
+        return;
+    }
+
+    Node *node = static_cast<Node *>(command);
+    node->next = _lists.head[index];
+    _lists.head[index] = node;
+    _lists.count[index]++;
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,11 @@
+#include <afina/Storage.h>
+#include <afina/execute/Delete.h>
+
+namespace Afina {
+namespace Execute {
+
+// memcached protocol: "delete" means "remove the item with this key".
+void Delete::Execute(Storage &storage, const std::string &args, std::string &out) { Run(storage, args, out); }
+
+} // namespace Execute
+} // namespace Afina
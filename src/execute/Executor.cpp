@@ -0,0 +1,42 @@
+#include "Executor.h"
+
+#include <typeinfo>
+
+#include <afina/Storage.h>
+#include <afina/execute/StaticStorage.h>
+
+#include "storage/FlatCombineLRU.h"
+#include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
+#include "storage/ThreadSafeSimpleLRU.h"
+
+namespace Afina {
+namespace Execute {
+
+template <typename S>
+static void RunStatic(Storage &storage, Variant &command, const std::string &args, std::string &out) {
+    StaticStorage<S> policy(static_cast<S &>(storage));
+    command.Execute(policy, args, out);
+}
+
+static void RunVirtual(Storage &storage, Variant &command, const std::string &args, std::string &out) {
+    command.Execute(storage, args, out);
+}
+
+// See Executor.h
+Executor StaticExecutor(const Storage &storage) {
+    const std::type_info &type = typeid(storage);
+    if (type == typeid(Backend::SimpleLRU)) {
+        return RunStatic<Backend::SimpleLRU>;
+    } else if (type == typeid(Backend::ThreadSafeSimplLRU)) {
+        return RunStatic<Backend::ThreadSafeSimplLRU>;
+    } else if (type == typeid(Backend::StripedLRU)) {
+        return RunStatic<Backend::StripedLRU>;
+    } else if (type == typeid(Backend::FlatCombineLRU)) {
+        return RunStatic<Backend::FlatCombineLRU>;
+    }
+    return RunVirtual;
+}
+
+} // namespace Execute
+} // namespace Afina
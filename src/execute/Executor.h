@@ -0,0 +1,30 @@
+#ifndef AFINA_EXECUTE_EXECUTOR_H
+#define AFINA_EXECUTE_EXECUTOR_H
+
+#include <string>
+
+#include <afina/execute/Variant.h>
+
+namespace Afina {
+
+class Storage;
+
+namespace Execute {
+
+/**
+ * Executes command held by the variant on the storage
+ */
+using Executor = void (*)(Storage &storage, Variant &command, const std::string &args, std::string &out);
+
+/**
+ * # Executor bound to the storage type
+ * Returns executor instantiated for the dynamic type of the storage: command, storage policy and backend methods
+ * are all resolved at compile time, so the only indirect call left on the way is the one to the executor itself.
+ * Storage of the type not known here is driven through the virtual interface
+ */
+Executor StaticExecutor(const Storage &storage);
+
+} // namespace Execute
+} // namespace Afina
+
+#endif // AFINA_EXECUTE_EXECUTOR_H
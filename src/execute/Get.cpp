@@ -1,13 +1,51 @@
+#include <exception>
+
 #include <afina/Storage.h>
 #include <afina/execute/Get.h>
 
-#include <iostream>
-#include <iterator>
-#include <sstream>
-
 namespace Afina {
 namespace Execute {
 
+// See Get.h
+constexpr std::size_t Get::kBatchSize;
+
+// See Get.h
+thread_local std::vector<std::vector<std::string>> Get::_spare_keys;
+
+// See Get.h
+Get::~Get() { ReturnKeys(_keys); }
+
+// See Get.h
+void Get::ReturnKeys(std::vector<std::string> &keys) noexcept {
+    if (keys.capacity() == 0) {
+        return;
+    }
+
+    // Room for all the spare vectors is allocated once, so push_back below never allocates
+    if (_spare_keys.capacity() < kMaxSpareKeys) {
+        try {
+            _spare_keys.reserve(kMaxSpareKeys);
+        } catch (std::exception &) {
+            return;
+        }
+    }
+
+    if (_spare_keys.size() < kMaxSpareKeys) {
+        keys.clear();
+        _spare_keys.push_back(std::move(keys));
+    }
+}
+
+// See Get.h
+std::vector<std::string> Get::SpareKeys() {
+    std::vector<std::string> result;
+    if (!_spare_keys.empty()) {
+        result = std::move(_spare_keys.back());
+        _spare_keys.pop_back();
+    }
+    return result;
+}
+
 /* memcached protocol:
 
 Each item sent by the server looks like this:
@@ -21,24 +59,8 @@ to indicate the end of response.
 
 */
 
-void Get::Execute(Storage &storage, const std::string &args, std::string &out) {
-    std::stringstream keyStream;
-    copy(_keys.begin(), _keys.end(), std::ostream_iterator<std::string>(keyStream, " "));
-    std::cout << "Get(" << keyStream.str() << ")" << std::endl;
-
-    std::stringstream outStream;
-
-    std::string value;
-    for (auto &key : _keys) {
-        if (!storage.Get(key, value))
-            continue;
-        outStream << "VALUE " << key << " 0 " << value.size() << "\r\n";
-        outStream << value << "\r\n";
-    }
-    outStream << "END"; // networking layer should add the last \r\n
-
-    out = outStream.str();
-}
+// See Get.h
+void Get::Execute(Storage &storage, const std::string &args, std::string &out) { Run(storage, args, out); }
 
 } // namespace Execute
 } // namespace Afina
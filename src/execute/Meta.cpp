@@ -0,0 +1,155 @@
+#include <afina/Storage.h>
+#include <afina/execute/Meta.h>
+
+#include <cstring>
+#include <limits>
+
+namespace Afina {
+namespace Execute {
+
+const std::string Meta::kEmpty;
+
+// Flags every command understands, including the ones that are accepted and ignored
+static const char *Allowed(char command) {
+    switch (command) {
+    case 'g':
+        return "vkqOftsc";
+    case 's':
+        return "kqOFTM";
+    case 'd':
+        return "kqO";
+    case 'a':
+        return "vkqODM";
+    default:
+        return "";
+    }
+}
+
+// Decimal number taking the whole string, up to 2^64 - 1
+static bool ParseNumber(const char *begin, const char *end, uint64_t &value) {
+    if (begin == end) {
+        return false;
+    }
+
+    value = 0;
+    for (const char *p = begin; p < end; p++) {
+        uint64_t digit = *p - '0';
+        if (digit > 9 || value > (std::numeric_limits<uint64_t>::max() - digit) / 10) {
+            return false;
+        }
+        value = value * 10 + digit;
+    }
+    return true;
+}
+
+// memcached protocol: meta commands, "mg", "ms", "md", "ma" and "mn".
+void Meta::Execute(Storage &storage, const std::string &args, std::string &out) { Run(storage, args, out); }
+
+// See Meta.h
+bool Meta::Valid() const {
+    if (_command == 'n') {
+        return _tokens.empty();
+    } else if (_tokens.empty() || _tokens[0].empty()) {
+        return false;
+    }
+
+    uint64_t number;
+    const char *modes = _command == 's' ? "SsEeRrAaPp" : "IiDd+-";
+    for (std::size_t i = 1; i < _tokens.size(); i++) {
+        const std::string &token = _tokens[i];
+        if (token.empty() || std::strchr(Allowed(_command), token[0]) == nullptr) {
+            return false;
+        } else if (token[0] == 'M' && (token.size() != 2 || std::strchr(modes, token[1]) == nullptr)) {
+            return false;
+        } else if ((token[0] == 'D' || token[0] == 'F') &&
+                   !ParseNumber(token.data() + 1, token.data() + token.size(), number)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See Meta.h
+const std::string *Meta::Flag(char flag) const {
+    for (std::size_t i = 1; i < _tokens.size(); i++) {
+        if (_tokens[i][0] == flag) {
+            return &_tokens[i];
+        }
+    }
+    return nullptr;
+}
+
+// See Meta.h
+bool Meta::Arithmetic(const std::string &value, uint64_t &result) const {
+    uint64_t delta = 1;
+    if (!ParseNumber(value.data(), value.data() + value.size(), result)) {
+        return false;
+    }
+    if (const std::string *d = Flag('D')) {
+        ParseNumber(d->data() + 1, d->data() + d->size(), delta);
+    }
+
+    // Increment wraps around, decrement stops at zero
+    const std::string *mode = Flag('M');
+    if (mode != nullptr && std::strchr("Dd-", (*mode)[1]) != nullptr) {
+        result = result > delta ? result - delta : 0;
+    } else {
+        result += delta;
+    }
+    return true;
+}
+
+// See Meta.h
+void Meta::Respond(std::string &out, const char *code, const std::string *value) const {
+    bool quiet = Flag('q') != nullptr;
+    if (std::strcmp(code, "EN") == 0) {
+        if (!quiet) {
+            out.append("EN\r\n");
+        }
+        return;
+    } else if (quiet && _command != 'g' && std::strcmp(code, "HD") == 0) {
+        return;
+    }
+
+    bool va = std::strcmp(code, "VA") == 0;
+    out.append(code);
+    if (va) {
+        out.append(" ").append(std::to_string(value->size()));
+    }
+
+    for (std::size_t i = 1; i < _tokens.size(); i++) {
+        const std::string &token = _tokens[i];
+        switch (token[0]) {
+        case 'k':
+            out.append(" k").append(_tokens[0]);
+            break;
+        case 'O':
+            out.append(" ").append(token);
+            break;
+        case 'f':
+            out.append(" f0");
+            break;
+        case 't':
+            out.append(" t-1");
+            break;
+        case 'c':
+            out.append(" c0");
+            break;
+        case 's':
+            if (_command == 'g' && value != nullptr) {
+                out.append(" s").append(std::to_string(value->size()));
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    out.append("\r\n");
+
+    if (va) {
+        out.append(*value).append("\r\n");
+    }
+}
+
+} // namespace Execute
+} // namespace Afina
@@ -0,0 +1,140 @@
+#include <afina/Storage.h>
+#include <afina/execute/Resp.h>
+
+#include <cctype>
+#include <limits>
+
+namespace Afina {
+namespace Execute {
+
+// Command name in upper case
+static std::string Upper(const std::string &name) {
+    std::string result(name);
+    for (auto &c : result) {
+        c = std::toupper(static_cast<unsigned char>(c));
+    }
+    return result;
+}
+
+// See Resp.h
+Resp::Resp(std::vector<std::string> tokens) : _tokens(std::move(tokens)), _op(Op::oPing), _condition(0), _ttl(0) {
+    std::string name = _tokens.empty() ? std::string() : Upper(_tokens[0]);
+    std::size_t size = _tokens.size();
+
+    // Number of arguments: exact one, or minimum one and required parity of the rest
+    bool arity;
+    if (name == "GET") {
+        _op = Op::oGet;
+        arity = size == 2;
+    } else if (name == "SET") {
+        _op = Op::oSet;
+        arity = size >= 3;
+    } else if (name == "DEL") {
+        _op = Op::oDel;
+        arity = size >= 2;
+    } else if (name == "MGET") {
+        _op = Op::oMget;
+        arity = size >= 2;
+    } else if (name == "MSET") {
+        _op = Op::oMset;
+        arity = size >= 3 && size % 2 == 1;
+    } else if (name == "EXPIRE") {
+        _op = Op::oExpire;
+        arity = size == 3;
+    } else if (name == "APPEND") {
+        _op = Op::oAppend;
+        arity = size == 3;
+    } else if (name == "INCR") {
+        _op = Op::oIncr;
+        arity = size == 2;
+    } else if (name == "PING") {
+        _op = Op::oPing;
+        arity = size <= 2;
+    } else {
+        _error = "unknown command '" + (_tokens.empty() ? std::string() : _tokens[0]) + "'";
+        return;
+    }
+
+    if (!arity) {
+        _error = "wrong number of arguments for '" + _tokens[0] + "' command";
+    } else if (_op == Op::oExpire && !ParseInteger(_tokens[2], _ttl)) {
+        _error = "value is not an integer or out of range";
+    } else if (_op == Op::oSet) {
+        // Options, expiration ones are accepted and ignored
+        bool expire = false;
+        for (std::size_t i = 3; i < size && _error.empty(); i++) {
+            std::string option = Upper(_tokens[i]);
+            int64_t ttl;
+            if ((option == "NX" || option == "XX") && _condition == 0) {
+                _condition = option[0];
+            } else if ((option == "EX" || option == "PX") && !expire && i + 1 < size) {
+                if (!ParseInteger(_tokens[++i], ttl) || ttl <= 0) {
+                    _error = "invalid expire time in 'set' command";
+                }
+                expire = true;
+            } else if (option == "KEEPTTL" && !expire) {
+                expire = true;
+            } else {
+                _error = "syntax error";
+            }
+        }
+    }
+}
+
+// See Resp.h
+std::vector<std::string> Resp::keys() const {
+    std::vector<std::string> result;
+    if (!_error.empty() || _op == Op::oPing) {
+        return result;
+    } else if (_op == Op::oDel || _op == Op::oMget) {
+        result.assign(_tokens.begin() + 1, _tokens.end());
+    } else if (_op == Op::oMset) {
+        for (std::size_t i = 1; i < _tokens.size(); i += 2) {
+            result.push_back(_tokens[i]);
+        }
+    } else {
+        result.push_back(_tokens[1]);
+    }
+    return result;
+}
+
+// Redis protocol: request is an array of bulk strings, reply type depends on the command.
+void Resp::Execute(Storage &storage, const std::string &args, std::string &out) { Run(storage, args, out); }
+
+// See Resp.h
+bool Resp::ParseInteger(const std::string &value, int64_t &result) {
+    std::size_t i = value.size() > 1 && value[0] == '-';
+    if (i == value.size() || (value[i] == '0' && value.size() > i + 1)) {
+        return false;
+    }
+
+    // Accumulate negative, so that minimum value fits as well
+    int64_t number = 0;
+    for (; i < value.size(); i++) {
+        int64_t digit = value[i] - '0';
+        if (digit < 0 || digit > 9 || number < (std::numeric_limits<int64_t>::min() + digit) / 10) {
+            return false;
+        }
+        number = number * 10 - digit;
+    }
+
+    if (value[0] != '-') {
+        if (number == std::numeric_limits<int64_t>::min()) {
+            return false;
+        }
+        number = -number;
+    }
+    result = number;
+    return true;
+}
+
+// See Resp.h
+void Resp::Bulk(std::string &out, const std::string &value) {
+    out.append("$").append(std::to_string(value.size())).append("\r\n").append(value).append("\r\n");
+}
+
+// See Resp.h
+void Resp::Integer(std::string &out, int64_t value) { out.append(":").append(std::to_string(value)).append("\r\n"); }
+
+} // namespace Execute
+} // namespace Afina
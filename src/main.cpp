@@ -1,4 +1,5 @@
 #include <chrono>
+#include <functional>
 #include <iostream>
 #include <memory>
 
@@ -16,11 +17,15 @@
 
 #include "logging/ServiceImpl.h"
 #include "network/mt_blocking/ServerImpl.h"
+#include "network/mt_coroutine/ServerImpl.h"
 #include "network/mt_nonblocking/ServerImpl.h"
+#include "network/mt_sharded/ServerImpl.h"
 #include "network/st_blocking/ServerImpl.h"
 #include "network/st_coroutine/ServerImpl.h"
 #include "network/st_nonblocking/ServerImpl.h"
+#include "network/st_stackless/ServerImpl.h"
 
+#include "storage/FlatCombineLRU.h"
 #include "storage/SimpleLRU.h"
 #include "storage/ThreadSafeSimpleLRU.h"
 #include "storage/StripedLRU.h"
@@ -48,18 +53,27 @@ public:
         logService.reset(new Logging::ServiceImpl(logConfig));
 
         // Step 1: configure storage
-        std::string storage_type = "st_lru";
+        // Two servers run on top of the same storage in case of Redis port, so it must be thread safe
+        std::string storage_type = options.count("resp") > 0 ? "mt_lru" : "st_lru";
         if (options.count("storage") > 0) {
             storage_type = options["storage"].as<std::string>();
         }
 
+        // Sharded network needs storage per shard, so keep the way to make one of the given size
+        std::function<std::shared_ptr<Afina::Storage>(std::size_t)> make_storage;
+        std::size_t storage_size = 1024;
         if (storage_type == "st_lru") {
-            storage = std::make_shared<Afina::Backend::SimpleLRU>();
+            make_storage = [](std::size_t size) { return std::make_shared<Afina::Backend::SimpleLRU>(size); };
         } else if (storage_type == "mt_lru") {
-            storage = std::make_shared<Afina::Backend::ThreadSafeSimplLRU>();
+            make_storage = [](std::size_t size) { return std::make_shared<Afina::Backend::ThreadSafeSimplLRU>(size); };
         } else if (storage_type == "mt_slru")
         {
-            storage = Afina::Backend::StripedLRU::BuildStripedLRU(1024*1024*1024, 4);
+            storage_size = 1024 * 1024 * 1024;
+            make_storage = [](std::size_t size) {
+                return std::shared_ptr<Afina::Storage>(Afina::Backend::StripedLRU::BuildStripedLRU(size, 4));
+            };
+        } else if (storage_type == "mt_fclru") {
+            make_storage = [](std::size_t size) { return std::make_shared<Afina::Backend::FlatCombineLRU>(size); };
         } else {
             throw std::runtime_error("Unknown storage type");
         }
@@ -70,19 +84,71 @@ public:
             network_type = options["network"].as<std::string>();
         }
 
+        // Shards split the storage size between them, there is no storage shared by the whole server then
+        if (network_type != "mt_shard") {
+            storage = make_storage(storage_size);
+        }
+
+        // Redis clients are served by the second instance of the same network on top of the same storage
+        std::function<std::shared_ptr<Network::Server>()> make_server;
         if (network_type == "st_block") {
-            server = std::make_shared<Afina::Network::STblocking::ServerImpl>(storage, logService);
+            make_server = [this] {
+                return std::make_shared<Afina::Network::STblocking::ServerImpl>(storage, logService);
+            };
         } else if (network_type == "mt_block") {
-            server = std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService);
+            make_server = [this] {
+                return std::make_shared<Afina::Network::MTblocking::ServerImpl>(storage, logService);
+            };
         } else if (network_type == "st_nonblock") {
-            server = std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
+            make_server = [this] {
+                return std::make_shared<Afina::Network::STnonblock::ServerImpl>(storage, logService);
+            };
         } else if (network_type == "mt_nonblock") {
-            server = std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            make_server = [this] {
+                return std::make_shared<Afina::Network::MTnonblock::ServerImpl>(storage, logService);
+            };
         } else if (network_type == "st_coroutine") {
-            server = std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
+            make_server = [this] {
+                return std::make_shared<Afina::Network::STcoroutine::ServerImpl>(storage, logService);
+            };
+        } else if (network_type == "st_stackless") {
+            make_server = [this] {
+                return std::make_shared<Afina::Network::STstackless::ServerImpl>(storage, logService);
+            };
+        } else if (network_type == "mt_coroutine") {
+            // Scheduler thread per core unless said otherwise
+            make_server = [this] {
+                return std::make_shared<Afina::Network::MTcoroutine::ServerImpl>(storage, logService);
+            };
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        } else if (network_type == "mt_shard") {
+            // Shard per core unless said otherwise
+            make_server = [this, make_storage, storage_size] {
+                return std::make_shared<Afina::Network::MTshard::ServerImpl>(storage, logService, make_storage,
+                                                                             storage_size);
+            };
+            workers = std::max(1u, std::thread::hardware_concurrency());
         } else {
             throw std::runtime_error("Unknown network type");
         }
+        server = make_server();
+
+        if (options.count("resp") > 0) {
+            // Shards are private to the server owning them, the second one would see none of the data
+            if (network_type == "mt_shard") {
+                throw std::runtime_error("Redis protocol port isn't supported by mt_shard network");
+            }
+            if (storage_type == "st_lru") {
+                throw std::runtime_error("Redis protocol port needs thread safe storage");
+            }
+            resp_port = options["resp"].as<uint16_t>();
+            resp_server = make_server();
+            resp_server->SetProtocol(Protocol::Type::Resp);
+        }
+
+        if (options.count("workers") > 0) {
+            workers = options["workers"].as<uint32_t>();
+        }
     }
 
     // Start services in correct order
@@ -91,13 +157,20 @@ public:
         auto log = logService->select("root");
         log->warn("Start afina server {}", Afina::get_version());
 
-        log->warn("Start storage");
-        storage->Start();
+        if (storage) {
+            log->warn("Start storage");
+            storage->Start();
+        }
 
         // TODO: configure network service
         const uint16_t port = 8080;
         log->warn("Start network on {}", port);
-        server->Start(port, 2, 2);
+        server->Start(port, 2, workers);
+
+        if (resp_server) {
+            log->warn("Start Redis protocol network on {}", resp_port);
+            resp_server->Start(resp_port, 2, workers);
+        }
     }
 
     // Stop services in correct order
@@ -105,9 +178,15 @@ public:
         auto log = logService->select("root");
         log->warn("Stop application");
         server->Stop();
+        if (resp_server) {
+            resp_server->Stop();
+            resp_server->Join();
+        }
         server->Join();
 
-        storage->Stop();
+        if (storage) {
+            storage->Stop();
+        }
         logService->Stop();
     }
 
@@ -117,6 +196,13 @@ private:
 
     std::shared_ptr<Afina::Storage> storage;
     std::shared_ptr<Network::Server> server;
+
+    // Optional server speaking Redis protocol
+    std::shared_ptr<Network::Server> resp_server;
+    uint16_t resp_port = 0;
+
+    // Number of network workers
+    uint32_t workers = 2;
 };
 
 // Signal set that to notify application about time to stop
@@ -137,6 +223,8 @@ int main(int argc, char **argv) {
         // and simplify validation below
         options.add_options()("s,storage", "Type of storage service to use", cxxopts::value<std::string>());
         options.add_options()("n,network", "Type of network service to use", cxxopts::value<std::string>());
+        options.add_options()("w,workers", "Number of network workers", cxxopts::value<uint32_t>());
+        options.add_options()("r,resp", "Port to serve Redis protocol clients on", cxxopts::value<uint16_t>());
         options.add_options()("h,help", "Print usage info");
         options.parse(argc, argv);
 
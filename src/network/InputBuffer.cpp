@@ -0,0 +1,170 @@
+#include "InputBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+
+// See InputBuffer.h
+InputBuffer::InputBuffer(std::size_t block_size)
+    : _block_size(block_size), _head(nullptr), _tail(nullptr), _spare(nullptr), _available(0) {}
+
+// See InputBuffer.h
+InputBuffer::~InputBuffer() {
+    Clear();
+    if (_spare != nullptr) {
+        delete[] _spare->data;
+        delete _spare;
+    }
+}
+
+// See InputBuffer.h
+ssize_t InputBuffer::ReadFrom(int fd) {
+    if (_tail == nullptr || _tail->end == _block_size) {
+        Block *block = Allocate();
+        if (_tail == nullptr) {
+            _head = _tail = block;
+        } else {
+            _tail->next = block;
+            _tail = block;
+        }
+    }
+
+    // Whatever doesn't fit into the tail spills over to the next block, so that single call
+    // could get at least one full block of data
+    Block *next = Allocate();
+
+    struct iovec iov[2];
+    iov[0].iov_base = _tail->data + _tail->end;
+    iov[0].iov_len = _block_size - _tail->end;
+    iov[1].iov_base = next->data;
+    iov[1].iov_len = _block_size;
+
+    ssize_t readed = readv(fd, iov, 2);
+    if (readed <= 0) {
+        Release(next);
+        return readed;
+    }
+
+    _available += readed;
+    std::size_t to_tail = std::min(std::size_t(readed), iov[0].iov_len);
+    _tail->end += to_tail;
+    if (std::size_t(readed) > to_tail) {
+        next->end = readed - to_tail;
+        _tail->next = next;
+        _tail = next;
+    } else {
+        Release(next);
+    }
+    return readed;
+}
+
+// See InputBuffer.h
+const char *InputBuffer::Data() const { return _head == nullptr ? nullptr : _head->data + _head->begin; }
+
+// See InputBuffer.h
+std::size_t InputBuffer::Size() const { return _head == nullptr ? 0 : _head->end - _head->begin; }
+
+// See InputBuffer.h
+void InputBuffer::Consume(std::size_t size) {
+    size = std::min(size, _available);
+    _available -= size;
+
+    while (size > 0) {
+        std::size_t in_head = _head->end - _head->begin;
+        if (size < in_head) {
+            _head->begin += size;
+            break;
+        }
+
+        size -= in_head;
+        if (_head == _tail) {
+            // The only block drained, next read starts from its beginning
+            _head->begin = _head->end = 0;
+            break;
+        }
+
+        Block *drained = _head;
+        _head = _head->next;
+        Release(drained);
+    }
+}
+
+// See InputBuffer.h
+std::size_t InputBuffer::CopyOut(char *dst, std::size_t size) {
+    std::size_t copied = 0;
+    while (copied < size && !Empty()) {
+        std::size_t piece = std::min(size - copied, Size());
+        std::memcpy(dst + copied, Data(), piece);
+        Consume(piece);
+        copied += piece;
+    }
+    return copied;
+}
+
+// See InputBuffer.h
+std::size_t InputBuffer::AppendTo(std::string &dst, std::size_t size) {
+    std::size_t copied = 0;
+    while (copied < size && !Empty()) {
+        std::size_t piece = std::min(size - copied, Size());
+        dst.append(Data(), piece);
+        Consume(piece);
+        copied += piece;
+    }
+    return copied;
+}
+
+// See InputBuffer.h
+void InputBuffer::Clear() {
+    while (_head != nullptr) {
+        Block *next = _head->next;
+        if (_spare == nullptr) {
+            Release(_head);
+        } else {
+            delete[] _head->data;
+            delete _head;
+        }
+        _head = next;
+    }
+    _tail = nullptr;
+    _available = 0;
+}
+
+// See InputBuffer.h
+InputBuffer::Block *InputBuffer::Allocate() {
+    Block *result = _spare;
+    if (result != nullptr) {
+        _spare = nullptr;
+    } else {
+        result = new Block;
+        result->data = new char[_block_size];
+    }
+
+    result->begin = result->end = 0;
+    result->next = nullptr;
+    return result;
+}
+
+// See InputBuffer.h
+void InputBuffer::Release(Block *block) {
+    if (_spare == nullptr) {
+        _spare = block;
+    } else {
+        delete[] block->data;
+        delete block;
+    }
+}
+
+// See InputBuffer.h
+std::size_t ExtendForRead(std::string &dst, std::size_t size) {
+    std::size_t offset = dst.size();
+    std::size_t room = std::max(dst.capacity() - offset, std::max(offset, std::size_t(4096)));
+    dst.resize(offset + std::min(size, room));
+    return dst.size() - offset;
+}
+
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,111 @@
+#ifndef AFINA_NETWORK_INPUT_BUFFER_H
+#define AFINA_NETWORK_INPUT_BUFFER_H
+
+#include <cstddef>
+#include <string>
+
+#include <sys/types.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Bytes received from the client but not processed yet
+ * Data lives in a chain of fixed size blocks, each one has a cursor pointing to the first byte not
+ * consumed yet. Consuming only moves cursor, so nothing is moved in memory no matter how many commands
+ * are parsed out of a single read. Once block is consumed completely it gets reused.
+ *
+ * Parser works on a stream, so it is fine for the command to be split between blocks: caller gets
+ * data piece by piece through Data()/Size() and consumes what parser accepted.
+ */
+class InputBuffer {
+public:
+    explicit InputBuffer(std::size_t block_size = 4096);
+    ~InputBuffer();
+
+    InputBuffer(const InputBuffer &) = delete;
+    InputBuffer &operator=(const InputBuffer &) = delete;
+
+    /**
+     * Read from the given descriptor into buffer tail, chaining new block if tail is full. Returns
+     * result of underlying read call, so errno is meaningful in case of -1
+     */
+    ssize_t ReadFrom(int fd);
+
+    /**
+     * First contiguous piece of data not consumed yet
+     */
+    const char *Data() const;
+    std::size_t Size() const;
+
+    /**
+     * Total number of bytes not consumed yet
+     */
+    inline std::size_t Available() const { return _available; }
+    inline bool Empty() const { return _available == 0; }
+
+    /**
+     * Mark given number of bytes as processed
+     */
+    void Consume(std::size_t size);
+
+    /**
+     * Copy up to given number of bytes to the destination and consume them. Returns number of bytes copied
+     */
+    std::size_t CopyOut(char *dst, std::size_t size);
+
+    /**
+     * Same as above, but bytes are appended to the string, which grows only by the number of bytes copied
+     */
+    std::size_t AppendTo(std::string &dst, std::size_t size);
+
+    /**
+     * Drop everything
+     */
+    void Clear();
+
+private:
+    struct Block {
+        char *data;
+
+        // Bytes [begin, end) are not consumed yet
+        std::size_t begin;
+        std::size_t end;
+
+        Block *next;
+    };
+
+    // Takes block from the spare list or allocates new one
+    Block *Allocate();
+
+    // Returns block to the spare list
+    void Release(Block *block);
+
+    const std::size_t _block_size;
+
+    // Chain of blocks with data, tail is the one reads go to
+    Block *_head;
+    Block *_tail;
+
+    // Single block kept ready for the next read to spill over
+    Block *_spare;
+
+    // Bytes not consumed in all blocks
+    std::size_t _available;
+};
+
+// Memory reserved for the value up front, no matter how large one the client claims
+constexpr std::size_t kMaxArgumentReserve = 64 * 1024;
+
+/**
+ * Extend the string by room for a direct read of at most given number of bytes, bypassing the buffer. Room is
+ * what is left of the capacity, but no less than the current size, so the string grows geometrically as data
+ * arrives rather than all at once by the size client claims. Returns size of the room, it starts at the old end of
+ * the string. Caller shrinks string back by what the read didn't fill
+ */
+std::size_t ExtendForRead(std::string &dst, std::size_t size);
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_INPUT_BUFFER_H
@@ -0,0 +1,120 @@
+#include "OutputQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Afina {
+namespace Network {
+
+// Ring capacity the queue starts with, must be power of two
+static constexpr std::size_t kInitialChunks = 8;
+
+// How many drained chunks could be kept for reuse, rest are released
+static constexpr std::size_t kSpareChunks = 4;
+
+// See OutputQueue.h
+OutputQueue::OutputQueue(std::size_t high_watermark, std::size_t low_watermark, std::size_t chunk_size)
+    : _high_watermark(high_watermark), _low_watermark(std::min(low_watermark, high_watermark)),
+      _chunk_size(chunk_size), _ring(kInitialChunks, Chunk{nullptr, 0, 0}), _head(0), _count(0), _allocated(0),
+      _size(0) {}
+
+// See OutputQueue.h
+OutputQueue::~OutputQueue() {
+    for (auto &chunk : _ring) {
+        delete[] chunk.data;
+    }
+}
+
+// See OutputQueue.h
+void OutputQueue::Append(const char *data, std::size_t size) {
+    _size += size;
+    while (size > 0) {
+        Chunk &tail = Tail();
+        std::size_t to_copy = std::min(size, _chunk_size - tail.end);
+        std::memcpy(tail.data + tail.end, data, to_copy);
+        tail.end += to_copy;
+        data += to_copy;
+        size -= to_copy;
+    }
+}
+
+// See OutputQueue.h
+std::size_t OutputQueue::Prepare(struct iovec *iov, std::size_t iovcnt) const {
+    std::size_t mask = _ring.size() - 1;
+    std::size_t filled = 0;
+    for (; filled < _count && filled < iovcnt; filled++) {
+        const Chunk &chunk = _ring[(_head + filled) & mask];
+        iov[filled].iov_base = chunk.data + chunk.begin;
+        iov[filled].iov_len = chunk.end - chunk.begin;
+    }
+    return filled;
+}
+
+// See OutputQueue.h
+void OutputQueue::Consume(std::size_t size) {
+    std::size_t mask = _ring.size() - 1;
+    size = std::min(size, _size);
+    _size -= size;
+
+    while (size > 0) {
+        Chunk &head = _ring[_head];
+        std::size_t available = head.end - head.begin;
+        if (size < available) {
+            head.begin += size;
+            break;
+        }
+
+        // Whole chunk sent, it becomes spare
+        size -= available;
+        head.begin = head.end = 0;
+        if (_allocated > _count + kSpareChunks) {
+            delete[] head.data;
+            head.data = nullptr;
+            _allocated--;
+        }
+        _head = (_head + 1) & mask;
+        _count--;
+    }
+}
+
+// See OutputQueue.h
+void OutputQueue::Clear() { Consume(_size); }
+
+// See OutputQueue.h
+OutputQueue::Chunk &OutputQueue::Tail() {
+    std::size_t mask = _ring.size() - 1;
+    if (_count > 0) {
+        Chunk &tail = _ring[(_head + _count - 1) & mask];
+        if (tail.end < _chunk_size) {
+            return tail;
+        }
+    }
+
+    if (_count == _ring.size()) {
+        Grow();
+        mask = _ring.size() - 1;
+    }
+
+    Chunk &tail = _ring[(_head + _count) & mask];
+    if (tail.data == nullptr) {
+        tail.data = new char[_chunk_size];
+        _allocated++;
+    }
+    tail.begin = tail.end = 0;
+    _count++;
+    return tail;
+}
+
+// See OutputQueue.h
+void OutputQueue::Grow() {
+    // Ring is full so every slot is active: just unroll it starting from head
+    std::vector<Chunk> ring(_ring.size() * 2, Chunk{nullptr, 0, 0});
+    for (std::size_t i = 0; i < _count; i++) {
+        ring[i] = _ring[(_head + i) & (_ring.size() - 1)];
+    }
+    _ring.swap(ring);
+    _head = 0;
+}
+
+} // namespace Network
+} // namespace Afina
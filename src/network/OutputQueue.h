@@ -0,0 +1,101 @@
+#ifndef AFINA_NETWORK_OUTPUT_QUEUE_H
+#define AFINA_NETWORK_OUTPUT_QUEUE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Network {
+
+/**
+ * # Bytes waiting to be sent to the client
+ * Responses are copied into fixed size chunks organized as a ring, so appending never moves data
+ * queued already and written bytes are dropped from the head in O(1). Drained chunks are kept in
+ * the ring to be reused by subsequent appends.
+ *
+ * Queue tracks its size in bytes against two watermarks: once size goes above the high one connection
+ * should stop reading new commands, and resume when size drops to the low one.
+ */
+class OutputQueue {
+public:
+    OutputQueue(std::size_t high_watermark = 1024 * 1024, std::size_t low_watermark = 256 * 1024,
+                std::size_t chunk_size = 16 * 1024);
+    ~OutputQueue();
+
+    OutputQueue(const OutputQueue &) = delete;
+    OutputQueue &operator=(const OutputQueue &) = delete;
+
+    /**
+     * Copy data to the end of queue
+     */
+    void Append(const char *data, std::size_t size);
+    void Append(const std::string &data) { Append(data.data(), data.size()); }
+
+    /**
+     * Fill given array with pieces of queued data in order, first entry starts at the first byte
+     * not sent yet. Returns number of entries filled
+     */
+    std::size_t Prepare(struct iovec *iov, std::size_t iovcnt) const;
+
+    /**
+     * Drop given number of bytes from the queue head, normally that is what writev returned
+     */
+    void Consume(std::size_t size);
+
+    /**
+     * Drop everything
+     */
+    void Clear();
+
+    inline std::size_t Size() const { return _size; }
+    inline bool Empty() const { return _size == 0; }
+
+    /**
+     * True if there is too much data queued, so producer should pause
+     */
+    inline bool Overflown() const { return _size > _high_watermark; }
+
+    /**
+     * True if queue drained enough to let producer continue
+     */
+    inline bool Drained() const { return _size <= _low_watermark; }
+
+private:
+    struct Chunk {
+        char *data;
+
+        // Bytes [begin, end) are waiting to be sent
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // Make sure there is a writable chunk at the tail
+    Chunk &Tail();
+
+    // Double ring capacity, keeps chunks order
+    void Grow();
+
+    const std::size_t _high_watermark;
+    const std::size_t _low_watermark;
+    const std::size_t _chunk_size;
+
+    // Ring of chunks, active ones are [_head, _head + _count) modulo ring size, others are spare and
+    // might carry allocated buffer for reuse
+    std::vector<Chunk> _ring;
+    std::size_t _head;
+    std::size_t _count;
+
+    // Number of chunk buffers allocated, both active and spare
+    std::size_t _allocated;
+
+    // Bytes queued
+    std::size_t _size;
+};
+
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_OUTPUT_QUEUE_H
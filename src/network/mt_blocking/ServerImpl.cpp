@@ -1,4 +1,5 @@
 #include "ServerImpl.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -24,6 +25,7 @@
 #include <afina/logging/Service.h>
 
 
+#include "network/InputBuffer.h"
 #include "protocol/Parser.h"
 
 
@@ -31,6 +33,12 @@ namespace Afina {
 namespace Network {
 namespace MTblocking {
 
+// Argument at least that large is read from socket directly into the argument buffer
+static constexpr std::size_t kDirectReadThreshold = 4096;
+
+// Pool thread waiting for connection that long leaves the pool, unless pool is at its low watermark
+static constexpr std::chrono::milliseconds kWorkerIdleTime(10000);
+
 // See Server.h
 ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
 
@@ -92,6 +100,10 @@ void ServerImpl::Start(uint16_t port, uint32_t n_accept, uint32_t n_workers)
         throw std::runtime_error("Socket listen() failed");
     }
 
+    // Keep a single thread ready for the next connection, grow up to n_workers on demand. Connections accepted
+    // while every thread is busy wait in the queue, which is as long as the pool is large
+    _executor.reset(new Afina::Concurrency::Executor("mt_block", 1, n_workers, n_workers, kWorkerIdleTime));
+
     running.store(true);
     _thread = std::thread(&ServerImpl::OnRun, this);
 }
@@ -115,11 +127,14 @@ void ServerImpl::Join()
     assert(_thread.joinable());
     _thread.join();
     
-    std::unique_lock<std::mutex> _lock(_mutex);
-    while (!_sockets.empty()) {
-        _cv.wait(_lock);
+    {
+        std::unique_lock<std::mutex> _lock(_mutex);
+        while (!_sockets.empty()) {
+            _cv.wait(_lock);
+        }
     }
-      
+
+    _executor->Stop(true);
 }
 
 
@@ -133,99 +148,124 @@ void ServerImpl::MyWorker(int client_socket)
 
 
     std::size_t arg_remains = 0;
-    Protocol::Parser parser;
+    Protocol::Parser parser(protocol);
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
 
+    // Bytes received but not parsed yet, consumed in place without moving the tail around
+    InputBuffer input;
+
     try
     {
-    	int ReadBytesAtAll = 0;
-    	int ReadBytesNow = -1;
-        char client_buffer[4096] = "";
-        while ((ReadBytesNow = read(client_socket, client_buffer + ReadBytesAtAll, sizeof(client_buffer) - ReadBytesAtAll)) > 0)
+        for (;;)
         {
-            ReadBytesAtAll += ReadBytesNow;
+            ssize_t ReadBytesNow = -1;
+            if (command_to_execute && arg_remains >= kDirectReadThreshold)
+            {
+                // Large value: the buffered part is in the argument already, read the rest right to its end. Argument
+                // grows as data arrives rather than at once by the size client claims
+                std::size_t offset = argument_for_command.size();
+                std::size_t room = ExtendForRead(argument_for_command, arg_remains);
+                ReadBytesNow = read(client_socket, &argument_for_command[offset], room);
+                argument_for_command.resize(offset + std::max(ReadBytesNow, ssize_t(0)));
+                if (ReadBytesNow > 0)
+                {
+                    arg_remains -= ReadBytesNow;
+                }
+            }
+            else
+            {
+                ReadBytesNow = input.ReadFrom(client_socket);
+            }
+
+            if (ReadBytesNow == 0)
+            {
+                _logger->debug("Connection closed");
+                break;
+            }
+            else if (ReadBytesNow < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
             _logger->debug("Got {} bytes from socket", ReadBytesNow);
-            
-            while (ReadBytesAtAll > 0)
+
+            for (;;)
             {
-                _logger->debug("Process {} bytes", ReadBytesNow);
                 // There is no command yet
                 if (!command_to_execute)
                 {
+                    if (input.Empty())
+                    {
+                        break;
+                    }
+
                     std::size_t parsed = 0;
-                    if (parser.Parse(client_buffer,ReadBytesAtAll, parsed))
+                    if (parser.Parse(input.Data(), input.Size(), parsed))
                     {
                         _logger->debug("Found new command: {} in {} bytes", parser.Name(), parsed);
                         command_to_execute = parser.Build(arg_remains);
                         if (arg_remains > 0)
                         {
                             arg_remains += 2;
+                            argument_for_command.reserve(std::min(arg_remains, kMaxArgumentReserve));
                         }
                     }
+                    input.Consume(parsed);
 
-                    if (parsed == 0)
+                    if (!command_to_execute)
                     {
-                        break;
+                        continue;
                     }
-                    else
+                }
+
+                if (arg_remains > 0)
+                {
+                    _logger->debug("Fill argument: {} bytes of {}", input.Available(), arg_remains);
+                    arg_remains -= input.AppendTo(argument_for_command, arg_remains);
+                    if (arg_remains > 0)
                     {
-                        std::memmove(client_buffer, client_buffer + parsed, ReadBytesAtAll - parsed);
-                        ReadBytesAtAll -= parsed;
+                        break;
                     }
                 }
 
-                if (command_to_execute && arg_remains > 0)
-                {
-                    _logger->debug("Fill argument: {} bytes of {}", ReadBytesAtAll, arg_remains);
-                    std::size_t to_read = std::min(arg_remains, std::size_t(ReadBytesAtAll));
-                    argument_for_command.append(client_buffer, to_read);
+                _logger->debug("Start command execution");
 
-                    std::memmove(client_buffer, client_buffer + to_read, ReadBytesAtAll - to_read);
-                    arg_remains -= to_read;
-                    ReadBytesAtAll -= to_read;
+                std::string result;
+                if (argument_for_command.size())
+                {
+                    argument_for_command.resize(argument_for_command.size() - 2);
                 }
 
-                if (command_to_execute && arg_remains == 0)
+                // Send response, quiet commands could have none. Large one comes in parts, each is sent before
+                // the next is fetched
+                do
                 {
-                    _logger->debug("Start command execution");
-
-                    std::string result;
-                    if (argument_for_command.size())
-                    {
-                        argument_for_command.resize(argument_for_command.size() - 2);
-                    }
+                    result.clear();
                     command_to_execute->Execute(*pStorage, argument_for_command, result);
-
-                    // Send response
-                    result += "\r\n";
-                    if (send(client_socket, result.data(), result.size(), 0) <= 0)
+                    if (!result.empty() && send(client_socket, result.data(), result.size(), 0) <= 0)
                     {
                         throw std::runtime_error("Failed to send response");
                     }
+                } while (command_to_execute->HasMore());
 
-                    // Prepare for the next command
-                    command_to_execute.reset();
-                    argument_for_command.resize(0);
-                    parser.Reset();
-                }
-                
+                // Prepare for the next command
+                command_to_execute.reset();
+                argument_for_command.resize(0);
+                parser.Reset();
             }
-            
-        }
-
-        if (ReadBytesAtAll == 0)
-        {
-            _logger->debug("Connection closed");
-        }
-         else 
-         {
-            throw std::runtime_error(std::string(strerror(errno)));
         }
     }
-    catch (std::runtime_error &ex)
+    catch (std::exception &ex)
     {
         _logger->error("Failed to process connection on descriptor {}: {}", client_socket, ex.what());
+
+        // Tell client why, if socket still works, and close
+        const std::string &error = parser.Error();
+        send(client_socket, error.data(), error.size(), MSG_NOSIGNAL);
     }
 
     std::lock_guard<std::mutex> _lock(_mutex);
@@ -281,9 +321,8 @@ void ServerImpl::OnRun()
         
         {
             std::lock_guard<std::mutex> _lock(_mutex);
-            if (_sockets.size() < NumWorkers && running.load())
+            if (running.load() && _executor->Execute(&ServerImpl::MyWorker, this, client_socket))
             {
-                std::thread(&ServerImpl::MyWorker, this, client_socket).detach();
                 _sockets.insert(client_socket);
             }
              else 
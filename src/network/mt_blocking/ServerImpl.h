@@ -6,6 +6,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <set>
+#include <afina/concurrency/Executor.h>
 #include <afina/network/Server.h>
 
 namespace spdlog {
@@ -18,7 +19,7 @@ namespace MTblocking {
 
 /**
  * # Network resource manager implementation
- * Server that is spawning a separate thread for each connection
+ * Server that is serving each connection in a separate thread taken from the pool
  */
 class ServerImpl : public Server {
 public:
@@ -59,7 +60,10 @@ private:
     std::condition_variable _cv;
     
     std::set <int> _sockets;
-    
+
+    // Pool connections are served on, once all threads are busy and queue is full new connections are refused
+    std::unique_ptr<Afina::Concurrency::Executor> _executor;
+
     int NumWorkers;
     void MyWorker(int client_socket);
     
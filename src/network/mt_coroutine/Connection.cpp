@@ -0,0 +1,163 @@
+#include "Connection.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+// See Connection.h
+void Connection::Serve() {
+    _logger->debug("Start {} socket", _socket);
+
+    Afina::Coroutine::Scheduler::Handle *handle = nullptr;
+    try {
+        handle = _scheduler.Register(_socket);
+        for (;;) {
+            ssize_t read_bytes;
+            if (_command_to_execute && _arg_remains >= kDirectReadThreshold) {
+                // Large value: the buffered part is in the argument already, read the rest right to its end. Argument
+                // grows as data arrives rather than at once by the size client claims
+                std::size_t offset = _argument_for_command.size();
+                std::size_t room = ExtendForRead(_argument_for_command, _arg_remains);
+                read_bytes = _scheduler.Read(handle, &_argument_for_command[offset], room);
+                _argument_for_command.resize(offset + std::max(read_bytes, ssize_t(0)));
+                if (read_bytes > 0) {
+                    _arg_remains -= read_bytes;
+                }
+            } else if ((read_bytes = _input.ReadFrom(_socket)) < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                _scheduler.Wait(handle, EPOLLIN);
+                continue;
+            }
+
+            if (read_bytes == 0) {
+                _logger->debug("Connection closed");
+                break;
+            } else if (read_bytes < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+
+            _logger->debug("Got {} bytes from socket", read_bytes);
+            ProcessInput();
+            Flush(handle);
+
+            // Output is flushed, so fetch the rest of the streamed response, if any
+            while (_command_to_execute && _command_to_execute->HasMore()) {
+                ProcessInput();
+                Flush(handle);
+            }
+        }
+    } catch (std::exception &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+
+        // Parser is broken or socket failed, try to tell client and close
+        if (handle != nullptr) {
+            _output.Append(_parser.Error());
+            try {
+                Flush(handle);
+            } catch (std::exception &) {
+            }
+        }
+    }
+
+    if (handle != nullptr) {
+        _scheduler.Unregister(handle);
+    }
+    close(_socket);
+    _logger->debug("Close {} socket", _socket);
+}
+
+// See Connection.h
+void Connection::Shutdown() { shutdown(_socket, SHUT_RD); }
+
+// See Connection.h
+void Connection::ProcessInput() {
+    for (;;) {
+        if (!_command_to_execute) {
+            if (_input.Empty()) {
+                break;
+            }
+
+            std::size_t parsed = 0;
+            if (_parser.Parse(_input.Data(), _input.Size(), parsed)) {
+                _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                _command_to_execute = _parser.Build(_arg_remains);
+                if (_arg_remains > 0) {
+                    _arg_remains += 2;
+                    _argument_for_command.reserve(std::min(_arg_remains, kMaxArgumentReserve));
+                }
+            }
+            _input.Consume(parsed);
+
+            if (!_command_to_execute) {
+                continue;
+            }
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (_arg_remains > 0) {
+            _logger->debug("Fill argument: {} bytes of {}", _input.Available(), _arg_remains);
+            _arg_remains -= _input.AppendTo(_argument_for_command, _arg_remains);
+            if (_arg_remains > 0) {
+                break;
+            }
+        }
+
+        // There is command & argument, or response started before goes on
+        _logger->debug("Start command execution");
+
+        if (!_command_to_execute->HasMore() && _argument_for_command.size()) {
+            _argument_for_command.resize(_argument_for_command.size() - 2);
+        }
+
+        // Large response comes in parts, the next one is fetched only once previous ones are sent
+        do {
+            std::string result;
+            _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
+            if (!result.empty()) {
+                _output.Append(result);
+            }
+        } while (_command_to_execute->HasMore() && !_output.Overflown());
+
+        if (_command_to_execute->HasMore()) {
+            break;
+        }
+
+        // Prepare for the next command
+        _command_to_execute.reset();
+        _argument_for_command.resize(0);
+        _parser.Reset();
+    }
+}
+
+// See Connection.h
+void Connection::Flush(Afina::Coroutine::Scheduler::Handle *handle) {
+    std::array<struct iovec, 64> data;
+    while (!_output.Empty()) {
+        std::size_t count = _output.Prepare(data.data(), data.size());
+        ssize_t written_bytes = _scheduler.Writev(handle, data.data(), count);
+        if (written_bytes < 0) {
+            throw std::runtime_error(std::string(strerror(errno)));
+        }
+        _output.Consume(written_bytes);
+    }
+}
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,82 @@
+#ifndef AFINA_NETWORK_MT_COROUTINE_CONNECTION_H
+#define AFINA_NETWORK_MT_COROUTINE_CONNECTION_H
+
+#include <memory>
+#include <string>
+
+#include <afina/coroutine/Scheduler.h>
+#include <afina/execute/Command.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
+#include <protocol/Parser.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace MTcoroutine {
+
+/**
+ * # Client connection served by a coroutine
+ * Same as STcoroutine::Connection, but coroutine runs on the scheduler pool: every EAGAIN lets the thread
+ * serve other coroutines and connection could continue on another thread after that.
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               Afina::Coroutine::Scheduler &scheduler)
+        : _socket(s), _pStorage(ps), _logger(pl), _scheduler(scheduler), _parser(protocol) {}
+
+    /**
+     * Body of the connection coroutine, returns once client has gone or connection failed. Socket is closed
+     * on return
+     */
+    void Serve();
+
+    /**
+     * Stop to read new commands, responses to commands read already are still sent. Could be called from any
+     * thread
+     */
+    void Shutdown();
+
+protected:
+    // Execute all commands that are in the input buffer completely
+    void ProcessInput();
+
+    // Write all responses, blocks coroutine until they are sent
+    void Flush(Afina::Coroutine::Scheduler::Handle *handle);
+
+private:
+    // Argument of that many bytes and more is read straight from the socket, bypassing input buffer
+    static constexpr std::size_t kDirectReadThreshold = 4096;
+
+    int _socket;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+    Afina::Coroutine::Scheduler &_scheduler;
+
+    // Bytes received, but not parsed yet
+    InputBuffer _input;
+
+    // Command being read, last _arg_remains bytes of its argument haven't arrived yet
+    std::size_t _arg_remains = 0;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Responses not sent yet
+    OutputQueue _output;
+};
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_COROUTINE_CONNECTION_H
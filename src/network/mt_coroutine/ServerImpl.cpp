@@ -0,0 +1,165 @@
+#include "ServerImpl.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/coroutine/Scheduler.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace MTcoroutine {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start mt_coroutine network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Create server socket
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, 128) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _scheduler.reset(new Afina::Coroutine::Scheduler("afina.network", n_workers));
+    if (_scheduler->Spawn(&ServerImpl::OnAccept, *this) == nullptr) {
+        throw std::runtime_error("Failed to start acceptor coroutine");
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Acceptor gets an error once socket is shut down, connections get EOF and leave once responses are sent.
+    // Shutdown is safe to call from any thread, coroutines notice it through their reactors
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopping = true;
+        shutdown(_server_socket, SHUT_RDWR);
+        for (auto pc : _connections) {
+            pc->Shutdown();
+        }
+    }
+
+    // Threads exit once the last coroutine is done
+    _scheduler->Stop();
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    if (_scheduler) {
+        _scheduler->Join();
+        _scheduler.reset();
+        close(_server_socket);
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnAccept(ServerImpl &server) {
+    Afina::Coroutine::Scheduler &scheduler = *server._scheduler;
+    Afina::Coroutine::Scheduler::Handle *listener = scheduler.Register(server._server_socket);
+
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len = sizeof in_addr;
+        int infd = scheduler.Accept(listener, &in_addr, &in_len);
+        if (infd == -1) {
+            int error = errno;
+            std::unique_lock<std::mutex> lock(server._mutex);
+            if (server._stopping) {
+                break;
+            } else if (error == ECONNABORTED || error == EPROTO) {
+                continue;
+            }
+            server._logger->error("Failed to accept socket: {}", strerror(error));
+            break;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            server._logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        // Connection accepted right before stop isn't served: Stop has gone through the set already
+        Connection *pc = new Connection(infd, server.pStorage, server._logger, server.protocol, scheduler);
+        std::unique_lock<std::mutex> lock(server._mutex);
+        if (server._stopping || scheduler.Spawn(&ServerImpl::OnConnection, server, *pc) == nullptr) {
+            if (!server._stopping) {
+                server._logger->error("Failed to start coroutine for descriptor {}", infd);
+            }
+            close(infd);
+            delete pc;
+            continue;
+        }
+        server._connections.insert(pc);
+    }
+
+    scheduler.Unregister(listener);
+}
+
+// See ServerImpl.h
+void ServerImpl::OnConnection(ServerImpl &server, Connection &connection) {
+    connection.Serve();
+
+    std::unique_lock<std::mutex> lock(server._mutex);
+    server._connections.erase(&connection);
+    delete &connection;
+}
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
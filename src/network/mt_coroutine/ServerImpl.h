@@ -0,0 +1,80 @@
+#ifndef AFINA_NETWORK_MT_COROUTINE_SERVER_H
+#define AFINA_NETWORK_MT_COROUTINE_SERVER_H
+
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Coroutine {
+class Scheduler;
+}
+
+namespace Network {
+namespace MTcoroutine {
+
+// Forward declaration, see Connection.h
+class Connection;
+
+/**
+ * # Network resource manager implementation
+ * Coroutine per connection on top of M:N scheduler: acceptor coroutine spawns a coroutine for each accepted
+ * connection, idle scheduler threads steal them, so connections spread across all workers. Every connection
+ * descriptor is registered in the epoll of the thread its coroutine has started on.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    /**
+     * Coroutine accepting connections and spawning coroutine for each one until server is stopped
+     */
+    static void OnAccept(ServerImpl &server);
+
+    /**
+     * Coroutine serving a single connection
+     */
+    static void OnConnection(ServerImpl &server, Connection &connection);
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Threads running coroutines
+    std::unique_ptr<Afina::Coroutine::Scheduler> _scheduler;
+
+    // Guards connections set and stopping flag, connections come and go on different threads
+    std::mutex _mutex;
+
+    // Set once server is stopped, no connections are served after that
+    bool _stopping = false;
+
+    // Connections being served
+    std::set<Connection *> _connections;
+};
+
+} // namespace MTcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_COROUTINE_SERVER_H
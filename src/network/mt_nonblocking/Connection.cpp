@@ -1,25 +1,241 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <stdexcept>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
 
 namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
 // See Connection.h
-void Connection::Start() { std::cout << "Start" << std::endl; }
+void Connection::Start() {
+    _logger->debug("Start {} socket", _socket);
+
+    _is_alive = true;
+    _eof = false;
+    _input.Clear();
+    _arg_remains = 0;
+    _parser.Reset();
+    _argument_for_command.clear();
+    _command_to_execute.reset();
+    _output.Clear();
+
+    _event.data.ptr = this;
+    _event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR;
+}
 
 // See Connection.h
-void Connection::OnError() { std::cout << "OnError" << std::endl; }
+void Connection::OnError() {
+    _logger->debug("OnError {} socket", _socket);
+    _is_alive = false;
+}
 
 // See Connection.h
-void Connection::OnClose() { std::cout << "OnClose" << std::endl; }
+void Connection::OnClose() {
+    _logger->debug("OnClose {} socket", _socket);
+    _is_alive = false;
+}
 
 // See Connection.h
-void Connection::DoRead() { std::cout << "DoRead" << std::endl; }
+void Connection::DoRead() {
+    _logger->debug("DoRead {} socket", _socket);
+
+    try {
+        // Read until socket drained, but stop as soon as output is overflown: there is no point to read commands
+        // that would not be executed until client reads responses
+        while (_is_alive && !_eof && (_event.events & EPOLLIN)) {
+            ssize_t readed_bytes;
+            if (_command_to_execute && _arg_remains >= kDirectReadThreshold) {
+                // Large value: the buffered part is in the argument already, read the rest right to its end. Argument
+                // grows as data arrives rather than at once by the size client claims
+                std::size_t offset = _argument_for_command.size();
+                std::size_t room = ExtendForRead(_argument_for_command, _arg_remains);
+                readed_bytes = read(_socket, &_argument_for_command[offset], room);
+                _argument_for_command.resize(offset + std::max(readed_bytes, ssize_t(0)));
+                if (readed_bytes > 0) {
+                    _arg_remains -= readed_bytes;
+                }
+            } else {
+                readed_bytes = _input.ReadFrom(_socket);
+            }
+
+            if (readed_bytes > 0) {
+                _logger->debug("Got {} bytes from socket", readed_bytes);
+                _stat_bytes += readed_bytes;
+                ProcessInput();
+
+                // Socket is most likely writable, so send responses right away instead of waiting for EPOLLOUT
+                // from the next epoll_wait. DoWrite keeps EPOLLOUT armed for whatever doesn't fit
+                if (!_output.Empty()) {
+                    DoWrite();
+                }
+            } else if (readed_bytes == 0) {
+                _logger->debug("Connection closed by peer");
+                _eof = true;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            } else {
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+        }
+    } catch (std::exception &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+
+        // Parser state is broken, so report error and close connection once client gets the response
+        EnqueueResponse(_parser.Error().data(), _parser.Error().size());
+        _eof = true;
+    }
+
+    if (_eof) {
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        if (_output.Empty()) {
+            _is_alive = false;
+        }
+    }
+}
 
 // See Connection.h
-void Connection::DoWrite() { std::cout << "DoWrite" << std::endl; }
+void Connection::ProcessInput() {
+    for (;;) {
+        // There is no command yet
+        if (!_command_to_execute) {
+            if (_input.Empty()) {
+                break;
+            }
+
+            std::size_t parsed = 0;
+            if (_parser.Parse(_input.Data(), _input.Size(), parsed)) {
+                _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                _command_to_execute = _parser.Build(_arg_remains);
+                if (_arg_remains > 0) {
+                    _arg_remains += 2;
+                    _argument_for_command.reserve(std::min(_arg_remains, kMaxArgumentReserve));
+                }
+            }
+            _input.Consume(parsed);
+
+            if (!_command_to_execute) {
+                continue;
+            }
+        }
+
+        // There is command, but we still wait for argument to arrive...
+        if (_arg_remains > 0) {
+            _arg_remains -= _input.AppendTo(_argument_for_command, _arg_remains);
+            if (_arg_remains > 0) {
+                break;
+            }
+        }
+
+        // There is command & argument - RUN! Or go on with the response started before
+        _logger->debug("Start command execution");
+
+        if (!_command_to_execute->HasMore() && _argument_for_command.size()) {
+            _argument_for_command.resize(_argument_for_command.size() - 2);
+        }
+
+        // Large response comes in parts, the next one is fetched only once the socket has taken previous ones
+        do {
+            std::string result;
+            _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
+            EnqueueResponse(result.data(), result.size());
+        } while (_command_to_execute->HasMore() && !_output.Overflown());
+
+        if (_command_to_execute->HasMore()) {
+            // DoWrite continues once output is drained
+            break;
+        }
+
+        // Prepare for the next command
+        _command_to_execute.reset();
+        _argument_for_command.resize(0);
+        _parser.Reset();
+    }
+}
+
+// See Connection.h
+void Connection::Continue() {
+    try {
+        ProcessInput();
+    } catch (std::exception &ex) {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+
+        // Same as in DoRead: report error and close connection once client gets the response
+        EnqueueResponse(_parser.Error().data(), _parser.Error().size());
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        _eof = true;
+    }
+}
+
+// See Connection.h
+void Connection::EnqueueResponse(const char *data, std::size_t size) {
+    // Client asked for no reply, nothing to wake up for
+    if (size == 0) {
+        return;
+    }
+    _output.Append(data, size);
+
+    _event.events |= EPOLLOUT;
+    if (_output.Overflown()) {
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+    }
+}
+
+// See Connection.h
+void Connection::DoWrite() {
+    _logger->debug("DoWrite {} socket", _socket);
+
+    try {
+        std::array<struct iovec, 64> data;
+        while (!_output.Empty()) {
+            std::size_t count = _output.Prepare(data.data(), data.size());
+            ssize_t written_bytes = writev(_socket, data.data(), count);
+            if (written_bytes < 0) {
+                if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+
+            _output.Consume(written_bytes);
+            _stat_bytes += written_bytes;
+
+            if (_output.Drained() && Streaming()) {
+                Continue();
+            }
+        }
+    } catch (std::exception &ex) {
+        _logger->error("Failed to write connection on descriptor {}: {}", _socket, ex.what());
+        _is_alive = false;
+        return;
+    }
+
+    if (_output.Empty()) {
+        _event.events &= ~EPOLLOUT;
+        if (_eof) {
+            _is_alive = false;
+            return;
+        }
+    }
+
+    if (!_eof && _output.Drained() && !(_event.events & EPOLLIN) && !Streaming()) {
+        _event.events |= EPOLLIN | EPOLLRDHUP;
+    }
+}
 
 } // namespace MTnonblock
 } // namespace Network
@@ -1,22 +1,47 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 #define AFINA_NETWORK_MT_NONBLOCKING_CONNECTION_H
 
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <string>
 
 #include <sys/epoll.h>
 
+#include <afina/execute/Command.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
+#include <protocol/Parser.h>
+
+namespace spdlog {
+class logger;
+}
+
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
 namespace MTnonblock {
 
+/**
+ * # Client connection served by a pool of epoll workers
+ * At any moment connection is owned by exactly one worker and registered in its private epoll instance only,
+ * so there is no concurrent access. Ownership could be transferred to another worker through its inbox, which
+ * publishes connection state to the new owner.
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               std::size_t output_high_watermark = 1024 * 1024, std::size_t output_low_watermark = 256 * 1024)
+        : _socket(s), _pStorage(ps), _logger(pl), _parser(protocol),
+          _output(output_high_watermark, output_low_watermark) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
     }
 
-    inline bool isAlive() const { return true; }
+    inline bool isAlive() const { return _is_alive; }
 
     void Start();
 
@@ -30,8 +55,53 @@ private:
     friend class Worker;
     friend class ServerImpl;
 
+    // Execute all complete commands found in the input buffer
+    void ProcessInput();
+
+    // Fetch the next part of the response being streamed, then go on with commands buffered after it
+    void Continue();
+
+    // Response of the current command is sent in parts and isn't complete yet
+    bool Streaming() const { return _command_to_execute && _command_to_execute->HasMore(); }
+
+    // Queue response for the client and update event mask accordingly
+    void EnqueueResponse(const char *data, std::size_t size);
+
+    // Argument at least that large is read from socket directly into the argument buffer
+    static constexpr std::size_t kDirectReadThreshold = 4096;
+
     int _socket;
     struct epoll_event _event;
+
+    // Connection is alive until error happens or both directions are done
+    bool _is_alive = true;
+
+    // Peer has closed its writing end, so once output is flushed connection is done
+    bool _eof = false;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Traffic since last load sampling, used by worker to choose connection to be migrated
+    uint64_t _stat_events = 0;
+    uint64_t _stat_bytes = 0;
+
+    // Link in the inbox of the worker connection is handed over to
+    Connection *_inbox_next = nullptr;
+
+    // Unparsed bytes received from the client
+    InputBuffer _input;
+
+    // Parse state of the command stream. Argument buffer is allocated in full once command is parsed,
+    // the last _arg_remains bytes of it are still to be received
+    std::size_t _arg_remains = 0;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Responses to be sent to the client. Once there are more bytes than high watermark connection
+    // stops to read new commands until queue drains to low watermark
+    OutputQueue _output;
 };
 
 } // namespace MTnonblock
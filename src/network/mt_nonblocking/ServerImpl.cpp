@@ -76,28 +76,22 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
 
-    // Start IO workers
-    _data_epoll_fd = epoll_create1(0);
-    if (_data_epoll_fd == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
     _event_fd = eventfd(0, EFD_NONBLOCK);
     if (_event_fd == -1) {
         throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
     }
 
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.ptr = nullptr;
-    if (epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
-        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
-    }
-
+    // Start IO workers, each one has private epoll instance
     _workers.reserve(n_workers);
     for (int i = 0; i < n_workers; i++) {
         _workers.emplace_back(pStorage, pLogging);
-        _workers.back().Start(_data_epoll_fd);
+        _workers.back().Start();
+    }
+
+    // Start load balancer, no sense to run it with single worker
+    _balancing = true;
+    if (_workers.size() > 1) {
+        _balancer = std::thread(&ServerImpl::OnBalance, this);
     }
 
     // Start acceptors
@@ -110,26 +104,106 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
 // See Server.h
 void ServerImpl::Stop() {
     _logger->warn("Stop network service");
+    // No more migrations
+    {
+        std::lock_guard<std::mutex> lock(_balancer_mutex);
+        _balancing = false;
+    }
+    _balancer_cv.notify_all();
+
     // Said workers to stop
     for (auto &w : _workers) {
         w.Stop();
     }
 
-    // Wakeup threads that are sleep on epoll_wait
+    // Wakeup acceptors that are sleep on epoll_wait
     if (eventfd_write(_event_fd, 1)) {
-        throw std::runtime_error("Failed to wakeup workers");
+        throw std::runtime_error("Failed to wakeup acceptors");
     }
 }
 
 // See Server.h
 void ServerImpl::Join() {
+    if (_balancer.joinable()) {
+        _balancer.join();
+    }
+
     for (auto &t : _acceptors) {
         t.join();
     }
+    _acceptors.clear();
 
     for (auto &w : _workers) {
         w.Join();
     }
+
+    // All threads are gone, workers release connections that were handed over after that
+    _workers.clear();
+
+    close(_server_socket);
+    close(_event_fd);
+}
+
+// See ServerImpl.h
+Worker &ServerImpl::SelectWorker() {
+    // Balancer takes care about load, so here just keep number of connections even
+    Worker *result = &_workers[0];
+    for (auto &w : _workers) {
+        if (w.Connections() < result->Connections()) {
+            result = &w;
+        }
+    }
+    return *result;
+}
+
+// See ServerImpl.h
+void ServerImpl::OnBalance() {
+    _logger->info("Start balancer");
+
+    // Once heaviest worker load exceeds lightest one that much times, connection gets migrated...
+    const double kImbalance = 1.5;
+
+    // ...unless it is too small to care about: 100 small requests per second
+    const double kMinLoad = 100 * Worker::kEventWeight;
+
+    const auto kInterval = std::chrono::seconds(1);
+
+    std::vector<uint64_t> last_events(_workers.size()), last_bytes(_workers.size());
+    std::vector<double> load(_workers.size());
+    auto last_sample = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(_balancer_mutex);
+    while (!_balancer_cv.wait_for(lock, kInterval, [this] { return !_balancing; })) {
+        auto now = std::chrono::steady_clock::now();
+        double period = std::chrono::duration<double>(now - last_sample).count();
+        last_sample = now;
+
+        // Load is events per second weighted plus bytes per second
+        std::size_t heavy = 0, light = 0;
+        for (std::size_t i = 0; i < _workers.size(); i++) {
+            uint64_t events = _workers[i].Events(), bytes = _workers[i].Bytes();
+            load[i] = (Worker::kEventWeight * (events - last_events[i]) + (bytes - last_bytes[i])) / period;
+            last_events[i] = events;
+            last_bytes[i] = bytes;
+
+            if (load[i] > load[heavy]) {
+                heavy = i;
+            }
+            if (load[i] < load[light]) {
+                light = i;
+            }
+        }
+
+        if (load[heavy] < kMinLoad || load[heavy] < kImbalance * load[light] || _workers[heavy].Connections() < 2) {
+            continue;
+        }
+
+        // Ideally half of the difference moves to the light one
+        _logger->debug("Balance workers: {} load {}, {} load {}", heavy, load[heavy], light, load[light]);
+        _workers[heavy].RequestMigration(&_workers[light], (load[heavy] - load[light]) / 2);
+    }
+
+    _logger->warn("Balancer stopped");
 }
 
 // See ServerImpl.h
@@ -193,25 +267,23 @@ void ServerImpl::OnRun() {
                 }
 
                 // Register the new FD to be monitored by epoll.
-                Connection *pc = new Connection(infd);
+                Connection *pc = new (std::nothrow) Connection(infd, pStorage, _logger, protocol);
                 if (pc == nullptr) {
                     throw std::runtime_error("Failed to allocate connection");
                 }
 
-                // Register connection in worker's epoll
+                // Hand connection over to worker, it will register connection in its epoll
                 pc->Start();
                 if (pc->isAlive()) {
-                    pc->_event.events |= EPOLLONESHOT;
-                    int epoll_ctl_retval;
-                    if ((epoll_ctl_retval = epoll_ctl(_data_epoll_fd, EPOLL_CTL_ADD, pc->_socket, &pc->_event))) {
-                        _logger->debug("epoll_ctl failed during connection register in workers'epoll: error {}", epoll_ctl_retval);
-                        pc->OnError();
-                        delete pc;
-                    }
+                    SelectWorker().Adopt(pc);
+                } else {
+                    close(infd);
+                    delete pc;
                 }
             }
         }
     }
+    close(acceptor_epoll);
     _logger->warn("Acceptor stopped");
 }
 
@@ -1,6 +1,9 @@
 #ifndef AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 #define AFINA_NETWORK_MT_NONBLOCKING_SERVER_H
 
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -19,7 +22,9 @@ class Worker;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Epoll based server: acceptors hand connections over to the least loaded worker, each worker runs
+ * private epoll over its own connections. Balancer periodically samples workers load and asks the
+ * heaviest one to migrate a connection to the lightest one.
  */
 class ServerImpl : public Server {
 public:
@@ -39,6 +44,16 @@ protected:
     void OnRun();
     void OnNewConnection();
 
+    /**
+     * Method is running in the balancer thread
+     */
+    void OnBalance();
+
+    /**
+     * Select worker to hand new connection over to
+     */
+    Worker &SelectWorker();
+
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
@@ -55,14 +70,19 @@ private:
     // but share global server socket
     std::vector<std::thread> _acceptors;
 
-    // EPOLL instance shared between workers
-    int _data_epoll_fd;
-
-    // Curstom event "device" used to wakeup workers
+    // Curstom event "device" used to wakeup acceptors
     int _event_fd;
 
     // threads serving read/write requests
     std::vector<Worker> _workers;
+
+    // Thread sampling workers load and migrating connections between them
+    std::thread _balancer;
+
+    // Balancer sleeps on the condition between samples, flag is cleared on stop
+    std::mutex _balancer_mutex;
+    std::condition_variable _balancer_cv;
+    bool _balancing;
 };
 
 } // namespace MTnonblock
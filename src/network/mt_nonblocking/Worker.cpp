@@ -1,13 +1,18 @@
 #include "Worker.h"
 
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstring>
 #include <functional>
-#include <iostream>
+#include <stdexcept>
 
 #include <netdb.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 #include <spdlog/logger.h>
 
@@ -20,19 +25,39 @@ namespace Afina {
 namespace Network {
 namespace MTnonblock {
 
+constexpr double Worker::kEventWeight;
+
 // See Worker.h
 Worker::Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl)
-    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1) {
-    // TODO: implementation here
-}
+    : _pStorage(ps), _pLogging(pl), isRunning(false), _epoll_fd(-1), _event_fd(-1), _inbox(nullptr),
+      _migrate_target(nullptr), _migrate_load(0), _events(0), _bytes(0), _connections_count(0) {}
 
 // See Worker.h
 Worker::~Worker() {
-    // TODO: implementation here
+    // Thread is gone already, but some connections might be handed over after it stops
+    Connection *pconn = _inbox.exchange(nullptr);
+    while (pconn != nullptr) {
+        Connection *next = pconn->_inbox_next;
+        close(pconn->_socket);
+        pconn->OnClose();
+        delete pconn;
+        pconn = next;
+    }
+
+    if (_epoll_fd >= 0) {
+        close(_epoll_fd);
+    }
+    if (_event_fd >= 0) {
+        close(_event_fd);
+    }
 }
 
 // See Worker.h
-Worker::Worker(Worker &&other) { *this = std::move(other); }
+Worker::Worker(Worker &&other)
+    : isRunning(false), _epoll_fd(-1), _event_fd(-1), _inbox(nullptr), _migrate_target(nullptr), _migrate_load(0),
+      _events(0), _bytes(0), _connections_count(0) {
+    *this = std::move(other);
+}
 
 // See Worker.h
 Worker &Worker::operator=(Worker &&other) {
@@ -40,24 +65,58 @@ Worker &Worker::operator=(Worker &&other) {
     _pLogging = std::move(other._pLogging);
     _logger = std::move(other._logger);
     _thread = std::move(other._thread);
-    _epoll_fd = other._epoll_fd;
+    _connections = std::move(other._connections);
+    _stats_reset = other._stats_reset;
+
+    std::swap(_epoll_fd, other._epoll_fd);
+    std::swap(_event_fd, other._event_fd);
 
-    other._epoll_fd = -1;
+    isRunning.store(other.isRunning.load());
+    _inbox.store(other._inbox.exchange(_inbox.load()));
+    _migrate_target.store(other._migrate_target.exchange(nullptr));
+    _migrate_load.store(other._migrate_load.load());
+    _events.store(other._events.load());
+    _bytes.store(other._bytes.load());
+    _connections_count.store(other._connections_count.load());
     return *this;
 }
 
 // See Worker.h
-void Worker::Start(int epoll_fd) {
+void Worker::Start() {
     if (isRunning.exchange(true) == false) {
         assert(_epoll_fd == -1);
-        _epoll_fd = epoll_fd;
         _logger = _pLogging->select("network.worker");
+
+        _epoll_fd = epoll_create1(0);
+        if (_epoll_fd == -1) {
+            throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+        }
+
+        _event_fd = eventfd(0, EFD_NONBLOCK);
+        if (_event_fd == -1) {
+            throw std::runtime_error("Failed to create eventfd descriptor: " + std::string(strerror(errno)));
+        }
+
+        // nullptr is used for eventfd "interface", see OnRun
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+            throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+        }
+
+        _stats_reset = std::chrono::steady_clock::now();
         _thread = std::thread(&Worker::OnRun, this);
     }
 }
 
 // See Worker.h
-void Worker::Stop() { isRunning = false; }
+void Worker::Stop() {
+    isRunning = false;
+    if (_event_fd >= 0 && eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
 
 // See Worker.h
 void Worker::Join() {
@@ -65,15 +124,35 @@ void Worker::Join() {
     _thread.join();
 }
 
+// See Worker.h
+void Worker::Adopt(Connection *pconn) {
+    Connection *head = _inbox.load(std::memory_order_relaxed);
+    do {
+        pconn->_inbox_next = head;
+    } while (!_inbox.compare_exchange_weak(head, pconn, std::memory_order_release, std::memory_order_relaxed));
+
+    if (eventfd_write(_event_fd, 1)) {
+        _logger->error("Failed to signal worker about new connection");
+    }
+}
+
+// See Worker.h
+void Worker::RequestMigration(Worker *target, double load) {
+    _migrate_load.store(load, std::memory_order_relaxed);
+    _migrate_target.store(target, std::memory_order_release);
+
+    if (eventfd_write(_event_fd, 1)) {
+        _logger->error("Failed to signal worker about migration");
+    }
+}
+
 // See Worker.h
 void Worker::OnRun() {
     assert(_epoll_fd >= 0);
     _logger->trace("OnRun");
 
-    // Process connection events
-    //
-    // Do not forget to use EPOLLEXCLUSIVE flag when register socket
-    // for events to avoid thundering herd type behavior.
+    // Process connection events. Each connection is registered in exactly one worker's epoll, so
+    // there is no need for EPOLLONESHOT: nobody else could process it concurrently
     int timeout = -1;
     std::array<struct epoll_event, 64> mod_list;
     while (isRunning) {
@@ -83,56 +162,142 @@ void Worker::OnRun() {
         for (int i = 0; i < nmod; i++) {
             struct epoll_event &current_event = mod_list[i];
 
-            // nullptr is used by server for event_fd "interface", if we got here then server
-            // signals us to wakeup to process some state change, ignore it in INNER loop, react
-            // on changes in OUTHER loop
+            // nullptr is used for event_fd "interface", if we got here then someone signals us to wakeup
+            // to process some state change, ignore it in INNER loop, react on changes in OUTHER loop
             if (current_event.data.ptr == nullptr) {
+                eventfd_t value;
+                eventfd_read(_event_fd, &value);
                 continue;
             }
 
             // Some connection gets new data
             Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
+            auto old_mask = pconn->_event.events;
+            auto old_bytes = pconn->_stat_bytes;
             if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
                 _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
                 pconn->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                _logger->debug("Got EPOLLRDHUP, value of returned events: {}", current_event.events);
-                pconn->OnClose();
             } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
+                // Peer might close its writing end just after sending commands, so read them out before closing,
+                // in that case read returns 0 and connection gets closed once responses are flushed
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) {
                     _logger->trace("Got EPOLLIN");
                     pconn->DoRead();
                 }
-                if (current_event.events & EPOLLOUT) {
+                if (pconn->isAlive() && (current_event.events & EPOLLOUT)) {
                     _logger->trace("Got EPOLLOUT");
                     pconn->DoWrite();
                 }
             }
 
-            // Rearm connection
-            if (pconn->isAlive()) {
-                pconn->_event.events |= EPOLLONESHOT;
-                int epoll_ctl_retval;
-                if ((epoll_ctl_retval = epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event))) {
-                    _logger->debug("epoll_ctl failed during connection rearm: error {}", epoll_ctl_retval);
-                    pconn->OnError();
-                    delete pconn;
-                }
+            pconn->_stat_events++;
+            _events.fetch_add(1, std::memory_order_relaxed);
+            _bytes.fetch_add(pconn->_stat_bytes - old_bytes, std::memory_order_relaxed);
+
+            // Delete closed connection
+            if (!pconn->isAlive()) {
+                OnDelete(pconn);
             }
-            // Or delete closed one
-            else {
-                if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
-                    std::cerr << "Failed to delete connection!" << std::endl;
+            // Or update its mask
+            else if (pconn->_event.events != old_mask) {
+                if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
+                    _logger->error("Failed to change connection event mask");
+                    pconn->OnError();
+                    OnDelete(pconn);
                 }
-                delete pconn;
             }
         }
-        // TODO: Select timeout...
+
+        // State changes signalled over eventfd
+        OnInbox();
+        OnMigrate();
+    }
+
+    // Nothing will be processed anymore, release all connections
+    OnInbox();
+    while (!_connections.empty()) {
+        OnDelete(*_connections.begin());
     }
     _logger->warn("Worker stopped");
 }
 
+// See Worker.h
+void Worker::OnInbox() {
+    Connection *pconn = _inbox.exchange(nullptr, std::memory_order_acquire);
+    while (pconn != nullptr) {
+        Connection *next = pconn->_inbox_next;
+        pconn->_inbox_next = nullptr;
+
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, pconn->_socket, &pconn->_event)) {
+            _logger->error("Failed to register connection in worker's epoll: {}", strerror(errno));
+            close(pconn->_socket);
+            pconn->OnError();
+            delete pconn;
+        } else {
+            _connections.insert(pconn);
+            _connections_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        pconn = next;
+    }
+}
+
+// See Worker.h
+void Worker::OnMigrate() {
+    Worker *target = _migrate_target.exchange(nullptr, std::memory_order_acquire);
+    if (target == nullptr) {
+        return;
+    }
+
+    // Per connection load since previous migration request
+    auto now = std::chrono::steady_clock::now();
+    double period = std::chrono::duration<double>(now - _stats_reset).count();
+    double desired = _migrate_load.load(std::memory_order_relaxed);
+
+    Connection *candidate = nullptr;
+    double candidate_diff = 0;
+    for (auto pconn : _connections) {
+        double load = (pconn->_stat_bytes + kEventWeight * pconn->_stat_events) / std::max(period, 1e-3);
+        if (load > 0 && load < 2 * desired && (candidate == nullptr || std::abs(load - desired) < candidate_diff)) {
+            candidate = pconn;
+            candidate_diff = std::abs(load - desired);
+        }
+
+        pconn->_stat_bytes = 0;
+        pconn->_stat_events = 0;
+    }
+    _stats_reset = now;
+
+    if (candidate == nullptr) {
+        return;
+    }
+
+    // Connection carries all its state: partially parsed command, buffered input and queued output, so once it
+    // removed from our epoll nobody touches it until target registers it. Requests are served in the same order
+    _logger->debug("Migrate connection on descriptor {}", candidate->_socket);
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, candidate->_socket, &candidate->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+        return;
+    }
+    _connections.erase(candidate);
+    _connections_count.fetch_sub(1, std::memory_order_relaxed);
+    target->Adopt(candidate);
+}
+
+// See Worker.h
+void Worker::OnDelete(Connection *pconn) {
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
+        _logger->error("Failed to delete connection from epoll");
+    }
+
+    if (_connections.erase(pconn) > 0) {
+        _connections_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    close(pconn->_socket);
+    pconn->OnClose();
+    delete pconn;
+}
+
 } // namespace MTnonblock
 } // namespace Network
 } // namespace Afina
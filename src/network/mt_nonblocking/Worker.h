@@ -2,7 +2,9 @@
 #define AFINA_NETWORK_MT_NONBLOCKING_WORKER_H
 
 #include <atomic>
+#include <chrono>
 #include <memory>
+#include <set>
 #include <thread>
 
 namespace spdlog {
@@ -20,13 +22,23 @@ class Service;
 namespace Network {
 namespace MTnonblock {
 
+// Forward declaration, see Connection.h
+class Connection;
+
 /**
  * # Thread running epoll
- * On Start spaws background thread that is doing epoll on the given server
- * socket and process incoming connections and its data
+ * On Start spaws background thread that is doing epoll over the set of connections owned by this worker.
+ *
+ * Connections are handed over to the worker through the inbox: a lock-free list any thread could push to,
+ * worker gets signalled over eventfd and registers new connections in its private epoll instance. Inbox is
+ * used both by acceptors for new connections and by other workers migrating connections away.
  */
 class Worker {
 public:
+    // Weight of single event relative to one byte of traffic in the load estimation: each event costs
+    // epoll_wait and read/write syscalls, which is about the price of copying 1KB
+    static constexpr double kEventWeight = 1024;
+
     Worker(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Afina::Logging::Service> pl);
     ~Worker();
 
@@ -34,11 +46,10 @@ public:
     Worker &operator=(Worker &&);
 
     /**
-     * Spaws new background thread that is doing epoll on the given server
-     * socket. Once connection accepted it must be registered and being processed
-     * on this thread
+     * Spaws new background thread that is doing epoll on connections handed over to this worker. Once
+     * connection adopted it must be registered and being processed on this thread
      */
-    void Start(int epoll_fd);
+    void Start();
 
     /**
      * Signal background thread to stop. After that signal thread must stop to
@@ -54,12 +65,47 @@ public:
      */
     void Join();
 
+    /**
+     * Hand connection over to this worker. Could be called from any thread, connection
+     * must not be registered in any epoll instance at the moment
+     */
+    void Adopt(Connection *pconn);
+
+    /**
+     * Ask worker to move away one of its connections to the given target. Worker selects
+     * connection which load is closest to the given one, but less than twice of it so that
+     * migration never makes target heavier than this worker was
+     */
+    void RequestMigration(Worker *target, double load);
+
+    /**
+     * Load statistics, all counters are cumulative since worker start
+     */
+    inline uint64_t Events() const { return _events.load(std::memory_order_relaxed); }
+    inline uint64_t Bytes() const { return _bytes.load(std::memory_order_relaxed); }
+    inline uint64_t Connections() const { return _connections_count.load(std::memory_order_relaxed); }
+
 protected:
     /**
      * Method executing by background thread
      */
     void OnRun();
 
+    /**
+     * Register connections found in the inbox
+     */
+    void OnInbox();
+
+    /**
+     * Handle pending migration request if any
+     */
+    void OnMigrate();
+
+    /**
+     * Unregister connection from epoll and release all its resources
+     */
+    void OnDelete(Connection *pconn);
+
 private:
     Worker(Worker &) = delete;
     Worker &operator=(Worker &) = delete;
@@ -81,6 +127,27 @@ private:
 
     // EPOLL descriptor using for events processing
     int _epoll_fd;
+
+    // Custom event "device" used to wakeup worker: stop, new connections in inbox or migration request
+    int _event_fd;
+
+    // Connections handed over to the worker but not registered yet, linked through Connection::_inbox_next
+    std::atomic<Connection *> _inbox;
+
+    // Pending migration request: where to move and what load connection should have
+    std::atomic<Worker *> _migrate_target;
+    std::atomic<double> _migrate_load;
+
+    // Connections registered in this worker's epoll, accessed by the worker thread only
+    std::set<Connection *> _connections;
+
+    // When per-connection load counters were reset last time
+    std::chrono::steady_clock::time_point _stats_reset;
+
+    // Load counters, readed by the balancer
+    std::atomic<uint64_t> _events;
+    std::atomic<uint64_t> _bytes;
+    std::atomic<uint64_t> _connections_count;
 };
 
 } // namespace MTnonblock
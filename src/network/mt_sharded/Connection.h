@@ -0,0 +1,133 @@
+#ifndef AFINA_NETWORK_MT_SHARDED_CONNECTION_H
+#define AFINA_NETWORK_MT_SHARDED_CONNECTION_H
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <sys/epoll.h>
+
+#include <afina/execute/Command.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
+#include <protocol/Parser.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace MTshard {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+// Forward declaration, see below
+class Connection;
+
+/**
+ * Command executed on the shard other than connection's one. It travels to the owner of the key and back to the
+ * origin worker, which puts result into connection output in order
+ */
+struct Request {
+    // Where it came from, connection is touched by the origin worker only
+    Connection *connection;
+    std::size_t origin;
+
+    std::unique_ptr<Execute::Command> command;
+    std::string argument;
+    std::string result;
+
+    // Part of multi-key get split between shards: everything but the last part must not be terminated with END
+    bool partial;
+
+    // Result is ready, set and read by the origin worker
+    bool done;
+};
+
+/**
+ * # Client connection of the sharded server
+ * Connection is served by the worker that has accepted it. Commands on keys of other shards are sent away, so
+ * responses could be completed out of order: connection keeps requests in flight and writes results only
+ * once all previous ones are written.
+ */
+class Connection {
+public:
+    Connection(int s, Worker *worker, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               std::size_t output_high_watermark = 1024 * 1024, std::size_t output_low_watermark = 256 * 1024)
+        : _socket(s), _worker(worker), _logger(pl), _parser(protocol),
+          _output(output_high_watermark, output_low_watermark) {
+        std::memset(&_event, 0, sizeof(struct epoll_event));
+        _event.data.ptr = this;
+    }
+
+    inline bool isAlive() const { return _is_alive; }
+
+    void Start();
+
+protected:
+    void OnError();
+    void OnClose();
+    void DoRead();
+    void DoWrite();
+
+private:
+    friend class Worker;
+
+    // Execute all complete commands found in the input buffer
+    void ProcessInput();
+
+    // Queue response for the client and update event mask accordingly
+    void EnqueueResponse(const char *data, std::size_t size);
+
+    // Move results of completed requests at the head of pending list into output
+    void OnCompleted();
+
+    // Re-enable reading once output and pending requests are drained enough
+    void Resume();
+
+    // Argument at least that large is read from socket directly into the argument buffer
+    static constexpr std::size_t kDirectReadThreshold = 4096;
+
+    // Once there are that many requests in flight connection stops to read new commands
+    static constexpr std::size_t kMaxPending = 1024;
+
+    int _socket;
+    struct epoll_event _event;
+
+    // Connection is alive until error happens or both directions are done
+    bool _is_alive = true;
+
+    // Peer has closed its writing end, so once output is flushed connection is done
+    bool _eof = false;
+
+    Worker *_worker;
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Unparsed bytes received from the client
+    InputBuffer _input;
+
+    // Parse state of the command stream, see MTnonblock::Connection
+    std::size_t _arg_remains = 0;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Requests in the order they were received, results are written once head is done
+    std::deque<Request *> _pending;
+
+    // Connection is in the worker's list of connections that got results back
+    bool _completed = false;
+
+    // Responses to be sent to the client
+    OutputQueue _output;
+};
+
+} // namespace MTshard
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_SHARDED_CONNECTION_H
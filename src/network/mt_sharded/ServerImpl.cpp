@@ -0,0 +1,81 @@
+#include "ServerImpl.h"
+
+#include <stdexcept>
+
+#include <pthread.h>
+#include <signal.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Worker.h"
+
+namespace Afina {
+namespace Network {
+namespace MTshard {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl,
+                       StorageFactory factory, std::size_t max_size)
+    : Server(ps, pl), _storage_factory(std::move(factory)), _max_size(max_size) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start mt_sharded network service with {} shards", n_workers);
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Workers accept connections by themselves, so there are no acceptors
+    n_workers = std::max(n_workers, 1u);
+    std::size_t shard_size = _max_size / n_workers;
+    _logger->info("Every shard gets {} bytes of storage", shard_size);
+
+    std::vector<Worker *> peers;
+    for (uint32_t i = 0; i < n_workers; i++) {
+        _shards.push_back(_storage_factory(shard_size));
+        _shards.back()->Start();
+
+        _workers.emplace_back(new Worker(i, n_workers, _shards.back(), pLogging, protocol));
+        peers.push_back(_workers.back().get());
+    }
+
+    for (auto &worker : _workers) {
+        worker->Start(port, peers);
+    }
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+    for (auto &worker : _workers) {
+        worker->Stop();
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    for (auto &worker : _workers) {
+        worker->Join();
+    }
+    _workers.clear();
+
+    for (auto &shard : _shards) {
+        shard->Stop();
+    }
+    _shards.clear();
+}
+
+} // namespace MTshard
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,67 @@
+#ifndef AFINA_NETWORK_MT_SHARDED_SERVER_H
+#define AFINA_NETWORK_MT_SHARDED_SERVER_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace MTshard {
+
+// Forward declaration, see Worker.h
+class Worker;
+
+/**
+ * # Shard per core server
+ * Every worker is a shard: it accepts and serves own connections and owns private storage for part of the keys,
+ * so there are no locks on the data path. Commands on keys owned by other shards are passed as messages, see
+ * Worker. Storage instance given to the server is not used and could be null, shards are made by the factory
+ * instead: each one gets equal part of the memory budget, so all of them together take no more than the budget.
+ */
+class ServerImpl : public Server {
+public:
+    using StorageFactory = std::function<std::shared_ptr<Afina::Storage>(std::size_t max_size)>;
+
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl, StorageFactory factory,
+               std::size_t max_size);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Creates storage for every shard
+    StorageFactory _storage_factory;
+
+    // Memory budget of all shards together
+    std::size_t _max_size;
+
+    // Shards, each one is running own thread
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Private storage of every shard
+    std::vector<std::shared_ptr<Afina::Storage>> _shards;
+};
+
+} // namespace MTshard
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_SHARDED_SERVER_H
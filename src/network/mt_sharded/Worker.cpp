@@ -0,0 +1,518 @@
+#include "Worker.h"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/execute/Binary.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Get.h>
+#include <afina/execute/InsertCommand.h>
+#include <afina/execute/Meta.h>
+#include <afina/execute/Resp.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+
+namespace Afina {
+namespace Network {
+namespace MTshard {
+
+constexpr std::size_t Worker::kQueueSize;
+
+// How often worker that has stopped reading checks whether peers are done, ms
+static constexpr int kDrainPollInterval = 1;
+
+// Results travel between workers as strings, so response command produces in parts is collected whole
+static void ExecuteAll(Execute::Command &command, Afina::Storage &storage, const std::string &argument,
+                       std::string &result) {
+    do {
+        command.Execute(storage, argument, result);
+    } while (command.HasMore());
+}
+
+// See Worker.h
+Worker::Worker(std::size_t id, std::size_t shards, std::shared_ptr<Afina::Storage> ps,
+               std::shared_ptr<Afina::Logging::Service> pl, Protocol::Type protocol)
+    : _id(id), _pStorage(ps), _pLogging(pl), _protocol(protocol), isRunning(false), _reading(true), _server_socket(-1),
+      _epoll_fd(-1), _event_fd(-1), _backlog(shards), _notify(shards, false), _sleeping(false), _in_flight(0) {
+    // Peers could send messages as soon as they are started, so queues must exist before that
+    for (std::size_t i = 0; i < shards; i++) {
+        _incoming.emplace_back(new Afina::Concurrency::SpscQueue<Request *>(kQueueSize));
+    }
+}
+
+// See Worker.h
+Worker::~Worker() {
+    if (_server_socket >= 0) {
+        close(_server_socket);
+    }
+    if (_epoll_fd >= 0) {
+        close(_epoll_fd);
+    }
+    if (_event_fd >= 0) {
+        close(_event_fd);
+    }
+}
+
+// See Worker.h
+void Worker::Start(uint16_t port, const std::vector<Worker *> &peers) {
+    assert(peers.size() == _incoming.size());
+    _peers = peers;
+    _logger = _pLogging->select("network.worker");
+
+    // Every worker has own listening socket, kernel balances connections between sockets bound to the same port
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(port);
+    server_addr.sin_addr.s_addr = INADDR_ANY;
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEPORT, &opts, sizeof(opts)) == -1) {
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, 128) == -1) {
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _epoll_fd = epoll_create1(0);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create eventfd descriptor: " + std::string(strerror(errno)));
+    }
+
+    // nullptr is used for eventfd "interface" and address of the socket for the listening one, see OnRun
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _event_fd, &event)) {
+        throw std::runtime_error("Failed to add eventfd descriptor to epoll");
+    }
+
+    event.events = EPOLLIN;
+    event.data.ptr = &_server_socket;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _server_socket, &event)) {
+        throw std::runtime_error("Failed to add server socket to epoll");
+    }
+
+    isRunning = true;
+    _thread = std::thread(&Worker::OnRun, this);
+}
+
+// See Worker.h
+void Worker::Stop() {
+    isRunning = false;
+    if (_event_fd >= 0 && eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup worker");
+    }
+}
+
+// See Worker.h
+void Worker::Join() {
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+// See Worker.h
+std::size_t Worker::ShardOf(const std::string &key) const {
+    if (_peers.size() == 1) {
+        return 0;
+    }
+    return std::hash<std::string>()(key) % _peers.size();
+}
+
+// See Worker.h
+void Worker::Dispatch(Connection *pconn, std::unique_ptr<Execute::Command> command, std::string &argument) {
+    // Commands without keys, like stats, are executed in place
+    std::size_t shard = _id;
+    if (auto insert = dynamic_cast<Execute::InsertCommand *>(command.get())) {
+        shard = ShardOf(insert->key());
+    } else if (auto binary = dynamic_cast<Execute::Binary *>(command.get())) {
+        if (!binary->key().empty()) {
+            shard = ShardOf(binary->key());
+        }
+    } else if (auto remove = dynamic_cast<Execute::Delete *>(command.get())) {
+        shard = ShardOf(remove->key());
+    } else if (auto meta = dynamic_cast<Execute::Meta *>(command.get())) {
+        if (!meta->key().empty()) {
+            shard = ShardOf(meta->key());
+        }
+    } else if (auto resp = dynamic_cast<Execute::Resp *>(command.get())) {
+        // Same as Redis Cluster: multi-key command is served only if all keys belong to one shard
+        std::vector<std::string> keys = resp->keys();
+        if (!keys.empty()) {
+            shard = ShardOf(keys[0]);
+            for (std::size_t i = 1; i < keys.size(); i++) {
+                if (ShardOf(keys[i]) != shard) {
+                    resp->Refuse("CROSSSLOT Keys in request don't hash to the same slot");
+                    shard = _id;
+                    break;
+                }
+            }
+        }
+    } else if (auto get = dynamic_cast<Execute::Get *>(command.get())) {
+        // Split keys into runs owned by the same shard, so values come in the order keys were requested
+        const std::vector<std::string> &keys = get->keys();
+        if (!keys.empty()) {
+            std::size_t begin = 0;
+            shard = ShardOf(keys[0]);
+            for (std::size_t i = 1; i < keys.size(); i++) {
+                std::size_t owner = ShardOf(keys[i]);
+                if (owner != shard) {
+                    std::unique_ptr<Execute::Command> part(
+                        new Execute::Get(std::vector<std::string>(keys.begin() + begin, keys.begin() + i)));
+                    Route(pconn, shard, std::move(part), argument, true);
+                    begin = i;
+                    shard = owner;
+                }
+            }
+
+            if (begin > 0) {
+                std::vector<std::string> rest(keys.begin() + begin, keys.end());
+                command.reset(new Execute::Get(rest));
+            }
+        }
+    }
+
+    Route(pconn, shard, std::move(command), argument, false);
+}
+
+// See Worker.h
+void Worker::Route(Connection *pconn, std::size_t shard, std::unique_ptr<Execute::Command> command,
+                   std::string &argument, bool partial) {
+    // Nothing to wait for, so result goes to the output right away
+    if (shard == _id && !partial && pconn->_pending.empty()) {
+        std::string result;
+        ExecuteAll(*command, *_pStorage, argument, result);
+        pconn->EnqueueResponse(result.data(), result.size());
+        return;
+    }
+
+    Request *request = new Request{pconn, _id, std::move(command), std::string(), std::string(), partial, false};
+    if (!partial) {
+        request->argument = std::move(argument);
+    }
+    pconn->_pending.push_back(request);
+
+    if (shard == _id) {
+        Execute(request);
+        request->done = true;
+        pconn->OnCompleted();
+    } else {
+        _in_flight.store(_in_flight.load(std::memory_order_relaxed) + 1);
+        Send(shard, request);
+    }
+}
+
+// See Worker.h
+void Worker::Send(std::size_t shard, Request *request) {
+    std::deque<Request *> &backlog = _backlog[shard];
+    if (!backlog.empty() || !_peers[shard]->_incoming[_id]->Push(request)) {
+        backlog.push_back(request);
+    }
+    _notify[shard] = true;
+}
+
+// See Worker.h
+void Worker::Execute(Request *request) {
+    try {
+        ExecuteAll(*request->command, *_pStorage, request->argument, request->result);
+    } catch (std::exception &ex) {
+        // Connection is on other thread, so error is reported as the result
+        _logger->error("Failed to execute request: {}", ex.what());
+        request->result = "SERVER_ERROR ";
+        request->result += ex.what();
+        request->result += "\r\n";
+    }
+}
+
+// See Worker.h
+void Worker::OnRun() {
+    assert(_epoll_fd >= 0);
+    _logger->trace("OnRun");
+
+    std::array<struct epoll_event, 64> mod_list;
+    for (;;) {
+        if (_reading.load(std::memory_order_relaxed) && !isRunning.load()) {
+            OnStopReading();
+        }
+        if (!_reading.load(std::memory_order_relaxed) && Quiescent()) {
+            break;
+        }
+
+        // Sleep until something happens, unless messages have arrived already. Peers check the flag after
+        // they publish messages, so either they see it or we see the messages
+        int timeout = _reading.load(std::memory_order_relaxed) ? -1 : kDrainPollInterval;
+        for (auto &backlog : _backlog) {
+            if (!backlog.empty()) {
+                timeout = kDrainPollInterval;
+            }
+        }
+
+        _sleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        for (auto &queue : _incoming) {
+            if (!queue->Empty()) {
+                timeout = 0;
+                break;
+            }
+        }
+
+        int nmod = epoll_wait(_epoll_fd, &mod_list[0], mod_list.size(), timeout);
+        _sleeping.store(false, std::memory_order_relaxed);
+        _logger->debug("Worker wokeup: {} events", nmod);
+
+        for (int i = 0; i < nmod; i++) {
+            struct epoll_event &current_event = mod_list[i];
+
+            // Wakeup signal, whatever it is about is handled below
+            if (current_event.data.ptr == nullptr) {
+                eventfd_t value;
+                eventfd_read(_event_fd, &value);
+                continue;
+            }
+
+            if (current_event.data.ptr == &_server_socket) {
+                OnAccept();
+                continue;
+            }
+
+            // Some connection gets new data
+            Connection *pconn = static_cast<Connection *>(current_event.data.ptr);
+            auto old_mask = pconn->_event.events;
+            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
+                _logger->debug("Got EPOLLERR or EPOLLHUP, value of returned events: {}", current_event.events);
+                pconn->OnError();
+            } else {
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) {
+                    pconn->DoRead();
+                }
+                if (pconn->isAlive() && (current_event.events & EPOLLOUT)) {
+                    pconn->DoWrite();
+                }
+            }
+            OnUpdate(pconn, old_mask);
+        }
+
+        OnMessages();
+        OnFlush();
+    }
+
+    // Nobody will send anything anymore, flush what could be flushed and release connections
+    while (!_connections.empty()) {
+        Connection *pconn = *_connections.begin();
+        pconn->OnCompleted();
+        if (pconn->isAlive() && !pconn->_output.Empty()) {
+            pconn->DoWrite();
+        }
+
+        // All requests are back by now, so that is no-op unless there is a bug. But stuck connection must
+        // not hang the shutdown
+        for (auto request : pconn->_pending) {
+            delete request;
+        }
+        pconn->_pending.clear();
+        pconn->OnClose();
+        OnDelete(pconn);
+    }
+    _logger->warn("Worker stopped");
+}
+
+// See Worker.h
+void Worker::OnAccept() {
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len = sizeof in_addr;
+        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (infd == -1) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                _logger->error("Failed to accept socket: {}", strerror(errno));
+            }
+            break;
+        }
+
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        if (getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV) ==
+            0) {
+            _logger->info("Accepted connection on descriptor {} (host={}, port={})", infd, hbuf, sbuf);
+        }
+
+        Connection *pconn = new Connection(infd, this, _logger, _protocol);
+        pconn->Start();
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, infd, &pconn->_event)) {
+            _logger->error("Failed to register connection in epoll: {}", strerror(errno));
+            close(infd);
+            delete pconn;
+            continue;
+        }
+        _connections.insert(pconn);
+    }
+}
+
+// See Worker.h
+void Worker::OnMessages() {
+    for (std::size_t sender = 0; sender < _incoming.size(); sender++) {
+        Request *request = nullptr;
+        while (_incoming[sender]->Pop(request)) {
+            if (request->origin != _id) {
+                Execute(request);
+                Send(request->origin, request);
+                continue;
+            }
+
+            // Own request is back
+            request->done = true;
+            _in_flight.store(_in_flight.load(std::memory_order_relaxed) - 1);
+
+            Connection *pconn = request->connection;
+            if (!pconn->_completed) {
+                pconn->_completed = true;
+                _completed.push_back(pconn);
+            }
+        }
+    }
+
+    // Write all results got at once
+    for (auto pconn : _completed) {
+        pconn->_completed = false;
+
+        auto old_mask = pconn->_event.events;
+        pconn->OnCompleted();
+        if (pconn->isAlive() && !pconn->_output.Empty()) {
+            pconn->DoWrite();
+        }
+        OnUpdate(pconn, old_mask);
+    }
+    _completed.clear();
+}
+
+// See Worker.h
+void Worker::OnFlush() {
+    bool notify = false;
+    for (std::size_t shard = 0; shard < _backlog.size(); shard++) {
+        std::deque<Request *> &backlog = _backlog[shard];
+        while (!backlog.empty() && _peers[shard]->_incoming[_id]->Push(backlog.front())) {
+            backlog.pop_front();
+        }
+        notify = notify || _notify[shard];
+    }
+
+    if (!notify) {
+        return;
+    }
+
+    // Pairs with the fence in OnRun: messages are published before we check whether peer sleeps
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (std::size_t shard = 0; shard < _notify.size(); shard++) {
+        if (_notify[shard]) {
+            _notify[shard] = false;
+            if (_peers[shard]->_sleeping.load() && eventfd_write(_peers[shard]->_event_fd, 1)) {
+                _logger->error("Failed to signal worker {}", shard);
+            }
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnStopReading() {
+    _logger->debug("Stop reading");
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, _server_socket, nullptr)) {
+        _logger->error("Failed to delete server socket from epoll");
+    }
+    close(_server_socket);
+    _server_socket = -1;
+
+    // Connections are done once responses for commands already read are written
+    for (auto it = _connections.begin(); it != _connections.end();) {
+        Connection *pconn = *it++;
+        if (!pconn->isAlive()) {
+            continue;
+        }
+
+        auto old_mask = pconn->_event.events;
+        pconn->_eof = true;
+        pconn->_event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        if (pconn->_output.Empty() && pconn->_pending.empty()) {
+            pconn->OnClose();
+        }
+        OnUpdate(pconn, old_mask);
+    }
+
+    // Once all workers have done that, no new requests could appear
+    _reading.store(false);
+}
+
+// See Worker.h
+bool Worker::Quiescent() const {
+    for (auto peer : _peers) {
+        if (peer->_reading.load() || peer->_in_flight.load() > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// See Worker.h
+void Worker::OnUpdate(Connection *pconn, uint32_t old_mask) {
+    if (!pconn->isAlive()) {
+        OnDelete(pconn);
+    } else if (pconn->_event.events != old_mask) {
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, pconn->_socket, &pconn->_event)) {
+            _logger->error("Failed to change connection event mask");
+            pconn->OnError();
+            OnDelete(pconn);
+        }
+    }
+}
+
+// See Worker.h
+void Worker::OnDelete(Connection *pconn) {
+    if (pconn->_socket >= 0) {
+        if (epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, pconn->_socket, &pconn->_event)) {
+            _logger->error("Failed to delete connection from epoll");
+        }
+        close(pconn->_socket);
+        pconn->_socket = -1;
+        pconn->OnClose();
+    }
+
+    // Requests in flight refer to the connection, it is released once the last one comes back
+    if (pconn->_pending.empty()) {
+        _connections.erase(pconn);
+        delete pconn;
+    }
+}
+
+} // namespace MTshard
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,197 @@
+#ifndef AFINA_NETWORK_MT_SHARDED_WORKER_H
+#define AFINA_NETWORK_MT_SHARDED_WORKER_H
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/SpscQueue.h>
+#include <afina/execute/Command.h>
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+namespace Logging {
+class Service;
+}
+
+namespace Network {
+namespace MTshard {
+
+// Forward declaration, see Connection.h
+class Connection;
+struct Request;
+
+/**
+ * # Shard: thread owning part of the keys and connections it has accepted
+ * Every worker listens on the same port through SO_REUSEPORT socket of its own, so kernel spreads connections
+ * between workers. Keys are spread by hash, each worker has private storage for its keys and nobody else
+ * touches it, so storage needs no locks.
+ *
+ * Command on the key of other shard is sent to its owner as a request over single-producer single-consumer
+ * queue dedicated to that pair of workers, owner executes it and sends back over the queue in the opposite
+ * direction. Worker going to sleep in epoll_wait raises a flag, so peers signal eventfd only when that is
+ * really needed.
+ */
+class Worker {
+public:
+    // Capacity of the queue between each pair of workers, requests that don't fit wait in sender's backlog
+    static constexpr std::size_t kQueueSize = 4096;
+
+    Worker(std::size_t id, std::size_t shards, std::shared_ptr<Afina::Storage> ps,
+           std::shared_ptr<Afina::Logging::Service> pl, Protocol::Type protocol);
+    ~Worker();
+
+    /**
+     * Create listening socket and spawn background thread. All workers must be constructed before any
+     * is started: they talk to each other right away
+     */
+    void Start(uint16_t port, const std::vector<Worker *> &peers);
+
+    /**
+     * Signal background thread to stop. Worker stops to accept connections and to read new commands, but keeps
+     * serving requests of the peers until all of them are stopped and no request is in flight
+     */
+    void Stop();
+
+    /**
+     * Blocks calling thread until background one for this worker is actually been destoryed
+     */
+    void Join();
+
+    /**
+     * Execute command read from the connection: in place if key is owned by this worker, otherwise send
+     * request to the owner. Result is put into connection output in order of commands
+     */
+    void Dispatch(Connection *pconn, std::unique_ptr<Execute::Command> command, std::string &argument);
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+    /**
+     * Accept all pending connections
+     */
+    void OnAccept();
+
+    /**
+     * Execute requests of the peers and complete own requests sent back
+     */
+    void OnMessages();
+
+    /**
+     * Stop to accept connections and to read commands, once peers are done with requests of this worker
+     * connections are closed
+     */
+    void OnStopReading();
+
+    /**
+     * Push requests waiting in backlogs and wake up peers that got something
+     */
+    void OnFlush();
+
+    /**
+     * Sync connection event mask with epoll or release it once connection is dead
+     */
+    void OnUpdate(Connection *pconn, uint32_t old_mask);
+
+    /**
+     * Unregister connection from epoll and release all its resources. Connection with requests in flight
+     * is kept until they come back
+     */
+    void OnDelete(Connection *pconn);
+
+private:
+    Worker(Worker &) = delete;
+    Worker &operator=(Worker &) = delete;
+
+    // Shard owning the key
+    std::size_t ShardOf(const std::string &key) const;
+
+    // Execute command on the given shard, partial is set for all but the last part of split multi-key get
+    void Route(Connection *pconn, std::size_t shard, std::unique_ptr<Execute::Command> command,
+               std::string &argument, bool partial);
+
+    // Hand request over to the given worker, requests never get lost: once queue is full they wait in backlog
+    void Send(std::size_t shard, Request *request);
+
+    // Execute request on the local storage
+    void Execute(Request *request);
+
+    // Nothing is in flight and all workers have stopped to read, so no new request could appear
+    bool Quiescent() const;
+
+    // Index of the worker, the same as shard number
+    const std::size_t _id;
+
+    // Private storage of the shard
+    std::shared_ptr<Afina::Storage> _pStorage;
+
+    // afina services
+    std::shared_ptr<Afina::Logging::Service> _pLogging;
+
+    // Protocol spoken by accepted connections
+    const Protocol::Type _protocol;
+
+    // Logger to be used
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Flag signals that thread should continue to read new commands
+    std::atomic<bool> isRunning;
+
+    // Cleared once worker has stopped reading, so no new requests would be sent by it
+    std::atomic<bool> _reading;
+
+    // Thread serving requests in this worker
+    std::thread _thread;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // EPOLL descriptor using for events processing
+    int _epoll_fd;
+
+    // Custom event "device" used to wakeup worker: stop or new messages
+    int _event_fd;
+
+    // All workers, including this one, indexed by shard
+    std::vector<Worker *> _peers;
+
+    // Queues from every peer to this worker, indexed by sender
+    std::vector<std::unique_ptr<Afina::Concurrency::SpscQueue<Request *>>> _incoming;
+
+    // Requests to every peer that don't fit into its queue yet, and peers to be signalled after the loop
+    // iteration. Accessed by the worker thread only
+    std::vector<std::deque<Request *>> _backlog;
+    std::vector<bool> _notify;
+
+    // Set while worker is about to block in epoll_wait, peers wake it up over eventfd only then
+    std::atomic<bool> _sleeping;
+
+    // Requests sent to other shards and not returned yet, modified by the worker thread only
+    std::atomic<uint64_t> _in_flight;
+
+    // Connections that got results back during current loop iteration
+    std::vector<Connection *> _completed;
+
+    // Connections accepted by this worker, accessed by the worker thread only
+    std::set<Connection *> _connections;
+};
+
+} // namespace MTshard
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_MT_SHARDED_WORKER_H
@@ -126,7 +126,7 @@ void ServerImpl::OnRun() {
     // - arg_remains: how many bytes to read from stream to get command argument
     // - argument_for_command: buffer stores argument
     std::size_t arg_remains;
-    Protocol::Parser parser;
+    Protocol::Parser parser(protocol);
     std::string argument_for_command;
     std::unique_ptr<Execute::Command> command_to_execute;
     while (running.load()) {
@@ -220,13 +220,16 @@ void ServerImpl::OnRun() {
                         if (argument_for_command.size()) {
                             argument_for_command.resize(argument_for_command.size() - 2);
                         }
-                        command_to_execute->Execute(*pStorage, argument_for_command, result);
 
-                        // Send response
-                        result += "\r\n";
-                        if (send(client_socket, result.data(), result.size(), 0) <= 0) {
-                            throw std::runtime_error("Failed to send response");
-                        }
+                        // Send response, quiet commands could have none. Large one comes in parts, each is sent
+                        // before the next is fetched
+                        do {
+                            result.clear();
+                            command_to_execute->Execute(*pStorage, argument_for_command, result);
+                            if (!result.empty() && send(client_socket, result.data(), result.size(), 0) <= 0) {
+                                throw std::runtime_error("Failed to send response");
+                            }
+                        } while (command_to_execute->HasMore());
 
                         // Prepare for the next command
                         command_to_execute.reset();
@@ -241,8 +244,12 @@ void ServerImpl::OnRun() {
             } else {
                 throw std::runtime_error(std::string(strerror(errno)));
             }
-        } catch (std::runtime_error &ex) {
+        } catch (std::exception &ex) {
             _logger->error("Failed to process connection on descriptor {}: {}", client_socket, ex.what());
+
+            // Tell client why, if socket still works, and close
+            const std::string &error = parser.Error();
+            send(client_socket, error.data(), error.size(), MSG_NOSIGNAL);
         }
 
         // We are done with this connection
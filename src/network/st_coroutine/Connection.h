@@ -1,36 +1,80 @@
 #ifndef AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
 #define AFINA_NETWORK_ST_COROUTINE_CONNECTION_H
 
-#include <cstring>
+#include <memory>
+#include <string>
 
-#include <sys/epoll.h>
+#include <afina/execute/Command.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
+#include <protocol/Parser.h>
+
+#include "Reactor.h"
+
+namespace spdlog {
+class logger;
+}
 
 namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
 namespace Network {
 namespace STcoroutine {
 
+/**
+ * # Client connection served by a coroutine
+ * Written as blocking code: read whatever client sent, execute all commands that came in completely, write
+ * responses, repeat. Reactor turns every EAGAIN into a switch to other coroutines, so a single thread serves
+ * all connections.
+ */
 class Connection {
 public:
-    Connection(int s) : _socket(s) {
-        std::memset(&_event, 0, sizeof(struct epoll_event));
-        _event.data.ptr = this;
-    }
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               Reactor &reactor)
+        : _socket(s), _pStorage(ps), _logger(pl), _reactor(reactor), _parser(protocol) {}
 
-    inline bool isAlive() const { return true; }
+    /**
+     * Body of the connection coroutine, returns once client has gone or connection failed. Socket is closed
+     * on return
+     */
+    void Serve();
 
-    void Start();
+    /**
+     * Stop to read new commands, responses to commands read already are still sent. Could be called from any
+     * coroutine of the same engine
+     */
+    void Shutdown();
 
 protected:
-    void OnError();
-    void OnClose();
-    void DoRead();
-    void DoWrite();
+    // Execute all commands that are in the input buffer completely
+    void ProcessInput();
+
+    // Write all responses, blocks coroutine until they are sent
+    void Flush(Reactor::Handle *handle);
 
 private:
-    friend class ServerImpl;
+    // Argument of that many bytes and more is read straight from the socket, bypassing input buffer
+    static constexpr std::size_t kDirectReadThreshold = 4096;
 
     int _socket;
-    struct epoll_event _event;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+    Reactor &_reactor;
+
+    // Bytes received, but not parsed yet
+    InputBuffer _input;
+
+    // Command being read, last _arg_remains bytes of its argument haven't arrived yet
+    std::size_t _arg_remains = 0;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Responses not sent yet
+    OutputQueue _output;
 };
 
 } // namespace STcoroutine
@@ -0,0 +1,156 @@
+#include "Reactor.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <afina/coroutine/Engine.h>
+
+namespace Afina {
+namespace Network {
+namespace STcoroutine {
+
+// Events descriptor is always registered for
+static constexpr uint32_t kReadEvents = EPOLLIN | EPOLLRDHUP | EPOLLET;
+
+// See Reactor.h
+Reactor::Reactor(Afina::Coroutine::Engine &engine) : _engine(engine) {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+}
+
+// See Reactor.h
+Reactor::~Reactor() { close(_epoll_fd); }
+
+// See Reactor.h
+Reactor::Handle *Reactor::Register(int fd) {
+    Handle *handle = new Handle{fd, nullptr, nullptr};
+    if (!Control(EPOLL_CTL_ADD, handle, kReadEvents)) {
+        delete handle;
+        throw std::runtime_error("Failed to add file descriptor to epoll: " + std::string(strerror(errno)));
+    }
+    return handle;
+}
+
+// See Reactor.h
+void Reactor::Unregister(Handle *handle) {
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, handle->fd, nullptr);
+    delete handle;
+}
+
+// See Reactor.h
+void Reactor::Wait(Handle *handle, uint32_t events) {
+    if (events & EPOLLIN) {
+        handle->reader = _engine.current();
+        _engine.block();
+
+        // Normally Poll has cleared it already
+        handle->reader = nullptr;
+        return;
+    }
+
+    // Socket is writable almost always, so EPOLLOUT is watched only while somebody waits for it. Otherwise
+    // every ACK would wake epoll_wait up for nothing
+    if (!Control(EPOLL_CTL_MOD, handle, kReadEvents | EPOLLOUT)) {
+        return;
+    }
+    handle->writer = _engine.current();
+    _engine.block();
+    handle->writer = nullptr;
+    Control(EPOLL_CTL_MOD, handle, kReadEvents);
+}
+
+// See Reactor.h
+ssize_t Reactor::Read(Handle *handle, void *buffer, std::size_t size) {
+    for (;;) {
+        ssize_t result = read(handle->fd, buffer, size);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLIN);
+        }
+    }
+}
+
+// See Reactor.h
+ssize_t Reactor::Writev(Handle *handle, const struct iovec *iov, int iovcnt) {
+    for (;;) {
+        ssize_t result = writev(handle->fd, iov, iovcnt);
+        if (result >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLOUT);
+        }
+    }
+}
+
+// See Reactor.h
+int Reactor::Accept(Handle *handle, struct sockaddr *addr, socklen_t *addrlen) {
+    for (;;) {
+        socklen_t len = *addrlen;
+        int result = accept4(handle->fd, addr, &len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (result >= 0) {
+            *addrlen = len;
+            return result;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            return result;
+        }
+        if (errno != EINTR) {
+            Wait(handle, EPOLLIN);
+        }
+    }
+}
+
+// See Reactor.h
+bool Reactor::Control(int op, Handle *handle, uint32_t events) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.ptr = handle;
+    return epoll_ctl(_epoll_fd, op, handle->fd, &event) == 0;
+}
+
+// See Reactor.h
+void Reactor::Poll() {
+    std::array<struct epoll_event, 64> events;
+    for (int resumed = 0; resumed == 0;) {
+        int count = epoll_wait(_epoll_fd, events.data(), events.size(), -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to wait for events: " + std::string(strerror(errno)));
+        }
+
+        for (int i = 0; i < count; i++) {
+            Handle *handle = static_cast<Handle *>(events[i].data.ptr);
+            uint32_t ready = events[i].events;
+
+            // Errors wake up both sides, so they notice it on the next call
+            if (handle->reader != nullptr && (ready & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))) {
+                _engine.unblock(handle->reader);
+                handle->reader = nullptr;
+                resumed++;
+            }
+            if (handle->writer != nullptr && (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP))) {
+                _engine.unblock(handle->writer);
+                handle->writer = nullptr;
+                resumed++;
+            }
+        }
+    }
+}
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
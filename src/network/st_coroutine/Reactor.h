@@ -0,0 +1,90 @@
+#ifndef AFINA_NETWORK_ST_COROUTINE_REACTOR_H
+#define AFINA_NETWORK_ST_COROUTINE_REACTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace Afina {
+namespace Coroutine {
+class Engine;
+}
+
+namespace Network {
+namespace STcoroutine {
+
+/**
+ * # Blocking I/O for coroutines on top of epoll
+ * Descriptors are registered in epoll once, edge triggered. Operation that gets EAGAIN remembers current
+ * coroutine as waiting for the descriptor and blocks it in the engine, so code using reactor looks like plain
+ * blocking I/O while thread serves other coroutines.
+ *
+ * Poll is meant to be the engine unblocker: once every coroutine is blocked it waits in epoll_wait and
+ * unblocks coroutines whose descriptors got ready. Only one coroutine could wait for each direction of the
+ * descriptor at a time.
+ */
+class Reactor {
+public:
+    /**
+     * Descriptor registered in reactor and coroutines waiting for it
+     */
+    struct Handle {
+        int fd;
+        void *reader;
+        void *writer;
+    };
+
+    explicit Reactor(Afina::Coroutine::Engine &engine);
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+
+    /**
+     * Start to track non-blocking descriptor, throws std::runtime_error on failure
+     */
+    Handle *Register(int fd);
+
+    /**
+     * Stop to track descriptor, must be called before it gets closed. Nobody could wait for it at that moment
+     */
+    void Unregister(Handle *handle);
+
+    /**
+     * Block current coroutine until descriptor is ready for EPOLLIN or EPOLLOUT. Could return spuriously,
+     * for example on error or hang up
+     */
+    void Wait(Handle *handle, uint32_t events);
+
+    /**
+     * Same as read/writev/accept4, but block current coroutine instead of returning EAGAIN. Accepted
+     * descriptor is non-blocking already
+     */
+    ssize_t Read(Handle *handle, void *buffer, std::size_t size);
+    ssize_t Writev(Handle *handle, const struct iovec *iov, int iovcnt);
+    int Accept(Handle *handle, struct sockaddr *addr, socklen_t *addrlen);
+
+    /**
+     * Wait for events and unblock coroutines that have been waiting for them, returns once at least one
+     * coroutine is unblocked
+     */
+    void Poll();
+
+private:
+    // epoll_ctl for the handle, returns false on failure
+    bool Control(int op, Handle *handle, uint32_t events);
+
+    Afina::Coroutine::Engine &_engine;
+
+    // EPOLL descriptor using for events processing
+    int _epoll_fd;
+};
+
+} // namespace STcoroutine
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_COROUTINE_REACTOR_H
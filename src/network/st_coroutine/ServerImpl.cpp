@@ -19,9 +19,11 @@
 #include <spdlog/logger.h>
 
 #include <afina/Storage.h>
+#include <afina/coroutine/Engine.h>
 #include <afina/logging/Service.h>
 
 #include "Connection.h"
+#include "Reactor.h"
 #include "Utils.h"
 
 namespace Afina {
@@ -37,7 +39,7 @@ ServerImpl::~ServerImpl() {}
 // See Server.h
 void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
     _logger = pLogging->select("network");
-    _logger->info("Start st_nonblocking network service");
+    _logger->info("Start st_coroutine network service");
 
     sigset_t sig_mask;
     sigemptyset(&sig_mask);
@@ -59,7 +61,8 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     int opts = 1;
-    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1) {
+    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
     }
@@ -70,7 +73,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
     }
 
     make_socket_non_blocking(_server_socket);
-    if (listen(_server_socket, 5) == -1) {
+    if (listen(_server_socket, 128) == -1) {
         close(_server_socket);
         throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
     }
@@ -87,7 +90,7 @@ void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers)
 void ServerImpl::Stop() {
     _logger->warn("Stop network service");
 
-    // Wakeup threads that are sleep on epoll_wait
+    // Wakeup coroutine waiting for the stop signal
     if (eventfd_write(_event_fd, 1)) {
         throw std::runtime_error("Failed to wakeup workers");
     }
@@ -96,106 +99,47 @@ void ServerImpl::Stop() {
 // See Server.h
 void ServerImpl::Join() {
     // Wait for work to be complete
-    _work_thread.join();
+    if (_work_thread.joinable()) {
+        _work_thread.join();
+    }
 }
 
 // See ServerImpl.h
 void ServerImpl::OnRun() {
     _logger->info("Start acceptor");
-    int epoll_descr = epoll_create1(0);
-    if (epoll_descr == -1) {
-        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
-    }
-
-    struct epoll_event event;
-    event.events = EPOLLIN;
-    event.data.fd = _server_socket;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _server_socket, &event)) {
-        throw std::runtime_error("Failed to add file descriptor to epoll");
-    }
-
-    struct epoll_event event2;
-    event2.events = EPOLLIN;
-    event2.data.fd = _event_fd;
-    if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, _event_fd, &event2)) {
-        throw std::runtime_error("Failed to add file descriptor to epoll");
-    }
-
-    bool run = true;
-    std::array<struct epoll_event, 64> mod_list;
-    while (run) {
-        int nmod = epoll_wait(epoll_descr, &mod_list[0], mod_list.size(), -1);
-        _logger->debug("Acceptor wokeup: {} events", nmod);
-
-        for (int i = 0; i < nmod; i++) {
-            struct epoll_event &current_event = mod_list[i];
-            if (current_event.data.fd == _event_fd) {
-                _logger->debug("Break acceptor due to stop signal");
-                run = false;
-                continue;
-            } else if (current_event.data.fd == _server_socket) {
-                OnNewConnection(epoll_descr);
-                continue;
-            }
-
-            // That is some connection!
-            Connection *pc = static_cast<Connection *>(current_event.data.ptr);
-
-            auto old_mask = pc->_event.events;
-            if ((current_event.events & EPOLLERR) || (current_event.events & EPOLLHUP)) {
-                pc->OnError();
-            } else if (current_event.events & EPOLLRDHUP) {
-                pc->OnClose();
-            } else {
-                // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) {
-                    pc->DoRead();
-                }
-                if (current_event.events & EPOLLOUT) {
-                    pc->DoWrite();
-                }
-            }
-
-            // Does it alive?
-            if (!pc->isAlive()) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_DEL, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to delete connection from epoll");
-                }
 
-                close(pc->_socket);
-                pc->OnClose();
+    // Nothing to run means everything is blocked in reactor, so wait for events there
+    Afina::Coroutine::Engine engine([this](Afina::Coroutine::Engine &) { _reactor->Poll(); });
+    Reactor reactor(engine);
+    _engine = &engine;
+    _reactor = &reactor;
 
-                delete pc;
-            } else if (pc->_event.events != old_mask) {
-                if (epoll_ctl(epoll_descr, EPOLL_CTL_MOD, pc->_socket, &pc->_event)) {
-                    _logger->error("Failed to change connection event mask");
+    engine.start(&ServerImpl::OnAccept, *this);
 
-                    close(pc->_socket);
-                    pc->OnClose();
-
-                    delete pc;
-                }
-            }
-        }
-    }
+    _engine = nullptr;
+    _reactor = nullptr;
+    close(_server_socket);
+    close(_event_fd);
     _logger->warn("Acceptor stopped");
 }
 
-void ServerImpl::OnNewConnection(int epoll_descr) {
+// See ServerImpl.h
+void ServerImpl::OnAccept(ServerImpl &server) {
+    Reactor::Handle *listener = server._reactor->Register(server._server_socket);
+    server._engine->run(&ServerImpl::OnStop, server);
+
     for (;;) {
         struct sockaddr in_addr;
-        socklen_t in_len;
-
-        // No need to make these sockets non blocking since accept4() takes care of it.
-        in_len = sizeof in_addr;
-        int infd = accept4(_server_socket, &in_addr, &in_len, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        socklen_t in_len = sizeof in_addr;
+        int infd = server._reactor->Accept(listener, &in_addr, &in_len);
         if (infd == -1) {
-            if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
-                break; // We have processed all incoming connections.
-            } else {
-                _logger->error("Failed to accept socket");
+            if (server._stopping) {
                 break;
+            } else if (errno == ECONNABORTED || errno == EPROTO) {
+                continue;
             }
+            server._logger->error("Failed to accept socket: {}", strerror(errno));
+            break;
         }
 
         // Print host and service info.
@@ -203,24 +147,44 @@ void ServerImpl::OnNewConnection(int epoll_descr) {
         int retval =
             getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
         if (retval == 0) {
-            _logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+            server._logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
         }
 
-        // Register the new FD to be monitored by epoll.
-        Connection *pc = new (std::nothrow) Connection(infd);
-        if (pc == nullptr) {
-            throw std::runtime_error("Failed to allocate connection");
+        Connection *pc = new Connection(infd, server.pStorage, server._logger, server.protocol, *server._reactor);
+        server._connections.insert(pc);
+        if (server._engine->run(&ServerImpl::OnConnection, server, *pc) == nullptr) {
+            server._logger->error("Failed to start coroutine for descriptor {}", infd);
+            server._connections.erase(pc);
+            close(infd);
+            delete pc;
         }
+    }
 
-        // Register connection in worker's epoll
-        pc->Start();
-        if (pc->isAlive()) {
-            if (epoll_ctl(epoll_descr, EPOLL_CTL_ADD, pc->_socket, &pc->_event)) {
-                pc->OnError();
-                delete pc;
-            }
-        }
+    server._reactor->Unregister(listener);
+}
+
+// See ServerImpl.h
+void ServerImpl::OnStop(ServerImpl &server) {
+    Reactor::Handle *handle = server._reactor->Register(server._event_fd);
+    eventfd_t value;
+    while (server._reactor->Read(handle, &value, sizeof(value)) < 0 && errno == EINTR) {
     }
+    server._reactor->Unregister(handle);
+
+    // Acceptor gets an error once socket is shut down, connections get EOF and leave once responses are sent
+    server._logger->debug("Stop signal received");
+    server._stopping = true;
+    shutdown(server._server_socket, SHUT_RDWR);
+    for (auto pc : server._connections) {
+        pc->Shutdown();
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnConnection(ServerImpl &server, Connection &connection) {
+    connection.Serve();
+    server._connections.erase(&connection);
+    delete &connection;
 }
 
 } // namespace STcoroutine
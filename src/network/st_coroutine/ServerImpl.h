@@ -1,8 +1,8 @@
 #ifndef AFINA_NETWORK_ST_COROUTINE_SERVER_H
 #define AFINA_NETWORK_ST_COROUTINE_SERVER_H
 
+#include <set>
 #include <thread>
-#include <vector>
 
 #include <afina/network/Server.h>
 
@@ -11,15 +11,21 @@ class logger;
 }
 
 namespace Afina {
+namespace Coroutine {
+class Engine;
+}
+
 namespace Network {
 namespace STcoroutine {
 
-// Forward declaration, see Worker.h
-class Worker;
+// Forward declaration, see Connection.h
+class Connection;
+class Reactor;
 
 /**
  * # Network resource manager implementation
- * Epoll based server
+ * Single thread running coroutine engine: acceptor, every connection and stop signal are coroutines doing
+ * blocking I/O through Reactor, engine unblocker waits in epoll_wait for the next thing to do.
  */
 class ServerImpl : public Server {
 public:
@@ -36,26 +42,48 @@ public:
     void Join() override;
 
 protected:
+    /**
+     * Method executing by background thread
+     */
     void OnRun();
-    void OnNewConnection(int);
+
+    /**
+     * Main coroutine: accepts connections and spawns coroutine for each one until server is stopped
+     */
+    static void OnAccept(ServerImpl &server);
+
+    /**
+     * Coroutine waiting for stop signal: closes listening socket and makes connections finish
+     */
+    static void OnStop(ServerImpl &server);
+
+    /**
+     * Coroutine serving a single connection
+     */
+    static void OnConnection(ServerImpl &server, Connection &connection);
 
 private:
     // logger to use
     std::shared_ptr<spdlog::logger> _logger;
 
-    // Port to listen for new connections, permits access only from
-    // inside of accept_thread
-    // Read-only
-    uint16_t listen_port;
-
-    // Socket to accept new connection on, shared between acceptors
+    // Socket to accept new connection on
     int _server_socket;
 
-    // Curstom event "device" used to wakeup workers
+    // Curstom event "device" used to signal stop
     int _event_fd;
 
     // IO thread
     std::thread _work_thread;
+
+    // Engine and reactor of the IO thread, valid while it runs
+    Afina::Coroutine::Engine *_engine = nullptr;
+    Reactor *_reactor = nullptr;
+
+    // Set once stop signal is received, accessed by IO thread only
+    bool _stopping = false;
+
+    // Connections being served, accessed by IO thread only
+    std::set<Connection *> _connections;
 };
 
 } // namespace STcoroutine
@@ -1,8 +1,14 @@
 #include "Connection.h"
 
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <stdexcept>
 
 #include <sys/uio.h>
+#include <unistd.h>
+
+#include <afina/Storage.h>
 
 namespace Afina {
 namespace Network {
@@ -13,12 +19,16 @@ void Connection::Start()
 {
     _logger->debug("Start {} socket", _socket);
     _is_alive = true; // Клиент у нас есть
-    _read_bytes = 0; // Байтики не прочитали
-    _write_bytes = 0; // Байтики не записали
+    _eof = false;
+    _input.Clear(); // Байтики не прочитали
+    _arg_remains = 0;
+    _parser.Reset();
+    _argument_for_command.clear();
+    _command_to_execute.Reset();
     _event.data.fd = _socket; 
     _event.data.ptr = this;
     _event.events = EPOLLIN | EPOLLRDHUP | EPOLLERR; // Что может быть на старте? Чтение, закрытие соединения или ошибка
-    _output.clear(); // прошлые ответы чистим,мало ли
+    _output.Clear(); // прошлые ответы чистим,мало ли
 }
 
 // See Connection.h
@@ -39,174 +49,232 @@ void Connection::OnClose()
 void Connection::DoRead()
 {
     _logger->debug("DoRead {} socket", _socket); // Начинаем чтение
-    // Всё как во второй домашке
-    try {
-        int readed_bytes = -1;
-        if((readed_bytes = read(_socket, _client_buffer + _read_bytes, sizeof(_client_buffer) - _read_bytes)) > 0)
+    try
+    {
+        // Читаем пока сокет не опустеет, но если ответов накопилось слишком много - хватит
+        while (_is_alive && !_eof && (_event.events & EPOLLIN))
         {
-            _read_bytes += readed_bytes;
-            _logger->debug("Got {} bytes from socket", readed_bytes);
-
-
-            while (_read_bytes > 0) {
-                _logger->debug("Process {} bytes", readed_bytes);
-                if (!_command_to_execute)
+            ssize_t readed_bytes;
+            if (!_command_to_execute.Empty() && _arg_remains >= kDirectReadThreshold)
+            {
+                // Большое значение: все что было в буфере уже в аргументе, остальное читаем прямо в его конец.
+                // Аргумент растет по мере прихода данных, а не сразу на размер, который объявил клиент
+                std::size_t offset = _argument_for_command.size();
+                std::size_t room = ExtendForRead(_argument_for_command, _arg_remains);
+                readed_bytes = read(_socket, &_argument_for_command[offset], room);
+                _argument_for_command.resize(offset + std::max(readed_bytes, ssize_t(0)));
+                if (readed_bytes > 0)
                 {
-                    std::size_t parsed = 0;
-                    if (_parser.Parse(_client_buffer, _read_bytes, parsed))
-                    {
-                        _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
-                        _command_to_execute = _parser.Build(_arg_remains);
-                        if (_arg_remains > 0)
-                        {
-                            _arg_remains += 2;
-                        }
-                    }
-                    if (parsed == 0)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        std::memmove(_client_buffer, _client_buffer + parsed, _read_bytes - parsed);
-                        _read_bytes -= parsed;
-                    }
+                    _arg_remains -= readed_bytes;
                 }
+            }
+            else
+            {
+                readed_bytes = _input.ReadFrom(_socket);
+            }
 
-                // There is command, but we still wait for argument to arrive...
-                if (_command_to_execute && _arg_remains > 0)
-                {
-                    _logger->debug("Fill argument: {} bytes of {}", _read_bytes, _arg_remains);
-                    // There is some parsed command, and now we are reading argument
-                    std::size_t to_read = std::min(_arg_remains, std::size_t(_read_bytes));
-                    _argument_for_command.append(_client_buffer, to_read);
-
-                    std::memmove(_client_buffer, _client_buffer + to_read, _read_bytes - to_read);
-                    _arg_remains -= to_read;
-                    _read_bytes -= to_read;
-                }
+            if (readed_bytes > 0)
+            {
+                _logger->debug("Got {} bytes from socket", readed_bytes);
+                ProcessInput();
 
-                // Thre is command & argument - RUN!
-                if (_command_to_execute && _arg_remains == 0)
+                // Сокет скорее всего готов к записи, так что отвечаем сразу, не дожидаясь EPOLLOUT
+                // от следующего epoll_wait. Если не влезло - DoWrite оставит EPOLLOUT для остатка
+                if (!_output.Empty())
                 {
-                    _logger->debug("Start command execution");
+                    DoWrite();
+                }
+            }
+            else if (readed_bytes == 0)
+            {
+                _logger->debug("Connection closed");
+                _eof = true;
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            else
+            {
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+        }
+    }
+    catch (std::exception &ex)
+    {
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
 
-                    std::string result;
-                    if (_argument_for_command.size())
-                    {
-                        _argument_for_command.resize(_argument_for_command.size() - 2);
-                    }
-                    _command_to_execute->Execute(*_pStorage, _argument_for_command, result);
+        // Парсер сломан, так что отвечаем ошибкой и закрываемся, как только клиент ее получит
+        _output.Append(_parser.Error());
+        _event.events |= EPOLLOUT;
+        _eof = true;
+    }
 
+    if (_eof)
+    {
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        if (_output.Empty())
+        {
+            _is_alive = false;
+        }
+    }
+}
 
+// See Connection.h
+void Connection::ProcessInput()
+{
+    for (;;)
+    {
+        if (_command_to_execute.Empty())
+        {
+            if (_input.Empty())
+            {
+                break;
+            }
 
+            std::size_t parsed = 0;
+            if (_parser.Parse(_input.Data(), _input.Size(), parsed))
+            {
+                _logger->debug("Found new command: {} in {} bytes", _parser.Name(), parsed);
+                _parser.Build(_command_to_execute, _arg_remains);
+                if (_arg_remains > 0)
+                {
+                    _arg_remains += 2;
+                    _argument_for_command.reserve(std::min(_arg_remains, kMaxArgumentReserve));
+                }
+            }
+            _input.Consume(parsed); // Ничего не двигаем, только курсор
 
+            if (_command_to_execute.Empty())
+            {
+                continue;
+            }
+        }
 
+        // There is command, but we still wait for argument to arrive...
+        if (_arg_remains > 0)
+        {
+            _logger->debug("Fill argument: {} bytes of {}", _input.Available(), _arg_remains);
+            _arg_remains -= _input.AppendTo(_argument_for_command, _arg_remains);
+            if (_arg_remains > 0)
+            {
+                break;
+            }
+        }
 
-                    // Надо сохранить ответик
-                    result += "\r\n";
-                    _output.push_back(result); // Вкидываем в вектор ответов
+        // Thre is command & argument - RUN! Or go on with the response started before
+        _logger->debug("Start command execution");
 
-                    if (!(_event.events & EPOLLOUT))
-                    {
-                        _event.events |= EPOLLOUT;
-                    }
+        if (!_command_to_execute.HasMore() && _argument_for_command.size())
+        {
+            _argument_for_command.resize(_argument_for_command.size() - 2);
+        }
 
-                    if (_output.size() > _max_output_size)
-                    {
-                        _event.events &= ~EPOLLIN;
-                    }
+        // Большой multi-get отдаем частями: следующую достаем из хранилища, только когда сокет заберет предыдущие
+        do
+        {
+            std::string result;
+            _execute(*_pStorage, _command_to_execute, _argument_for_command, result);
 
-                    // Prepare for the next command
-                    _command_to_execute.reset();
-                    _argument_for_command.resize(0);
-                    _parser.Reset();
+            // Надо сохранить ответик, если клиент его ждет
+            if (!result.empty())
+            {
+                _output.Append(result);
+                _event.events |= EPOLLOUT;
+                if (_output.Overflown())
+                {
+                    _event.events &= ~(EPOLLIN | EPOLLRDHUP); // Иначе RDHUP будет будить нас впустую
                 }
-            } // while (_read_bytes)
-        }
+            }
+        } while (_command_to_execute.HasMore() && !_output.Overflown());
 
-        if (_read_bytes == 0)
+        if (_command_to_execute.HasMore())
         {
-            _logger->debug("Connection closed");
-        } 
-        else if(errno != EAGAIN && errno != EINTR && errno != EWOULDBLOCK)
-        {
-            throw std::runtime_error(std::string(strerror(errno)));
-        }
-    } 
-    catch (std::runtime_error &ex)
-    {
-        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
-        
-        _output.push_back("ERROR\r\n");
-        if (!(_event.events & EPOLLOUT))
-        {
-            _event.events |= EPOLLOUT;
+            break; // Продолжит DoWrite, когда очередь опустеет до low watermark
         }
-        _event.events &= ~EPOLLIN;
+
+        // Prepare for the next command
+        _command_to_execute.Reset();
+        _argument_for_command.resize(0);
+        _parser.Reset();
     }
 }
 
 // See Connection.h
-void Connection::DoWrite()
+void Connection::Continue()
 {
-   try
-   {
-    _logger->debug("DoWrite {} socket", _socket); // Запись
-    struct iovec data[_output.size()] = {};
-    size_t i = 0;
-    for (i = 0; i < _output.size(); ++i)
+    try
     {
-        data[i].iov_base = &(_output[i][0]);
-        data[i].iov_len = _output[i].size();
+        ProcessInput();
     }
-
-    data[0].iov_base = static_cast<char *>(data[0].iov_base) + _write_bytes;
-    data[0].iov_len -= _write_bytes;
-
-    int written_bytes = writev(_socket, data, i);
-	
-    
-    if( written_bytes < 0 && errno != EINTR && errno!= EAGAIN)
+    catch (std::exception &ex)
     {
-    	
-    	throw std::runtime_error(std::string(strerror(errno)));
+        _logger->error("Failed to process connection on descriptor {}: {}", _socket, ex.what());
+
+        // Как и в DoRead: отвечаем ошибкой и закрываемся
+        _output.Append(_parser.Error());
+        _event.events |= EPOLLOUT;
+        _event.events &= ~(EPOLLIN | EPOLLRDHUP);
+        _eof = true;
     }
+}
 
-    i = 0;
-    for (auto command : _output)
+// See Connection.h
+void Connection::DoWrite()
+{
+    try
     {
-        if (written_bytes >= command.size())
-        {
-            ++i;
-            written_bytes -= command.size();
-        } 
-        else 
+        _logger->debug("DoWrite {} socket", _socket); // Запись
+        std::array<struct iovec, 64> data;
+        while (!_output.Empty())
         {
-            break;
-        }
-    }
+            std::size_t count = _output.Prepare(data.data(), data.size());
+            ssize_t written_bytes = writev(_socket, data.data(), count);
+            if (written_bytes < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                else if (errno == EAGAIN || errno == EWOULDBLOCK)
+                {
+                    break;
+                }
+                throw std::runtime_error(std::string(strerror(errno)));
+            }
+            _output.Consume(written_bytes);
 
-    _output.erase(_output.begin(), _output.begin() + i);
-    _write_bytes = written_bytes;
+            // Клиент забрал почти все - достаем следующую часть ответа
+            if (_output.Drained() && _command_to_execute.HasMore())
+            {
+                Continue();
+            }
+        }
 
-    if (_output.empty())
-    {
-        _event.events &= ~EPOLLOUT;
-    }
+        if (_output.Empty())
+        {
+            _event.events &= ~EPOLLOUT;
+            if (_eof)
+            {
+                _is_alive = false; // Все ответили, клиент больше ничего не пришлет
+                return;
+            }
+        }
 
-    if (_output.size() <= 0.9 * _max_output_size)
-    {
-        _event.events |= EPOLLIN;
-    }
-    
+        if (!_eof && _output.Drained() && !_command_to_execute.HasMore())
+        {
+            _event.events |= EPOLLIN | EPOLLRDHUP;
+        }
     }
-    catch (std::runtime_error &ex)
+    catch (std::exception &ex)
     {
-    	_logger->error("Failed to write connection on descriptor {}: {}", _socket, ex.what());
-    	_is_alive = false;
+        _logger->error("Failed to write connection on descriptor {}: {}", _socket, ex.what());
+        _is_alive = false;
     }
-    
 }
 
 } // namespace STnonblock
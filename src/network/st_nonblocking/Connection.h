@@ -2,10 +2,12 @@
 #define AFINA_NETWORK_ST_NONBLOCKING_CONNECTION_H
 
 #include <cstring>
-#include <vector>
 
 #include <sys/epoll.h>
-#include <afina/execute/Command.h>
+#include <afina/execute/Variant.h>
+#include <execute/Executor.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
 #include <protocol/Parser.h>
 #include <spdlog/logger.h>
 
@@ -16,13 +18,16 @@ namespace STnonblock {
 class Connection
 {
 public:
-    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl)
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               std::size_t output_high_watermark = 1024 * 1024, std::size_t output_low_watermark = 256 * 1024)
         : _socket(s)
         , _pStorage(ps)
-        , _logger(pl) {
+        , _execute(Execute::StaticExecutor(*ps))
+        , _logger(pl)
+        , _parser(protocol)
+        , _output(output_high_watermark, output_low_watermark) {
         std::memset(&_event, 0, sizeof(struct epoll_event));
         _event.data.ptr = this;
-        std::memset(_client_buffer, 0, 4096);
     }
 
     inline bool isAlive() const { return _is_alive; }
@@ -38,26 +43,36 @@ protected:
 private:
     friend class ServerImpl;
 
+    // Выполняем все команды, которые целиком лежат во входном буфере
+    void ProcessInput();
+
+    // Достаем следующую часть недоотданного ответа и выполняем то, что во входном буфере осталось за ним
+    void Continue();
+
+    // Аргумент от стольки байт читаем из сокета сразу на место, мимо входного буфера
+    static constexpr std::size_t kDirectReadThreshold = 4096;
+
     int _socket;
     struct epoll_event _event;
 
     bool _is_alive = true; // Переменная отвечающая за то жив ли клиентский сокет вообще
+    bool _eof = false; // Клиент закрыл соединение на запись, дописываем ответы и закрываемся
 
     std::shared_ptr<Afina::Storage> _pStorage;
+    Execute::Executor _execute; // Команды исполняются без виртуальных вызовов, под конкретный тип хранилища
     std::shared_ptr<spdlog::logger> _logger; 
 
-    char _client_buffer[4096] = ""; //Клиентский буфер на 4096
-    std::size_t _read_bytes = 0;//Для чтения байтиков
-    std::size_t _write_bytes = 0; // Для записи байтиков
-    // Как во второй домашке
+    InputBuffer _input; // Прочитанные, но еще не разобранные байтики
+    // Как во второй домашке, только буфер под аргумент выделяем сразу целиком,
+    // последние _arg_remains байт в нем еще не пришли
     std::size_t _arg_remains = 0;
     Protocol::Parser _parser;
     std::string _argument_for_command;
-    std::unique_ptr<Execute::Command> _command_to_execute;
+    Execute::Variant _command_to_execute; // Команда живет прямо в соединении, без кучи
     
-    std::vector<std::string> _output; // Ответы , которые нужно отдать клиенту
-    // На лекции было предложено через deque, но мне чёт привычнее через вектор
-    std::size_t _max_output_size = 4096; //Больше чем 4096 ответ быть не может, сори
+    // Ответы, которые нужно отдать клиенту. Как только там больше high watermark байт - перестаем читать
+    // новые команды, пока очередь не опустеет до low watermark
+    OutputQueue _output;
 };
 
 } // namespace STnonblock
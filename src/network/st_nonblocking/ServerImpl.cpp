@@ -179,26 +179,16 @@ void ServerImpl::OnRun() // Поехала обработка
              { // Если есть событие, но ошибка или обрыв соединения - усё, ошибка
                 pc->OnError();
             } 
-            else if (current_event.events & EPOLLRDHUP) // На случай если отключился клиент на запись
-            {
-                _logger->debug("response-only"); // усё, только отвечаем на то, что он нам накидал
-                if (current_event.events & EPOLLOUT) // Вкинул уже что то на запись?
-                {
-                    pc->DoWrite(); // Пишем
-                }
-                else
-                {
-                    pc->OnClose(); // Ничего нет? Закрылись
-                }
-            }
             else
             {
                 // Depends on what connection wants...
-                if (current_event.events & EPOLLIN) // Хотел прочитать?
+                // Если клиент закрыл соединение на запись - дочитываем, что он успел прислать,
+                // и отвечаем. Закроется само, когда ответы уйдут
+                if (current_event.events & (EPOLLIN | EPOLLRDHUP)) // Хотел прочитать?
                 {
                     pc->DoRead(); // Читаем
                 }
-                if (current_event.events & EPOLLOUT) //Хотел записать?ы
+                if (pc->isAlive() && (current_event.events & EPOLLOUT)) //Хотел записать?ы
                 {
                     pc->DoWrite(); //Пишем
                 }
@@ -274,7 +264,7 @@ void ServerImpl::OnNewConnection(int epoll_descr){
         }
 
         // Register the new FD to be monitored by epoll.
-        Connection *pc = new(std::nothrow) Connection(infd, pStorage, _logger);
+        Connection *pc = new(std::nothrow) Connection(infd, pStorage, _logger, protocol);
         if (pc == nullptr) {
             throw std::runtime_error("Failed to allocate connection");
         }
@@ -0,0 +1,84 @@
+#ifndef AFINA_NETWORK_ST_STACKLESS_CONNECTION_H
+#define AFINA_NETWORK_ST_STACKLESS_CONNECTION_H
+
+#include <memory>
+#include <string>
+
+#include <afina/execute/Command.h>
+#include <network/InputBuffer.h>
+#include <network/OutputQueue.h>
+#include <protocol/Parser.h>
+
+#include "Reactor.h"
+#include "Task.h"
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+
+// Forward declaration, see afina/Storage.h
+class Storage;
+
+namespace Network {
+namespace STstackless {
+
+/**
+ * # Client connection served by a stackless coroutine
+ * Same loop as STcoroutine::Connection: read, execute commands that came in completely, write responses. The
+ * difference is that only the coroutine frame survives suspension, a few hundred bytes from the frame pool
+ * instead of a stack of its own.
+ */
+class Connection {
+public:
+    Connection(int s, std::shared_ptr<Afina::Storage> ps, std::shared_ptr<spdlog::logger> pl, Protocol::Type protocol,
+               Reactor &reactor)
+        : _socket(s), _pStorage(ps), _logger(pl), _reactor(reactor), _parser(protocol) {}
+
+    /**
+     * Completes once client has gone or connection failed. Socket is closed on completion
+     */
+    Task Serve();
+
+    /**
+     * Stop to read new commands, responses to commands read already are still sent. Could be called from any
+     * coroutine of the same reactor
+     */
+    void Shutdown();
+
+protected:
+    // Execute all commands that are in the input buffer completely
+    void ProcessInput();
+
+    // Write all responses, suspends coroutine until they are sent
+    Task Flush(Reactor::Handle *handle);
+
+private:
+    // Argument of that many bytes and more is read straight from the socket, bypassing input buffer
+    static constexpr std::size_t kDirectReadThreshold = 4096;
+
+    int _socket;
+
+    std::shared_ptr<Afina::Storage> _pStorage;
+    std::shared_ptr<spdlog::logger> _logger;
+    Reactor &_reactor;
+
+    // Bytes received, but not parsed yet
+    InputBuffer _input;
+
+    // Command being read, last _arg_remains bytes of its argument haven't arrived yet
+    std::size_t _arg_remains = 0;
+    Protocol::Parser _parser;
+    std::string _argument_for_command;
+    std::unique_ptr<Execute::Command> _command_to_execute;
+
+    // Responses not sent yet
+    OutputQueue _output;
+};
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_STACKLESS_CONNECTION_H
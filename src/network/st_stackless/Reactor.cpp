@@ -0,0 +1,139 @@
+#include "Reactor.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+// Events descriptor is always registered for
+static constexpr uint32_t kReadEvents = EPOLLIN | EPOLLRDHUP | EPOLLET;
+
+// See Reactor.h
+bool Reactor::Operation::Attempt() {
+    for (;;) {
+        _result = Call();
+        if (_result >= 0) {
+            return true;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+        }
+        if (errno != EINTR) {
+            _error = errno;
+            return true;
+        }
+    }
+}
+
+// See Reactor.h
+bool Reactor::Operation::await_suspend(std::coroutine_handle<> waiter) {
+    // Socket is writable almost always, so EPOLLOUT is watched only while somebody waits for it. Otherwise
+    // every ACK would wake epoll_wait up for nothing
+    if (_output) {
+        if (!_reactor.Arm(_handle, true)) {
+            _error = errno;
+            return false;
+        }
+        _armed = true;
+    }
+
+    _waiter = waiter;
+    (_output ? _handle->writer : _handle->reader) = this;
+    return true;
+}
+
+// See Reactor.h
+ssize_t Reactor::Operation::await_resume() {
+    if (_armed) {
+        _reactor.Arm(_handle, false);
+    }
+    if (_result < 0) {
+        errno = _error;
+    }
+    return _result;
+}
+
+// See Reactor.h
+Reactor::Reactor() {
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (_epoll_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+}
+
+// See Reactor.h
+Reactor::~Reactor() { close(_epoll_fd); }
+
+// See Reactor.h
+Reactor::Handle *Reactor::Register(int fd) {
+    Handle *handle = new Handle{fd, nullptr, nullptr};
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = kReadEvents;
+    event.data.ptr = handle;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        delete handle;
+        throw std::runtime_error("Failed to add file descriptor to epoll: " + std::string(strerror(errno)));
+    }
+    return handle;
+}
+
+// See Reactor.h
+void Reactor::Unregister(Handle *handle) {
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, handle->fd, nullptr);
+    delete handle;
+}
+
+// See Reactor.h
+bool Reactor::Arm(Handle *handle, bool output) {
+    struct epoll_event event;
+    std::memset(&event, 0, sizeof(event));
+    event.events = output ? kReadEvents | EPOLLOUT : kReadEvents;
+    event.data.ptr = handle;
+    return epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, handle->fd, &event) == 0;
+}
+
+// See Reactor.h
+void Reactor::Poll() {
+    std::array<struct epoll_event, 64> events;
+    int count = epoll_wait(_epoll_fd, events.data(), events.size(), -1);
+    if (count == -1) {
+        if (errno == EINTR) {
+            return;
+        }
+        throw std::runtime_error("Failed to wait for events: " + std::string(strerror(errno)));
+    }
+
+    for (int i = 0; i < count; i++) {
+        Handle *handle = static_cast<Handle *>(events[i].data.ptr);
+        uint32_t ready = events[i].events;
+
+        // Errors wake up both sides, operation gets the error itself
+        if (handle->reader != nullptr && (ready & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) &&
+            handle->reader->Attempt()) {
+            _completed.push_back(handle->reader);
+            handle->reader = nullptr;
+        }
+        if (handle->writer != nullptr && (ready & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && handle->writer->Attempt()) {
+            _completed.push_back(handle->writer);
+            handle->writer = nullptr;
+        }
+    }
+
+    for (Operation *operation : _completed) {
+        operation->_waiter.resume();
+    }
+    _completed.clear();
+}
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
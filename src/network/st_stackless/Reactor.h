@@ -0,0 +1,157 @@
+#ifndef AFINA_NETWORK_ST_STACKLESS_REACTOR_H
+#define AFINA_NETWORK_ST_STACKLESS_REACTOR_H
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+/**
+ * # Awaitable I/O for stackless coroutines on top of epoll
+ * Same idea as STcoroutine::Reactor: descriptors are registered once, edge triggered, and operation that would
+ * block parks the coroutine until epoll reports the descriptor ready. Here the reactor retries the operation
+ * itself once edge comes and resumes coroutine with the result, so a coroutine is resumed only when it has
+ * something to do.
+ *
+ * Only one operation could wait for each direction of the descriptor at a time.
+ */
+class Reactor {
+public:
+    class Operation;
+
+    /**
+     * Descriptor registered in reactor and operations waiting for it
+     */
+    struct Handle {
+        int fd;
+        Operation *reader;
+        Operation *writer;
+    };
+
+    /**
+     * # Awaitable system call
+     * Tries to complete right away, otherwise suspends coroutine until reactor completes it. Result is the
+     * same as of the system call, errno is restored on resume
+     */
+    class Operation {
+    public:
+        virtual ~Operation() {}
+
+        Operation(const Operation &) = delete;
+        Operation &operator=(const Operation &) = delete;
+
+        bool await_ready() { return Attempt(); }
+        bool await_suspend(std::coroutine_handle<> waiter);
+        ssize_t await_resume();
+
+    protected:
+        Operation(Reactor &reactor, Handle *handle, bool output)
+            : _reactor(reactor), _handle(handle), _output(output) {}
+
+        // System call itself
+        virtual ssize_t Call() = 0;
+
+    private:
+        friend class Reactor;
+
+        // Make the call, returns false if it would block
+        bool Attempt();
+
+        Reactor &_reactor;
+        Handle *const _handle;
+        const bool _output;
+
+        // EPOLLOUT is watched for the operation, see Reactor::Arm
+        bool _armed = false;
+
+        std::coroutine_handle<> _waiter;
+        ssize_t _result = -1;
+        int _error = 0;
+    };
+
+    /**
+     * Operation making arbitrary call, for example reading into a buffer of some kind
+     */
+    template <typename F> class CallOperation final : public Operation {
+    public:
+        CallOperation(Reactor &reactor, Handle *handle, bool output, F call)
+            : Operation(reactor, handle, output), _call(std::move(call)) {}
+
+    private:
+        ssize_t Call() override { return _call(); }
+
+        F _call;
+    };
+
+    Reactor();
+    ~Reactor();
+
+    Reactor(const Reactor &) = delete;
+    Reactor &operator=(const Reactor &) = delete;
+
+    /**
+     * Start to track non-blocking descriptor, throws std::runtime_error on failure
+     */
+    Handle *Register(int fd);
+
+    /**
+     * Stop to track descriptor, must be called before it gets closed. Nobody could wait for it at that moment
+     */
+    void Unregister(Handle *handle);
+
+    /**
+     * Awaitable call that fails with EAGAIN when descriptor isn't ready for input or output. Whatever call
+     * refers to must stay valid until operation completes
+     */
+    template <typename F> CallOperation<F> AsyncCall(Handle *handle, bool output, F call) {
+        return CallOperation<F>(*this, handle, output, std::move(call));
+    }
+
+    /**
+     * Awaitable read/writev/accept4. Buffers must stay valid until operation completes. Accepted descriptor is
+     * non-blocking already
+     */
+    auto AsyncRead(Handle *handle, void *buffer, std::size_t size) {
+        return AsyncCall(handle, false, [handle, buffer, size] { return read(handle->fd, buffer, size); });
+    }
+    auto AsyncWritev(Handle *handle, const struct iovec *iov, int iovcnt) {
+        return AsyncCall(handle, true, [handle, iov, iovcnt] { return writev(handle->fd, iov, iovcnt); });
+    }
+    auto AsyncAccept(Handle *handle, struct sockaddr *addr, socklen_t *addrlen) {
+        return AsyncCall(handle, false, [handle, addr, addrlen]() -> ssize_t {
+            return accept4(handle->fd, addr, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        });
+    }
+
+    /**
+     * Wait for events, complete operations that have been waiting for them and resume their coroutines
+     */
+    void Poll();
+
+private:
+    // Watch EPOLLOUT or stop to, returns false on failure
+    bool Arm(Handle *handle, bool output);
+
+    // EPOLL descriptor using for events processing
+    int _epoll_fd;
+
+    // Operations completed by the current Poll, coroutines are resumed once all events are processed: resumed
+    // coroutine could unregister descriptor another event is about
+    std::vector<Operation *> _completed;
+};
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_STACKLESS_REACTOR_H
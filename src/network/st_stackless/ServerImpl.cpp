@@ -0,0 +1,187 @@
+#include "ServerImpl.h"
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <spdlog/logger.h>
+
+#include <afina/Storage.h>
+#include <afina/logging/Service.h>
+
+#include "Connection.h"
+#include "Reactor.h"
+#include "Task.h"
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+// See Server.h
+ServerImpl::ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl) : Server(ps, pl) {}
+
+// See Server.h
+ServerImpl::~ServerImpl() {}
+
+// See Server.h
+void ServerImpl::Start(uint16_t port, uint32_t n_acceptors, uint32_t n_workers) {
+    _logger = pLogging->select("network");
+    _logger->info("Start st_stackless network service");
+
+    sigset_t sig_mask;
+    sigemptyset(&sig_mask);
+    sigaddset(&sig_mask, SIGPIPE);
+    if (pthread_sigmask(SIG_BLOCK, &sig_mask, NULL) != 0) {
+        throw std::runtime_error("Unable to mask SIGPIPE");
+    }
+
+    // Create server socket
+    struct sockaddr_in server_addr;
+    std::memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sin_family = AF_INET;         // IPv4
+    server_addr.sin_port = htons(port);       // TCP port number
+    server_addr.sin_addr.s_addr = INADDR_ANY; // Bind to any address
+
+    _server_socket = socket(PF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_TCP);
+    if (_server_socket == -1) {
+        throw std::runtime_error("Failed to open socket: " + std::string(strerror(errno)));
+    }
+
+    int opts = 1;
+    if (setsockopt(_server_socket, SOL_SOCKET, (SO_KEEPALIVE), &opts, sizeof(opts)) == -1 ||
+        setsockopt(_server_socket, SOL_SOCKET, SO_REUSEADDR, &opts, sizeof(opts)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket setsockopt() failed: " + std::string(strerror(errno)));
+    }
+
+    if (bind(_server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket bind() failed: " + std::string(strerror(errno)));
+    }
+
+    if (listen(_server_socket, 128) == -1) {
+        close(_server_socket);
+        throw std::runtime_error("Socket listen() failed: " + std::string(strerror(errno)));
+    }
+
+    _event_fd = eventfd(0, EFD_NONBLOCK);
+    if (_event_fd == -1) {
+        throw std::runtime_error("Failed to create epoll file descriptor: " + std::string(strerror(errno)));
+    }
+
+    _work_thread = std::thread(&ServerImpl::OnRun, this);
+}
+
+// See Server.h
+void ServerImpl::Stop() {
+    _logger->warn("Stop network service");
+
+    // Wakeup coroutine waiting for the stop signal
+    if (eventfd_write(_event_fd, 1)) {
+        throw std::runtime_error("Failed to wakeup workers");
+    }
+}
+
+// See Server.h
+void ServerImpl::Join() {
+    // Wait for work to be complete
+    if (_work_thread.joinable()) {
+        _work_thread.join();
+    }
+}
+
+// See ServerImpl.h
+void ServerImpl::OnRun() {
+    _logger->info("Start acceptor");
+
+    Reactor reactor;
+    _reactor = &reactor;
+
+    // Coroutines run till the first suspension right away, the rest is driven by reactor
+    OnAccept(*this);
+    OnStop(*this);
+    while (_coroutines > 0) {
+        reactor.Poll();
+    }
+
+    _reactor = nullptr;
+    close(_server_socket);
+    close(_event_fd);
+    _logger->warn("Acceptor stopped");
+}
+
+// See ServerImpl.h
+Detached ServerImpl::OnAccept(ServerImpl &server) {
+    server._coroutines++;
+    Reactor::Handle *listener = server._reactor->Register(server._server_socket);
+
+    for (;;) {
+        struct sockaddr in_addr;
+        socklen_t in_len = sizeof in_addr;
+        int infd = co_await server._reactor->AsyncAccept(listener, &in_addr, &in_len);
+        if (infd == -1) {
+            if (server._stopping) {
+                break;
+            } else if (errno == ECONNABORTED || errno == EPROTO) {
+                continue;
+            }
+            server._logger->error("Failed to accept socket: {}", strerror(errno));
+            break;
+        }
+
+        // Print host and service info.
+        char hbuf[NI_MAXHOST], sbuf[NI_MAXSERV];
+        int retval =
+            getnameinfo(&in_addr, in_len, hbuf, sizeof hbuf, sbuf, sizeof sbuf, NI_NUMERICHOST | NI_NUMERICSERV);
+        if (retval == 0) {
+            server._logger->info("Accepted connection on descriptor {} (host={}, port={})\n", infd, hbuf, sbuf);
+        }
+
+        Connection *pc = new Connection(infd, server.pStorage, server._logger, server.protocol, *server._reactor);
+        server._connections.insert(pc);
+        OnConnection(server, pc);
+    }
+
+    server._reactor->Unregister(listener);
+    server._coroutines--;
+}
+
+// See ServerImpl.h
+Detached ServerImpl::OnStop(ServerImpl &server) {
+    server._coroutines++;
+    Reactor::Handle *handle = server._reactor->Register(server._event_fd);
+    eventfd_t value;
+    co_await server._reactor->AsyncRead(handle, &value, sizeof(value));
+    server._reactor->Unregister(handle);
+
+    // Acceptor gets an error once socket is shut down, connections get EOF and leave once responses are sent
+    server._logger->debug("Stop signal received");
+    server._stopping = true;
+    shutdown(server._server_socket, SHUT_RDWR);
+    for (auto pc : server._connections) {
+        pc->Shutdown();
+    }
+    server._coroutines--;
+}
+
+// See ServerImpl.h
+Detached ServerImpl::OnConnection(ServerImpl &server, Connection *connection) {
+    server._coroutines++;
+    co_await connection->Serve();
+    server._connections.erase(connection);
+    delete connection;
+    server._coroutines--;
+}
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,94 @@
+#ifndef AFINA_NETWORK_ST_STACKLESS_SERVER_H
+#define AFINA_NETWORK_ST_STACKLESS_SERVER_H
+
+#include <set>
+#include <thread>
+
+#include <afina/network/Server.h>
+
+namespace spdlog {
+class logger;
+}
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+// Forward declaration, see Connection.h
+class Connection;
+class Reactor;
+struct Detached;
+
+/**
+ * # Network resource manager implementation
+ * Same as STcoroutine, but on C++20 stackless coroutines: acceptor, every connection and stop signal are
+ * coroutines awaiting I/O operations of the Reactor, the thread polls reactor while any of them is alive.
+ *
+ * The backend is built as C++20, so this header must stay C++11: it is included by the rest of the tree.
+ */
+class ServerImpl : public Server {
+public:
+    ServerImpl(std::shared_ptr<Afina::Storage> ps, std::shared_ptr<Logging::Service> pl);
+    ~ServerImpl();
+
+    // See Server.h
+    void Start(uint16_t port, uint32_t acceptors, uint32_t workers) override;
+
+    // See Server.h
+    void Stop() override;
+
+    // See Server.h
+    void Join() override;
+
+protected:
+    /**
+     * Method executing by background thread
+     */
+    void OnRun();
+
+    /**
+     * Coroutine accepting connections and starting coroutine for each one until server is stopped
+     */
+    static Detached OnAccept(ServerImpl &server);
+
+    /**
+     * Coroutine waiting for stop signal: closes listening socket and makes connections finish
+     */
+    static Detached OnStop(ServerImpl &server);
+
+    /**
+     * Coroutine serving a single connection
+     */
+    static Detached OnConnection(ServerImpl &server, Connection *connection);
+
+private:
+    // logger to use
+    std::shared_ptr<spdlog::logger> _logger;
+
+    // Socket to accept new connection on
+    int _server_socket;
+
+    // Curstom event "device" used to signal stop
+    int _event_fd;
+
+    // IO thread
+    std::thread _work_thread;
+
+    // Reactor of the IO thread, valid while it runs
+    Reactor *_reactor = nullptr;
+
+    // Coroutines not completed yet, accessed by IO thread only
+    std::size_t _coroutines = 0;
+
+    // Set once stop signal is received, accessed by IO thread only
+    bool _stopping = false;
+
+    // Connections being served, accessed by IO thread only
+    std::set<Connection *> _connections;
+};
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_STACKLESS_SERVER_H
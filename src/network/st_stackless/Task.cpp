@@ -0,0 +1,55 @@
+#include "Task.h"
+
+#include <new>
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+// See Task.h
+thread_local FramePool::Lists FramePool::_lists;
+
+// See Task.h
+FramePool::Lists::~Lists() {
+    for (std::size_t i = 0; i < kClasses; i++) {
+        while (head[i] != nullptr) {
+            Node *node = head[i];
+            head[i] = node->next;
+            ::operator delete(node);
+        }
+    }
+}
+
+// See Task.h
+void *FramePool::Allocate(std::size_t size) {
+    std::size_t index = (size + kGranularity - 1) / kGranularity - 1;
+    if (index >= kClasses) {
+        return ::operator new(size);
+    }
+
+    Node *node = _lists.head[index];
+    if (node == nullptr) {
+        return ::operator new((index + 1) * kGranularity);
+    }
+    _lists.head[index] = node->next;
+    _lists.count[index]--;
+    return node;
+}
+
+// See Task.h
+void FramePool::Release(void *frame, std::size_t size) noexcept {
+    std::size_t index = (size + kGranularity - 1) / kGranularity - 1;
+    if (index >= kClasses || _lists.count[index] >= kMaxFree) {
+        ::operator delete(frame);
+        return;
+    }
+
+    Node *node = static_cast<Node *>(frame);
+    node->next = _lists.head[index];
+    _lists.head[index] = node;
+    _lists.count[index]++;
+}
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
@@ -0,0 +1,125 @@
+#ifndef AFINA_NETWORK_ST_STACKLESS_TASK_H
+#define AFINA_NETWORK_ST_STACKLESS_TASK_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+namespace Afina {
+namespace Network {
+namespace STstackless {
+
+/**
+ * # Per thread pool of coroutine frames
+ * Frames of the same coroutine function are all of the same size, so pool keeps free lists per size class:
+ * connection coming after another one has gone reuses its frames without malloc. Large frames go to the heap
+ */
+class FramePool {
+public:
+    static void *Allocate(std::size_t size);
+    static void Release(void *frame, std::size_t size) noexcept;
+
+private:
+    // Sizes are rounded up to the granularity, classes cover frames up to kGranularity * kClasses bytes
+    static constexpr std::size_t kGranularity = 64;
+    static constexpr std::size_t kClasses = 64;
+
+    // Free frames kept per class, the rest is returned to the heap
+    static constexpr std::size_t kMaxFree = 1024;
+
+    struct Node {
+        Node *next;
+    };
+
+    struct Lists {
+        ~Lists();
+
+        Node *head[kClasses] = {};
+        std::size_t count[kClasses] = {};
+    };
+
+    static thread_local Lists _lists;
+};
+
+/**
+ * Coroutine frames are allocated from the pool of the thread
+ */
+struct PooledPromise {
+    static void *operator new(std::size_t size) { return FramePool::Allocate(size); }
+    static void operator delete(void *frame, std::size_t size) noexcept { FramePool::Release(frame, size); }
+};
+
+/**
+ * # Lazy coroutine
+ * Starts once awaited and resumes awaiting coroutine on completion, exception escaping the body is rethrown
+ * there
+ */
+class Task {
+public:
+    struct promise_type : PooledPromise {
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> self) noexcept {
+                return self.promise().continuation;
+            }
+            void await_resume() noexcept {}
+        };
+
+        Task get_return_object() noexcept { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+    };
+
+    Task(Task &&other) noexcept : _handle(std::exchange(other._handle, nullptr)) {}
+    ~Task() {
+        if (_handle) {
+            _handle.destroy();
+        }
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        _handle.promise().continuation = awaiting;
+        return _handle;
+    }
+    void await_resume() {
+        if (_handle.promise().exception) {
+            std::rethrow_exception(_handle.promise().exception);
+        }
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+
+    std::coroutine_handle<promise_type> _handle;
+};
+
+/**
+ * # Fire and forget coroutine
+ * Starts right away and frees its frame once the body completes. Exception escaping the body terminates the
+ * program
+ */
+struct Detached {
+    struct promise_type : PooledPromise {
+        Detached get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace STstackless
+} // namespace Network
+} // namespace Afina
+
+#endif // AFINA_NETWORK_ST_STACKLESS_TASK_H
@@ -1,24 +1,224 @@
 #include "Parser.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include <afina/execute/Add.h>
 #include <afina/execute/Append.h>
+#include <afina/execute/Binary.h>
 #include <afina/execute/Command.h>
 #include <afina/execute/Delete.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Meta.h>
+#include <afina/execute/Prepend.h>
+#include <afina/execute/Replace.h>
+#include <afina/execute/Resp.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Variant.h>
 
 namespace Afina {
 namespace Protocol {
 
+constexpr std::size_t Parser::kMaxItemSize;
+
+// Longest number fast path converts, anything longer goes to the state machine
+static constexpr std::size_t kMaxDigits = 16;
+
+// Byte repeated in every lane of the word
+static constexpr uint64_t Broadcast(uint8_t c) { return 0x0101010101010101ull * c; }
+
+// Highest bit is set in lanes of the word that are zero. Borrow could mark lane above the zero one as well, but
+// never below it, so the lowest bit set is always the right one
+static inline uint64_t ZeroBytes(uint64_t word) { return (word - Broadcast(1)) & ~word & Broadcast(0x80); }
+
+// First space or \r in between begin and end, end if there is none
+static const char *FindDelimiter(const char *begin, const char *end) {
+    const char *p = begin;
+#if defined(__SSE2__)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, cr)));
+        if (mask != 0) {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; end - p >= 8; p += 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        uint64_t mask = ZeroBytes(word ^ Broadcast(' ')) | ZeroBytes(word ^ Broadcast('\r'));
+        if (mask != 0) {
+            return p + (__builtin_ctzll(mask) >> 3);
+        }
+    }
+#endif
+    while (p < end && *p != ' ' && *p != '\r') {
+        p++;
+    }
+    return p;
+}
+
+// Convert up to 8 decimal digits at once, false if there is anything else
+static bool ParseDigits8(const char *p, std::size_t n, uint64_t &value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    // The first digit is the lowest byte, missing ones turn into leading zeros
+    uint64_t word = Broadcast('0');
+    std::memcpy(reinterpret_cast<char *>(&word) + (8 - n), p, n);
+    if ((word & Broadcast(0xF0)) != Broadcast(0x30) ||
+        ((word + Broadcast(0x06)) & Broadcast(0xF0)) != Broadcast(0x30)) {
+        return false;
+    }
+
+    // Combine neighbour digits into pairs, pairs into quads and quads into the result
+    word = ((word & Broadcast(0x0F)) * 2561) >> 8;
+    word = ((word & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    value = ((word & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+    return true;
+#else
+    value = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (p[i] < '0' || p[i] > '9') {
+            return false;
+        }
+        value = value * 10 + (p[i] - '0');
+    }
+    return true;
+#endif
+}
+
+// Convert non-empty decimal of at most kMaxDigits digits
+static bool ParseDigits(const char *p, std::size_t n, uint64_t &value) {
+    if (n == 0 || n > kMaxDigits) {
+        return false;
+    } else if (n <= 8) {
+        return ParseDigits8(p, n, value);
+    }
+
+    uint64_t high, low;
+    if (!ParseDigits8(p, n - 8, high) || !ParseDigits8(p + n - 8, 8, low)) {
+        return false;
+    }
+    value = high * 100000000 + low;
+    return true;
+}
+
+// Number starting at begin and terminated by the delimiter, returns pointer to the delimiter or nullptr
+static const char *ParseNumber(const char *begin, const char *end, char delimiter, uint64_t &value) {
+    const char *stop = FindDelimiter(begin, end);
+    if (stop == end || *stop != delimiter || !ParseDigits(begin, stop - begin, value)) {
+        return nullptr;
+    }
+    return stop;
+}
+
+// Meta set has data length right after the key, command gets the key and flags only
+static size_t TakeDataLength(std::vector<std::string> &tokens) {
+    uint64_t size;
+    if (tokens.size() < 2 || !ParseDigits(tokens[1].data(), tokens[1].size(), size) ||
+        size > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Invalid data length of meta set");
+    }
+    tokens.erase(tokens.begin() + 1);
+    return size;
+}
+
+// Delete has the key and optional noreply
+static bool TakeNoreply(std::vector<std::string> &tokens) {
+    bool noreply = tokens.size() == 2 && tokens[1] == "noreply";
+    if (noreply) {
+        tokens.pop_back();
+    }
+    if (tokens.size() != 1) {
+        throw std::runtime_error("Invalid arguments of delete");
+    }
+    return noreply;
+}
+
+// Command name packed into integer: characters from the lowest byte up, length in the highest one
+static constexpr uint64_t Token(const char *name, size_t i = 0) {
+    return name[i] == '\0' ? uint64_t(i) << 56 : (uint64_t(uint8_t(name[i])) << (8 * i)) | Token(name, i + 1);
+}
+
+// See Parse.h
+Parser::Kind Parser::Lookup(const char *name, size_t size) {
+    if (size == 0 || size >= sizeof(uint64_t)) {
+        return Kind::cUnknown;
+    }
+
+    uint64_t token = uint64_t(size) << 56;
+    for (size_t i = 0; i < size; i++) {
+        token |= uint64_t(uint8_t(name[i])) << (8 * i);
+    }
+
+    switch (token) {
+    case Token("set"):
+        return Kind::cSet;
+    case Token("add"):
+        return Kind::cAdd;
+    case Token("append"):
+        return Kind::cAppend;
+    case Token("prepend"):
+        return Kind::cPrepend;
+    case Token("replace"):
+        return Kind::cReplace;
+    case Token("delete"):
+        return Kind::cDelete;
+    case Token("get"):
+        return Kind::cGet;
+    case Token("gets"):
+        return Kind::cGets;
+    case Token("stats"):
+        return Kind::cStats;
+    case Token("mg"):
+        return Kind::cMetaGet;
+    case Token("ms"):
+        return Kind::cMetaSet;
+    case Token("md"):
+        return Kind::cMetaDelete;
+    case Token("ma"):
+        return Kind::cMetaArithmetic;
+    case Token("mn"):
+        return Kind::cMetaNoop;
+    default:
+        return Kind::cUnknown;
+    }
+}
+
 // See Parse.h
 bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
     size_t pos;
     parsed = 0;
+    if (protocol == Type::Resp) {
+        return ParseResp(input, size, parsed);
+    }
+
+    // Text command can't start with the magic byte, so the first byte tells protocol of the request
+    if (state == State::sName && name.empty() && size > 0 && uint8_t(input[0]) == Execute::Binary::kRequestMagic) {
+        state = State::sbPacket;
+    }
+    if (state == State::sbPacket) {
+        return ParsePacket(input, size, parsed);
+    }
+
+    // Whole line is there in the most cases, nothing to remember in between calls then
+    if (state == State::sName && name.empty()) {
+        if (ParseLine(input, size, parsed)) {
+            return true;
+        }
+        Reset();
+    }
 
     for (pos = 0; pos < size && !parse_complete; pos++) {
         char c = input[pos];
@@ -28,11 +228,12 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
         case State::sName: {
             if (c == ' ' || c == '\r') {
                 // std::cout << "parser debug: name='" << name << "'" << std::endl;
-                if (name == "set" || name == "add" || name == "append" || name == "prepend") {
+                kind = Lookup(name.data(), name.size());
+                if (IsStorage(kind)) {
                     state = State::spKey;
-                } else if (name == "get" || name == "gets") {
+                } else if (kind == Kind::cGet || kind == Kind::cGets || kind == Kind::cDelete || IsMeta(kind)) {
                     state = State::sgKey;
-                } else if (name == "stats") {
+                } else if (kind == Kind::cStats || kind == Kind::cMetaNoop) {
                     state = State::sLF;
                     continue;
                 } else {
@@ -83,9 +284,8 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spExprTimeStart;
                 // std::cout << "parser debug: flags='" << flags << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                uint32_t f = (flags * 10) + (c - '0');
-                if (f < flags) {
-                    // Overflow
+                uint64_t f = uint64_t(flags) * 10 + (c - '0');
+                if (f > std::numeric_limits<uint32_t>::max()) {
                     throw std::runtime_error("Flags field overflow");
                 }
                 flags = f;
@@ -109,17 +309,9 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
                 state = State::spBytes;
                 // std::cout << "parser debug: ExprTime='" << exprtime << "'" << std::endl;
             } else if (c >= '0' && c <= '9') {
-                int32_t et = exprtime;
-                if (negative) {
-                    et -= (c - '0');
-                    if (et > exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
-                } else {
-                    et += (c - '0');
-                    if (et < exprtime) {
-                        throw std::runtime_error("Expire time field overflow");
-                    }
+                int64_t et = int64_t(exprtime) * 10 + (negative ? -(c - '0') : (c - '0'));
+                if (et < std::numeric_limits<int32_t>::min() || et > std::numeric_limits<int32_t>::max()) {
+                    throw std::runtime_error("Expire time field overflow");
                 }
                 exprtime = et;
             }
@@ -130,17 +322,30 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
             if (c == '\r') {
                 state = State::sLF;
                 // std::cout << "parser debug: bytes='" << bytes << "'" << std::endl;
+            } else if (c == ' ') {
+                curKey.clear();
+                state = State::spNoreply;
             } else if (c >= '0' && c <= '9') {
-                uint32_t b = (bytes * 10) + (c - '0');
-                if (b < bytes) {
-                    // Overflow
-                    throw std::runtime_error("Bytes field overflow");
-                }
+                uint64_t b = uint64_t(bytes) * 10 + (c - '0');
+                CheckItemSize(b);
                 bytes = b;
             }
             break;
         }
 
+        case State::spNoreply: {
+            if (c == '\r') {
+                if (curKey != "noreply") {
+                    throw std::runtime_error("Unexpected parameter: " + curKey);
+                }
+                noreply = true;
+                state = State::sLF;
+            } else {
+                curKey.push_back(c);
+            }
+            break;
+        }
+
         case State::sLF: {
             if (c == '\n') {
                 parse_complete = true;
@@ -162,37 +367,341 @@ bool Parser::Parse(const char *input, const size_t size, size_t &parsed) {
 }
 
 // See Parse.h
-std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) const {
+bool Parser::ParseLine(const char *input, const size_t size, size_t &parsed) {
+    const char *end = input + size;
+    const char *stop = FindDelimiter(input, end);
+    if (stop == end) {
+        return false;
+    }
+    name.assign(input, stop);
+    kind = Lookup(input, stop - input);
+
+    if (IsStorage(kind)) {
+        // <key> <flags> <exptime> <bytes> [noreply]\r\n
+        const char *key = stop + 1;
+        if (*stop != ' ' || (stop = FindDelimiter(key, end)) == end || *stop != ' ' || stop == key) {
+            return false;
+        }
+        keys.emplace_back(key, stop);
+
+        uint64_t value;
+        const uint64_t max = std::numeric_limits<uint32_t>::max();
+        if ((stop = ParseNumber(stop + 1, end, ' ', value)) == nullptr || value > max) {
+            return false;
+        }
+        flags = value;
+
+        bool minus = stop + 1 < end && stop[1] == '-';
+        if ((stop = ParseNumber(stop + 1 + minus, end, ' ', value)) == nullptr ||
+            value > uint64_t(std::numeric_limits<int32_t>::max()) + minus) {
+            return false;
+        }
+        exprtime = minus ? int32_t(-int64_t(value)) : int32_t(value);
+
+        const char *number = stop + 1;
+        if ((stop = FindDelimiter(number, end)) == end || !ParseDigits(number, stop - number, value) ||
+            value > kMaxItemSize) {
+            return false;
+        }
+        bytes = value;
+
+        if (*stop == ' ') {
+            if (end - stop < 9 || std::memcmp(stop, " noreply\r", 9) != 0) {
+                return false;
+            }
+            noreply = true;
+            stop += 8;
+        }
+    } else if (kind == Kind::cGet || kind == Kind::cGets || kind == Kind::cDelete || IsMeta(kind)) {
+        // <key>*\r\n
+        while (*stop == ' ') {
+            const char *key = stop + 1;
+            if ((stop = FindDelimiter(key, end)) == end || stop == key) {
+                return false;
+            }
+            keys.emplace_back(key, stop);
+        }
+        if (keys.empty()) {
+            return false;
+        }
+    } else if ((kind != Kind::cStats && kind != Kind::cMetaNoop) || *stop != '\r') {
+        return false;
+    }
+
+    if (end - stop < 2 || stop[1] != '\n') {
+        return false;
+    }
+    state = State::sLF;
+    parse_complete = true;
+    parsed = stop + 2 - input;
+    return true;
+}
+
+// See Parse.h
+bool Parser::ParsePacket(const char *input, const size_t size, size_t &parsed) {
+    while (parsed < size) {
+        size_t need = Execute::Binary::kHeaderSize;
+        if (packet.size() >= need) {
+            need = Execute::Binary::PacketSize(packet.data());
+        }
+        if (packet.size() == need) {
+            break;
+        }
+
+        size_t chunk = std::min(need - packet.size(), size - parsed);
+        packet.append(input + parsed, chunk);
+        parsed += chunk;
+
+        // Key and extras must fit into the body, the rest is value and it is limited as in text requests
+        if (packet.size() == Execute::Binary::kHeaderSize) {
+            size_t key = (uint8_t(packet[2]) << 8) | uint8_t(packet[3]);
+            size_t headers = Execute::Binary::kHeaderSize + uint8_t(packet[4]) + key;
+            size_t total = Execute::Binary::PacketSize(packet.data());
+            if (headers > total) {
+                throw std::runtime_error("Binary request key and extras exceed body length");
+            } else if (total - headers > kMaxItemSize) {
+                farewell = Execute::Binary::Response(packet.data(), Execute::Binary::sValueTooLarge, "Too large");
+                CheckItemSize(total - headers);
+            }
+        }
+    }
+
+    if (packet.size() < Execute::Binary::kHeaderSize || packet.size() < Execute::Binary::PacketSize(packet.data())) {
+        return false;
+    }
+
+    // Connection is closed after quit, the same way as after error
+    uint8_t opcode = packet[1];
+    if (opcode == Execute::Binary::oQuit || opcode == Execute::Binary::oQuitQ) {
+        if (opcode == Execute::Binary::oQuit) {
+            farewell = Execute::Binary::Response(packet.data(), Execute::Binary::sSuccess, "");
+        }
+        throw std::runtime_error("Binary quit request");
+    }
+    kind = Kind::cBinary;
+    state = State::sLF;
+    parse_complete = true;
+    return true;
+}
+
+// See Parse.h
+bool Parser::ParseResp(const char *input, const size_t size, size_t &parsed) {
+    while (parsed < size) {
+        if (state == State::srData) {
+            // Bulk string is followed by CRLF, it goes along with data
+            size_t chunk = std::min(size_t(bytes) + 2 - curKey.size(), size - parsed);
+            curKey.append(input + parsed, chunk);
+            parsed += chunk;
+            if (curKey.size() < size_t(bytes) + 2) {
+                return false;
+            } else if (curKey[bytes] != '\r' || curKey[bytes + 1] != '\n') {
+                throw std::runtime_error("Protocol error: bulk string must be terminated with CRLF");
+            }
+
+            keys.emplace_back(curKey, 0, bytes);
+            curKey.clear();
+            state = State::srLine;
+            if (keys.size() == items) {
+                break;
+            }
+            continue;
+        }
+
+        // Header lines are short, so the whole line is collected first
+        const char *begin = input + parsed;
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', size - parsed));
+        size_t chunk = newline == nullptr ? size - parsed : newline - begin + 1;
+        curKey.append(begin, chunk);
+        parsed += chunk;
+        if (newline == nullptr) {
+            if (curKey.size() > kMaxDigits + 3) {
+                throw std::runtime_error("Protocol error: too long header line");
+            }
+            return false;
+        }
+
+        // *<items>\r\n or $<bytes>\r\n
+        uint64_t value;
+        char type = items == 0 ? '*' : '$';
+        if (curKey.size() < 4 || curKey[0] != type || curKey[curKey.size() - 2] != '\r' ||
+            !ParseDigits(curKey.data() + 1, curKey.size() - 3, value) || value > std::numeric_limits<int32_t>::max() ||
+            (type == '*' && value == 0)) {
+            throw std::runtime_error(std::string("Protocol error: expected '") + type + "'");
+        }
+        curKey.clear();
+
+        if (type == '*') {
+            items = value;
+            state = State::srLine;
+        } else {
+            bytes = value;
+            state = State::srData;
+        }
+    }
+
+    if (items == 0 || keys.size() < items) {
+        return false;
+    }
+    name = keys[0];
+    kind = Kind::cResp;
+    bytes = 0;
+    state = State::sLF;
+    parse_complete = true;
+    return true;
+}
+
+// See Parse.h
+void Parser::CheckItemSize(uint64_t size) {
+    if (size > kMaxItemSize) {
+        too_large = true;
+        throw std::runtime_error("Data block is too large: " + std::to_string(size) + " bytes");
+    }
+}
+
+// See Parse.h
+const std::string &Parser::Error() const {
+    static const std::string memcached("ERROR\r\n");
+    static const std::string too_large_item("SERVER_ERROR object too large for cache\r\n");
+    static const std::string resp("-ERR Protocol error\r\n");
+    if (protocol == Type::Resp) {
+        return resp;
+    } else if (!packet.empty()) {
+        // Binary client can't make sense of text, it gets either response packet or nothing
+        return farewell;
+    }
+    return too_large ? too_large_item : memcached;
+}
+
+// See Parse.h
+std::unique_ptr<Execute::Command> Parser::Build(size_t &body_size) {
     if (state != State::sLF) {
         return std::unique_ptr<Execute::Command>(nullptr);
     }
 
     body_size = bytes;
-    if (name == "set") {
-        return std::unique_ptr<Execute::Command>(new Execute::Set(keys[0], flags, exprtime));
-    } else if (name == "add") {
-        return std::unique_ptr<Execute::Command>(new Execute::Add(keys[0], flags, exprtime));
-    } else if (name == "append") {
-        return std::unique_ptr<Execute::Command>(new Execute::Append(keys[0], flags, exprtime));
-    } else if (name == "get") {
-        return std::unique_ptr<Execute::Command>(new Execute::Get(keys));
-    } else if (name == "stats") {
+    switch (kind) {
+    case Kind::cSet:
+        return std::unique_ptr<Execute::Command>(new Execute::Set(std::move(keys[0]), flags, exprtime, noreply));
+    case Kind::cAdd:
+        return std::unique_ptr<Execute::Command>(new Execute::Add(std::move(keys[0]), flags, exprtime, noreply));
+    case Kind::cAppend:
+        return std::unique_ptr<Execute::Command>(new Execute::Append(std::move(keys[0]), flags, exprtime, noreply));
+    case Kind::cPrepend:
+        return std::unique_ptr<Execute::Command>(new Execute::Prepend(std::move(keys[0]), flags, exprtime, noreply));
+    case Kind::cReplace:
+        return std::unique_ptr<Execute::Command>(new Execute::Replace(std::move(keys[0]), flags, exprtime, noreply));
+    case Kind::cDelete:
+        noreply = TakeNoreply(keys);
+        return std::unique_ptr<Execute::Command>(new Execute::Delete(std::move(keys[0]), noreply));
+    case Kind::cGet:
+    case Kind::cGets:
+        // There is no CAS in storage, so gets answers the same as get
+        return std::unique_ptr<Execute::Command>(new Execute::Get(std::move(keys)));
+    case Kind::cStats:
         return std::unique_ptr<Execute::Command>(new Execute::Stats());
-    } else {
+    case Kind::cMetaGet:
+        return std::unique_ptr<Execute::Command>(new Execute::Meta('g', std::move(keys)));
+    case Kind::cMetaSet:
+        body_size = TakeDataLength(keys);
+        CheckItemSize(body_size);
+        return std::unique_ptr<Execute::Command>(new Execute::Meta('s', std::move(keys)));
+    case Kind::cMetaDelete:
+        return std::unique_ptr<Execute::Command>(new Execute::Meta('d', std::move(keys)));
+    case Kind::cMetaArithmetic:
+        return std::unique_ptr<Execute::Command>(new Execute::Meta('a', std::move(keys)));
+    case Kind::cMetaNoop:
+        return std::unique_ptr<Execute::Command>(new Execute::Meta('n', std::vector<std::string>()));
+    case Kind::cBinary:
+        return std::unique_ptr<Execute::Command>(new Execute::Binary(packet));
+    case Kind::cResp:
+        return std::unique_ptr<Execute::Command>(new Execute::Resp(std::move(keys)));
+    default:
         throw std::runtime_error("Unsupported command");
     }
 }
 
+// See Parse.h
+bool Parser::Build(Execute::Variant &command, size_t &body_size) {
+    if (state != State::sLF) {
+        return false;
+    }
+
+    body_size = bytes;
+    switch (kind) {
+    case Kind::cSet:
+        command.Emplace<Execute::Set>(std::move(keys[0]), flags, exprtime, noreply);
+        break;
+    case Kind::cAdd:
+        command.Emplace<Execute::Add>(std::move(keys[0]), flags, exprtime, noreply);
+        break;
+    case Kind::cAppend:
+        command.Emplace<Execute::Append>(std::move(keys[0]), flags, exprtime, noreply);
+        break;
+    case Kind::cPrepend:
+        command.Emplace<Execute::Prepend>(std::move(keys[0]), flags, exprtime, noreply);
+        break;
+    case Kind::cReplace:
+        command.Emplace<Execute::Replace>(std::move(keys[0]), flags, exprtime, noreply);
+        break;
+    case Kind::cDelete:
+        noreply = TakeNoreply(keys);
+        command.Emplace<Execute::Delete>(std::move(keys[0]), noreply);
+        break;
+    case Kind::cGet:
+    case Kind::cGets:
+        command.Emplace<Execute::Get>(std::move(keys));
+        break;
+    case Kind::cStats:
+        command.Emplace<Execute::Stats>();
+        break;
+    case Kind::cMetaGet:
+        command.Emplace<Execute::Meta>('g', std::move(keys));
+        break;
+    case Kind::cMetaSet:
+        body_size = TakeDataLength(keys);
+        CheckItemSize(body_size);
+        command.Emplace<Execute::Meta>('s', std::move(keys));
+        break;
+    case Kind::cMetaDelete:
+        command.Emplace<Execute::Meta>('d', std::move(keys));
+        break;
+    case Kind::cMetaArithmetic:
+        command.Emplace<Execute::Meta>('a', std::move(keys));
+        break;
+    case Kind::cMetaNoop:
+        command.Emplace<Execute::Meta>('n', std::vector<std::string>());
+        break;
+    case Kind::cBinary:
+        command.Emplace<Execute::Binary>(packet);
+        break;
+    case Kind::cResp:
+        command.Emplace<Execute::Resp>(std::move(keys));
+        break;
+    default:
+        throw std::runtime_error("Unsupported command");
+    }
+    return true;
+}
+
 // See Parse.h
 void Parser::Reset() {
     state = State::sName;
     name.clear();
+    kind = Kind::cUnknown;
     keys.clear();
+    if (keys.capacity() == 0) {
+        keys = Execute::Get::SpareKeys();
+    }
     curKey.clear();
+    packet.clear();
+    farewell.clear();
+    items = 0;
     parse_complete = false;
     flags = 0;
     bytes = 0;
     exprtime = 0;
+    noreply = false;
+    too_large = false;
 }
 
 } // namespace Protocol
@@ -8,19 +8,35 @@
 #include <cstddef>
 #include <cstdint>
 
+#include <afina/network/Server.h>
+
 namespace Afina {
 namespace Execute {
 class Command;
+class Variant;
 } // namespace Execute
 namespace Protocol {
 
 /**
  * # Memcached protocol parser
- * Parser supports subset of memcached protocol
+ * Parser supports subset of memcached protocol. Command line that is all in the input is parsed in one go, the
+ * one split in between several reads goes through the state machine byte by byte. Meta commands are parsed the
+ * same way as get: key and flags are collected as a list of tokens and interpreted by Execute::Meta. Delete is a
+ * list of tokens too, its key is optionally followed by noreply.
+ *
+ * Request starting with the binary protocol magic byte is a binary one, it is collected as a whole packet and
+ * built into Execute::Binary with no data block to follow: value is a part of the packet. Quit request and the
+ * one with value over kMaxItemSize fail to parse, Error() is the binary response to them then.
+ *
+ * Parser created for Redis protocol expects arrays of bulk strings instead, they are built into Execute::Resp
+ * with no data block to follow as well
  */
 class Parser {
 public:
-    Parser() { Reset(); }
+    // Largest data block client could send along with the command, memcached default
+    static constexpr std::size_t kMaxItemSize = 1024 * 1024;
+
+    explicit Parser(Type protocol = Type::Memcached) : protocol(protocol) { Reset(); }
     /**
      * Push given string into parser input. Method returns true if it was a command parsed out
      * from comulative input. In a such case method Build will return new command
@@ -44,9 +60,15 @@ public:
 
     /**
      * Builds new command from parsed input. In case if it wasn't enough input to prse command out
-     * method return nullptr
+     * method return nullptr. Keys are moved into the command, so it could be built once per parsed input
+     */
+    std::unique_ptr<Execute::Command> Build(size_t &body_size);
+
+    /**
+     * Same as above, but command is constructed in place of the given variant. Returns false if there is no
+     * command parsed out yet
      */
-    std::unique_ptr<Execute::Command> Build(size_t &body_size) const;
+    bool Build(Execute::Variant &command, size_t &body_size);
 
     /**
      * Reset parse so that it could be used to parse out new command
@@ -55,20 +77,112 @@ public:
 
     inline const std::string &Name() const { return name; }
 
+    /**
+     * Response to send once Parse has failed, before connection gets closed. Empty if binary client gets nothing
+     */
+    const std::string &Error() const;
+
 private:
     /**
      * State of the command parser. Prefixes are:
      * - s: state for PUT and GET commands
      * - sp: for PUT commands only
      * - sg: for GET commands only
+     * - sb: for binary protocol requests
+     * - sr: for Redis protocol requests
+     */
+    enum State : uint16_t {
+        sCR,
+        sLF,
+        sName,
+        spKey,
+        spFlags,
+        spExprTimeStart,
+        spExprTime,
+        spBytes,
+        spNoreply,
+        sgKey,
+        sbPacket,
+        srLine,
+        srData
+    };
+
+    // Command the name stands for
+    enum Kind : uint8_t {
+        cUnknown,
+        cSet,
+        cAdd,
+        cAppend,
+        cPrepend,
+        cReplace,
+        cDelete,
+        cGet,
+        cGets,
+        cStats,
+        cMetaGet,
+        cMetaSet,
+        cMetaDelete,
+        cMetaArithmetic,
+        cMetaNoop,
+        cBinary,
+        cResp
+    };
+
+    /**
+     * Find command by name. Names are at most 7 characters long, so name packed into integer along with its
+     * length is a perfect hash and lookup is a single switch
+     */
+    static Kind Lookup(const char *name, size_t size);
+
+    /**
+     * Storage command followed by data block
      */
-    enum State : uint16_t { sCR, sLF, sName, spKey, spFlags, spExprTimeStart, spExprTime, spBytes, sgKey };
+    static bool IsStorage(Kind kind) {
+        return kind == Kind::cSet || kind == Kind::cAdd || kind == Kind::cAppend || kind == Kind::cPrepend ||
+               kind == Kind::cReplace;
+    }
+
+    /**
+     * Meta command taking key and flags
+     */
+    static bool IsMeta(Kind kind) {
+        return kind == Kind::cMetaGet || kind == Kind::cMetaSet || kind == Kind::cMetaDelete ||
+               kind == Kind::cMetaArithmetic;
+    }
+
+    /**
+     * Reject data block longer than kMaxItemSize before anyone allocates memory for it
+     */
+    void CheckItemSize(uint64_t size);
+
+    /**
+     * Fast path for the command line that is all in the input: cut it into fields with vector search of
+     * delimiters and convert numbers several digits at once. Returns false if line is incomplete or doesn't look
+     * like a well formed one, state machine takes it from the start then and reports errors if any
+     */
+    bool ParseLine(const char *input, const size_t size, size_t &parsed);
+
+    /**
+     * Collect binary request: header first, then as much of the body as it says. Returns true once packet is
+     * complete
+     */
+    bool ParsePacket(const char *input, const size_t size, size_t &parsed);
+
+    /**
+     * Collect Redis protocol request: array header line, then length line and data of every bulk string. Data is
+     * copied by length, so it could contain anything. Returns true once all the strings are there
+     */
+    bool ParseResp(const char *input, const size_t size, size_t &parsed);
+
+    // Protocol requests are parsed in
+    const Type protocol;
 
     // Current parser state
     State state;
 
     // vrious fields of the command
     std::string name;
+    Kind kind;
     std::vector<std::string> keys;
 
     // <flags> is an arbitrary 16-bit unsigned integer (written out in decimal) that the server stores along with
@@ -88,9 +202,24 @@ private:
     // it's followed by an empty data block).
     uint32_t bytes;
 
+    // The optional "noreply" parameter instructs the server to not send the reply
+    bool noreply;
+
+    // Parse failed because of the data block size, not the syntax
+    bool too_large;
+
     bool negative;
     std::string curKey;
     bool parse_complete;
+
+    // Binary request collected so far
+    std::string packet;
+
+    // Binary response to send before connection is closed, if the binary request can't be served
+    std::string farewell;
+
+    // Number of bulk strings in the Redis protocol request, zero until its header is parsed
+    uint32_t items;
 };
 
 } // namespace Protocol
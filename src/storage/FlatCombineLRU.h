@@ -0,0 +1,65 @@
+#ifndef AFINA_STORAGE_FLAT_COMBINE_LRU_H
+#define AFINA_STORAGE_FLAT_COMBINE_LRU_H
+
+#include <exception>
+#include <string>
+
+#include <afina/Storage.h>
+#include <afina/concurrency/FlatCombine.h>
+
+#include "SimpleLRU.h"
+
+namespace Afina {
+namespace Backend {
+
+/**
+ * # SimpleLRU shared through flat combining
+ * Same as ThreadSafeSimplLRU, but under contention operations are applied in batches by a single thread instead
+ * of every thread taking the lock in turn, see Concurrency::FlatCombine
+ */
+class FlatCombineLRU : public Afina::Storage {
+public:
+    FlatCombineLRU(size_t max_size = 1024);
+    ~FlatCombineLRU() {}
+
+    // Implements Afina::Storage interface
+    bool Put(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool PutIfAbsent(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Set(const std::string &key, const std::string &value) override;
+
+    // Implements Afina::Storage interface
+    bool Delete(const std::string &key) override;
+
+    // Implements Afina::Storage interface
+    bool Get(const std::string &key, std::string &value) override;
+
+private:
+    // Published operation, lives on the caller stack until combiner is done with it
+    struct Operation {
+        enum class Type { kPut, kPutIfAbsent, kSet, kDelete, kGet };
+
+        Type type;
+        const std::string *key;
+        const std::string *value;
+        std::string *out;
+
+        bool result;
+        std::exception_ptr error;
+    };
+
+    bool Perform(Operation::Type type, const std::string &key, const std::string *value, std::string *out);
+
+    void Apply(Operation *const *batch, std::size_t size);
+
+    SimpleLRU _storage;
+    Afina::Concurrency::FlatCombine<Operation> _combiner;
+};
+
+} // namespace Backend
+} // namespace Afina
+
+#endif // AFINA_STORAGE_FLAT_COMBINE_LRU_H
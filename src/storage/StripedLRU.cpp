@@ -23,5 +23,16 @@ bool StripedLRU::Get(const std::string &key, std::string &value) {
     return MyStripes[MyStripesHash(key) % CountOfStripes]->Get(key, value);
 }
 
+void StripedLRU::Stats(std::vector<std::pair<std::string, uint64_t>> &stats) {
+    std::vector<std::pair<std::string, uint64_t>> stripe_stats;
+    for (size_t i = 0; i < CountOfStripes; i++) {
+        stripe_stats.clear();
+        MyStripes[i]->Stats(stripe_stats);
+        for (auto &stat : stripe_stats) {
+            stats.emplace_back("stripe_" + std::to_string(i) + "_" + stat.first, stat.second);
+        }
+    }
+}
+
 } // namespace Backend
 } // namespace Afina
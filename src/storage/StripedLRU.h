@@ -54,6 +54,9 @@ public:
 
     bool Get(const std::string &key, std::string &value) override;
 
+    // Counters of every stripe, prefixed with stripe_<N>_
+    void Stats(std::vector<std::pair<std::string, uint64_t>> &stats) override;
+
 private:
     std::vector<std::unique_ptr<ThreadSafeSimplLRU>> MyStripes;
     std::hash <std::string> MyStripesHash;
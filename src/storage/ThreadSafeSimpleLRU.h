@@ -5,6 +5,8 @@
 #include <mutex>
 #include <string>
 
+#include <afina/concurrency/AdaptiveLock.h>
+
 #include "SimpleLRU.h"
 
 namespace Afina {
@@ -23,41 +25,49 @@ public:
     // see SimpleLRU.h
     bool Put(const std::string &key, const std::string &value) override {
         // sinchronization
-        std::lock_guard<std::mutex> _lock(m);
+        std::lock_guard<Afina::Concurrency::AdaptiveLock> _lock(m);
         return SimpleLRU::Put(key, value);
     }
 
     // see SimpleLRU.h
     bool PutIfAbsent(const std::string &key, const std::string &value) override {
         // sinchronization
-        std::lock_guard<std::mutex> _lock(m);
+        std::lock_guard<Afina::Concurrency::AdaptiveLock> _lock(m);
         return SimpleLRU::PutIfAbsent(key, value);
     }
 
     // see SimpleLRU.h
     bool Set(const std::string &key, const std::string &value) override {
         // sinchronization
-        std::lock_guard<std::mutex> _lock(m);
+        std::lock_guard<Afina::Concurrency::AdaptiveLock> _lock(m);
         return SimpleLRU::Set(key, value);
     }
 
     // see SimpleLRU.h
     bool Delete(const std::string &key) override {
         // sinchronization
-        std::lock_guard<std::mutex> _lock(m);
+        std::lock_guard<Afina::Concurrency::AdaptiveLock> _lock(m);
         return SimpleLRU::Delete(key);
     }
 
     // see SimpleLRU.h
     bool Get(const std::string &key, std::string &value) override {
         // sinchronization
-        std::lock_guard<std::mutex> _lock(m);
+        std::lock_guard<Afina::Concurrency::AdaptiveLock> _lock(m);
         return SimpleLRU::Get(key, value);
     }
 
+    // Lock counters: how hot the lock is
+    void Stats(std::vector<std::pair<std::string, uint64_t>> &stats) override {
+        Afina::Concurrency::AdaptiveLock::Stats lock = m.GetStats();
+        stats.emplace_back("lock_acquisitions", lock.acquisitions);
+        stats.emplace_back("lock_contended", lock.contended);
+        stats.emplace_back("lock_wait_us", lock.wait_ns / 1000);
+    }
+
 private:
-    std::mutex m;
-    // sinchronization primitives
+    // sinchronization primitives, critical sections are short so waiter spins a bit before going to sleep
+    Afina::Concurrency::AdaptiveLock m;
 };
 
 } // namespace Backend
@@ -0,0 +1,75 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/AdaptiveLock.h>
+
+using namespace Afina::Concurrency;
+
+TEST(AdaptiveLockTest, Uncontended) {
+    AdaptiveLock lock;
+    lock.lock();
+    EXPECT_FALSE(lock.try_lock());
+    lock.unlock();
+
+    EXPECT_TRUE(lock.try_lock());
+    lock.unlock();
+
+    AdaptiveLock::Stats stats = lock.GetStats();
+    EXPECT_EQ(2, stats.acquisitions);
+    EXPECT_EQ(0, stats.contended);
+    EXPECT_EQ(0, stats.wait_ns);
+}
+
+TEST(AdaptiveLockTest, Contended) {
+    AdaptiveLock lock;
+    std::atomic<bool> waiting(false);
+
+    lock.lock();
+    std::thread waiter([&lock, &waiting] {
+        waiting = true;
+        std::lock_guard<AdaptiveLock> guard(lock);
+    });
+
+    // Make sure waiter has to park
+    while (!waiting.load()) {
+        std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    lock.unlock();
+    waiter.join();
+
+    AdaptiveLock::Stats stats = lock.GetStats();
+    EXPECT_EQ(2, stats.acquisitions);
+    EXPECT_EQ(1, stats.contended);
+    EXPECT_GE(stats.wait_ns, 10 * 1000 * 1000);
+}
+
+TEST(AdaptiveLockTest, MutualExclusion) {
+    const int kThreads = 8, kIterations = 50000;
+    AdaptiveLock lock;
+    uint64_t counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&lock, &counter] {
+            for (int i = 0; i < kIterations; i++) {
+                std::lock_guard<AdaptiveLock> guard(lock);
+                counter++;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(uint64_t(kThreads) * kIterations, counter);
+    AdaptiveLock::Stats stats = lock.GetStats();
+    EXPECT_EQ(uint64_t(kThreads) * kIterations, stats.acquisitions);
+    EXPECT_LE(stats.contended, stats.acquisitions);
+}
@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/Epoch.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+// Object that reports its destruction and lets readers detect use after free: memory is never returned to
+// the allocator during the test, destructor only marks it dead
+struct Node {
+    static constexpr uint64_t kAlive = 0x600DF00D600DF00Dull;
+    static constexpr uint64_t kDead = 0xDEADBEEFDEADBEEFull;
+
+    std::atomic<uint64_t> canary;
+    uint64_t value;
+};
+
+std::atomic<uint64_t> freed(0);
+
+void Kill(void *ptr) {
+    static_cast<Node *>(ptr)->canary.store(Node::kDead);
+    freed.fetch_add(1);
+}
+
+} // namespace
+
+TEST(EpochTest, DeferredUntilReaderLeaves) {
+    EpochDomain domain;
+    freed = 0;
+
+    Node node{{Node::kAlive}, 1};
+    std::atomic<int> stage(0);
+    std::thread reader([&domain, &stage] {
+        EpochGuard guard(domain);
+        stage = 1;
+        while (stage.load() != 2) {
+            std::this_thread::yield();
+        }
+    });
+    while (stage.load() != 1) {
+        std::this_thread::yield();
+    }
+
+    // Reader is inside since before retire, so object must survive any number of collections
+    domain.Retire(&node, &Kill);
+    for (int i = 0; i < 10; i++) {
+        domain.Collect();
+    }
+    EXPECT_EQ(0, freed.load());
+    EXPECT_EQ(1, domain.Pending());
+
+    stage = 2;
+    reader.join();
+    domain.Collect();
+    domain.Collect();
+    EXPECT_EQ(1, freed.load());
+    EXPECT_EQ(0, domain.Pending());
+}
+
+TEST(EpochTest, Nested) {
+    EpochDomain domain;
+    freed = 0;
+
+    Node node{{Node::kAlive}, 1};
+    domain.Enter();
+    domain.Enter();
+    domain.Leave();
+
+    // Still inside the outer section
+    domain.Retire(&node, &Kill);
+    std::thread([&domain] {
+        for (int i = 0; i < 10; i++) {
+            domain.Collect();
+        }
+    }).join();
+    domain.Collect();
+    EXPECT_EQ(0, freed.load());
+
+    domain.Leave();
+    domain.Collect();
+    domain.Collect();
+    EXPECT_EQ(1, freed.load());
+}
+
+TEST(EpochTest, FreedOnDestruction) {
+    freed = 0;
+    std::vector<Node> nodes(10);
+    {
+        EpochDomain domain;
+        EpochGuard guard(domain);
+        for (auto &node : nodes) {
+            node.canary = Node::kAlive;
+            domain.Retire(&node, &Kill);
+        }
+        EXPECT_EQ(0, freed.load());
+    }
+    EXPECT_EQ(10, freed.load());
+}
+
+TEST(EpochTest, Stress) {
+    const int kReaders = 4, kWriters = 2, kUpdates = 20000;
+    freed = 0;
+
+    // Nodes are preallocated, so "freed" memory stays valid to read canary from
+    std::vector<Node> nodes(kWriters * kUpdates + 1);
+    for (auto &node : nodes) {
+        node.canary = Node::kAlive;
+    }
+
+    std::atomic<bool> use_after_free(false);
+    {
+        EpochDomain domain;
+        std::atomic<Node *> current(&nodes[0]);
+        std::atomic<int> writers_done(0);
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < kReaders; r++) {
+            threads.emplace_back([&] {
+                while (writers_done.load() < kWriters) {
+                    EpochGuard guard(domain);
+                    Node *node = current.load(std::memory_order_acquire);
+                    for (int i = 0; i < 16; i++) {
+                        if (node->canary.load(std::memory_order_relaxed) != Node::kAlive) {
+                            use_after_free = true;
+                        }
+                    }
+                }
+            });
+        }
+
+        for (int w = 0; w < kWriters; w++) {
+            threads.emplace_back([&, w] {
+                for (int i = 0; i < kUpdates; i++) {
+                    Node *fresh = &nodes[1 + w * kUpdates + i];
+                    Node *old = current.exchange(fresh);
+                    domain.Retire(old, &Kill);
+
+                    // Reader preempted inside critical section holds frees back, let it go on a single CPU
+                    if (i % 256 == 0) {
+                        std::this_thread::yield();
+                    }
+                }
+                writers_done.fetch_add(1);
+            });
+        }
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        // Everything but the current node is retired, most of it should be freed already
+        EXPECT_GT(freed.load(), 0);
+    }
+
+    EXPECT_FALSE(use_after_free.load());
+    EXPECT_EQ(uint64_t(kWriters) * kUpdates, freed.load());
+}
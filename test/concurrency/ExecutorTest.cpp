@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <afina/concurrency/Executor.h>
+
+using namespace Afina::Concurrency;
+
+// Tasks block on it until test lets them go
+class Gate {
+public:
+    void Wait() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _waiting++;
+        _cv.notify_all();
+        _cv.wait(lock, [this] { return _open; });
+    }
+
+    void AwaitWaiting(std::size_t count) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _cv.wait(lock, [this, count] { return _waiting >= count; });
+    }
+
+    void Open() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _open = true;
+        _cv.notify_all();
+    }
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::size_t _waiting = 0;
+    bool _open = false;
+};
+
+// Poll condition for a while, pool shrinks asynchronously
+template <typename F> static bool Eventually(F condition) {
+    for (int i = 0; i < 200; i++) {
+        if (condition()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return condition();
+}
+
+TEST(ExecutorTest, ExecuteAll) {
+    std::atomic<int> counter(0);
+    {
+        Executor executor("test", 2, 4, 1000, std::chrono::milliseconds(100));
+        for (int i = 0; i < 1000; i++) {
+            ASSERT_TRUE(executor.Execute([&counter](int add) { counter += add; }, 1));
+        }
+        executor.Stop(true);
+        EXPECT_FALSE(executor.Execute([&counter] { counter++; }));
+    }
+    EXPECT_EQ(1000, counter.load());
+}
+
+TEST(ExecutorTest, GrowAndShrink) {
+    Executor executor("test", 1, 3, 10, std::chrono::milliseconds(50));
+    EXPECT_EQ(1, executor.Threads());
+
+    Gate gate;
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(executor.Execute([&gate] { gate.Wait(); }));
+    }
+    gate.AwaitWaiting(3);
+    EXPECT_EQ(3, executor.Threads());
+    EXPECT_EQ(0, executor.FreeThreads());
+
+    // High watermark reached, task waits in the queue
+    ASSERT_TRUE(executor.Execute([] {}));
+    EXPECT_EQ(3, executor.Threads());
+    EXPECT_EQ(1, executor.Queued());
+
+    gate.Open();
+    EXPECT_TRUE(Eventually([&executor] { return executor.Threads() == 1; }));
+    EXPECT_EQ(0, executor.Queued());
+}
+
+TEST(ExecutorTest, RejectAbort) {
+    Executor executor("test", 1, 1, 2, std::chrono::milliseconds(1000));
+
+    Gate gate;
+    ASSERT_TRUE(executor.Execute([&gate] { gate.Wait(); }));
+    gate.AwaitWaiting(1);
+
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_TRUE(executor.Execute([] {}));
+    EXPECT_FALSE(executor.Execute([] {}));
+    EXPECT_EQ(2, executor.Queued());
+
+    gate.Open();
+}
+
+TEST(ExecutorTest, RejectCallerRuns) {
+    Executor executor("test", 1, 1, 1, std::chrono::milliseconds(1000), Executor::RejectPolicy::kCallerRuns);
+
+    Gate gate;
+    ASSERT_TRUE(executor.Execute([&gate] { gate.Wait(); }));
+    gate.AwaitWaiting(1);
+    ASSERT_TRUE(executor.Execute([] {}));
+
+    std::thread::id runner;
+    EXPECT_TRUE(executor.Execute([&runner] { runner = std::this_thread::get_id(); }));
+    EXPECT_EQ(std::this_thread::get_id(), runner);
+
+    gate.Open();
+}
+
+TEST(ExecutorTest, StopCompletesQueued) {
+    std::atomic<int> counter(0);
+    Executor executor("test", 1, 1, 10, std::chrono::milliseconds(1000));
+
+    Gate gate;
+    ASSERT_TRUE(executor.Execute([&gate] { gate.Wait(); }));
+    gate.AwaitWaiting(1);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(executor.Execute([&counter] { counter++; }));
+    }
+
+    executor.Stop();
+    EXPECT_FALSE(executor.Execute([&counter] { counter++; }));
+
+    gate.Open();
+    executor.Stop(true);
+    EXPECT_EQ(5, counter.load());
+    EXPECT_EQ(0, executor.Threads());
+}
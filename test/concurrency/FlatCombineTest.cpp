@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/FlatCombine.h>
+
+using namespace Afina::Concurrency;
+
+namespace {
+
+struct Increment {
+    uint64_t by;
+    uint64_t result;
+};
+
+} // namespace
+
+TEST(FlatCombineTest, Single) {
+    uint64_t counter = 0;
+    std::size_t batches = 0;
+    FlatCombine<Increment> combine([&counter, &batches](Increment *const *batch, std::size_t size) {
+        batches++;
+        for (std::size_t i = 0; i < size; i++) {
+            counter += batch[i]->by;
+            batch[i]->result = counter;
+        }
+    });
+
+    Increment op{5, 0};
+    combine.Execute(op);
+    EXPECT_EQ(5, op.result);
+
+    op.by = 2;
+    combine.Execute(op);
+    EXPECT_EQ(7, op.result);
+    EXPECT_EQ(2, batches);
+}
+
+TEST(FlatCombineTest, Concurrent) {
+    // Apply is never called concurrently, so plain counter is safe
+    uint64_t counter = 0;
+    std::atomic<int> inside(0);
+    std::atomic<bool> overlapped(false);
+    FlatCombine<Increment> combine([&](Increment *const *batch, std::size_t size) {
+        if (inside.fetch_add(1) != 0) {
+            overlapped = true;
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            counter += batch[i]->by;
+            batch[i]->result = counter;
+        }
+        inside.fetch_sub(1);
+    });
+
+    const int kThreads = 8, kOperations = 20000;
+    std::atomic<bool> ordered(true);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&] {
+            uint64_t last = 0;
+            for (int i = 0; i < kOperations; i++) {
+                Increment op{1, 0};
+                combine.Execute(op);
+
+                // Every operation must see the effect of all previous ones of the same thread
+                if (op.result <= last) {
+                    ordered = false;
+                }
+                last = op.result;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(overlapped.load());
+    EXPECT_TRUE(ordered.load());
+    EXPECT_EQ(uint64_t(kThreads) * kOperations, counter);
+}
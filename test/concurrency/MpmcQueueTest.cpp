@@ -0,0 +1,186 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/MpmcQueue.h>
+
+using namespace Afina::Concurrency;
+
+TEST(MpmcQueueTest, Bounded) {
+    MpmcQueue<int> queue(3);
+    EXPECT_EQ(4, queue.Capacity());
+    EXPECT_TRUE(queue.Empty());
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.Push(i));
+    }
+    EXPECT_FALSE(queue.Push(4));
+
+    int value = -1;
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.Push(4));
+
+    for (int i = 1; i < 5; i++) {
+        EXPECT_TRUE(queue.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MpmcQueueTest, MoveOnly) {
+    MpmcQueue<std::unique_ptr<int>> queue(2);
+    std::unique_ptr<int> input(new int(7));
+    EXPECT_TRUE(queue.Push(std::move(input)));
+    EXPECT_TRUE(queue.Push(std::unique_ptr<int>(new int(8))));
+
+    // Failed push must not steal the value
+    std::unique_ptr<int> rejected(new int(9));
+    EXPECT_FALSE(queue.Push(std::move(rejected)));
+    ASSERT_TRUE(rejected != nullptr);
+
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(queue.Pop(value));
+    ASSERT_TRUE(value != nullptr);
+    EXPECT_EQ(7, *value);
+}
+
+TEST(MpmcQueueTest, Batch) {
+    MpmcQueue<int> queue(8);
+
+    int input[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(5, queue.PushBatch(input, 5));
+    EXPECT_EQ(3, queue.PushBatch(input + 5, 5));
+    EXPECT_EQ(0, queue.PushBatch(input + 8, 2));
+
+    int output[10] = {};
+    EXPECT_EQ(4, queue.PopBatch(output, 4));
+    EXPECT_EQ(2, queue.PushBatch(input + 8, 2));
+    EXPECT_EQ(6, queue.PopBatch(output + 4, 10));
+    EXPECT_EQ(0, queue.PopBatch(output, 1));
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, output[i]);
+    }
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MpmcQueueTest, Concurrent) {
+    const int kThreads = 4;
+    const uint64_t kCount = 100000;
+    MpmcQueue<uint64_t> queue(64);
+
+    // Every value must be popped exactly once, values of each producer in order
+    std::vector<std::vector<uint64_t>> last(kThreads, std::vector<uint64_t>(kThreads, 0));
+    std::atomic<uint64_t> popped(0), sum(0);
+    std::atomic<bool> ordered(true);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.emplace_back([&queue, t, kCount] {
+            uint64_t batch[8];
+            for (uint64_t i = 1; i <= kCount;) {
+                std::size_t count = 0;
+                for (; count < 8 && i + count <= kCount; count++) {
+                    batch[count] = (i + count) * kThreads + t;
+                }
+
+                // Mix single and batch operations
+                std::size_t pushed = (i % 3 == 0) ? queue.PushBatch(batch, count) : queue.Push(batch[0]) ? 1 : 0;
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+        threads.emplace_back([&queue, &last, &popped, &sum, &ordered, t, kCount] {
+            uint64_t batch[8];
+            while (popped.load() < kThreads * kCount) {
+                std::size_t count = queue.PopBatch(batch, 1 + popped.load(std::memory_order_relaxed) % 8);
+                if (count == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (std::size_t i = 0; i < count; i++) {
+                    uint64_t producer = batch[i] % kThreads, seq = batch[i] / kThreads;
+                    if (seq <= last[t][producer]) {
+                        ordered = false;
+                    }
+                    last[t][producer] = seq;
+                    sum += batch[i];
+                }
+                popped += count;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    uint64_t expected = 0;
+    for (int t = 0; t < kThreads; t++) {
+        expected += kThreads * kCount * (kCount + 1) / 2 + t * kCount;
+    }
+    EXPECT_EQ(kThreads * kCount, popped.load());
+    EXPECT_EQ(expected, sum.load());
+    EXPECT_TRUE(ordered.load());
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(MpmcQueueTest, Blocking) {
+    const int kThreads = 3;
+    const uint64_t kCount = 20000;
+    MpmcQueue<uint64_t> queue(4);
+
+    std::atomic<uint64_t> popped(0), sum(0);
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < kThreads; t++) {
+        consumers.emplace_back([&queue, &popped, &sum] {
+            uint64_t value;
+            while (queue.BlockingPop(value)) {
+                sum += value;
+                popped++;
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; t++) {
+        producers.emplace_back([&queue, kCount] {
+            for (uint64_t i = 1; i <= kCount; i++) {
+                EXPECT_TRUE(queue.BlockingPush(std::move(i)));
+            }
+        });
+    }
+    for (auto &thread : producers) {
+        thread.join();
+    }
+
+    // Consumers drain the rest and exit
+    queue.Close();
+    for (auto &thread : consumers) {
+        thread.join();
+    }
+
+    EXPECT_EQ(kThreads * kCount, popped.load());
+    EXPECT_EQ(kThreads * kCount * (kCount + 1) / 2, sum.load());
+    EXPECT_FALSE(queue.BlockingPush(1));
+}
+
+TEST(MpmcQueueTest, CloseWakesWaiters) {
+    MpmcQueue<int> queue(2);
+
+    std::thread consumer([&queue] {
+        int value;
+        EXPECT_FALSE(queue.BlockingPop(value));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.Close();
+    consumer.join();
+}
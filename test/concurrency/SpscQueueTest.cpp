@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include <afina/concurrency/SpscQueue.h>
+
+using namespace Afina::Concurrency;
+
+TEST(SpscQueueTest, Bounded) {
+    SpscQueue<int> queue(3);
+    EXPECT_EQ(4, queue.Capacity());
+    EXPECT_TRUE(queue.Empty());
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(queue.Push(i));
+    }
+    EXPECT_FALSE(queue.Push(4));
+
+    int value = -1;
+    EXPECT_TRUE(queue.Pop(value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(queue.Push(4));
+
+    for (int i = 1; i < 5; i++) {
+        EXPECT_TRUE(queue.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(queue.Pop(value));
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueueTest, MoveOnly) {
+    SpscQueue<std::unique_ptr<int>> queue(2);
+    EXPECT_TRUE(queue.Push(std::unique_ptr<int>(new int(7))));
+
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(queue.Pop(value));
+    ASSERT_TRUE(value != nullptr);
+    EXPECT_EQ(7, *value);
+}
+
+TEST(SpscQueueTest, Concurrent) {
+    const uint64_t kCount = 1000000;
+    SpscQueue<uint64_t> queue(64);
+
+    std::thread producer([&queue, kCount] {
+        for (uint64_t i = 0; i < kCount; i++) {
+            while (!queue.Push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // Values must come in order, none lost or duplicated
+    bool ordered = true;
+    for (uint64_t expected = 0; expected < kCount;) {
+        uint64_t value;
+        if (!queue.Pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ordered = ordered && value == expected;
+        expected++;
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue.Empty());
+}
+
+TEST(SpscQueueTest, Batch) {
+    SpscQueue<int> queue(8);
+
+    int input[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    EXPECT_EQ(5, queue.PushBatch(input, 5));
+    EXPECT_EQ(3, queue.PushBatch(input + 5, 5));
+    EXPECT_EQ(0, queue.PushBatch(input + 8, 2));
+
+    int output[10] = {};
+    EXPECT_EQ(4, queue.PopBatch(output, 4));
+    EXPECT_EQ(2, queue.PushBatch(input + 8, 2));
+    EXPECT_EQ(6, queue.PopBatch(output + 4, 10));
+    EXPECT_EQ(0, queue.PopBatch(output, 1));
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, output[i]);
+    }
+    EXPECT_TRUE(queue.Empty());
+}
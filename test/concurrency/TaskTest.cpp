@@ -0,0 +1,118 @@
+#include "gtest/gtest.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+
+#include <afina/concurrency/Task.h>
+
+using namespace Afina::Concurrency;
+
+// Counts live instances to check nothing leaks or gets destroyed twice
+struct Tracked {
+    static int alive;
+
+    Tracked(int &calls) : calls(&calls) { alive++; }
+    Tracked(const Tracked &other) : calls(other.calls) { alive++; }
+    Tracked(Tracked &&other) noexcept : calls(other.calls) { alive++; }
+    ~Tracked() { alive--; }
+
+    void operator()() { (*calls)++; }
+
+    int *calls;
+};
+
+int Tracked::alive = 0;
+
+// Doesn't fit into the task
+struct Large : Tracked {
+    Large(int &calls) : Tracked(calls) {}
+
+    std::array<char, Task::kInlineSize + 1> payload;
+};
+
+TEST(TaskTest, Empty) {
+    Task task;
+    EXPECT_FALSE(task);
+    EXPECT_EQ(64, sizeof(Task));
+}
+
+TEST(TaskTest, Inline) {
+    int calls = 0;
+    {
+        Task task{Tracked(calls)};
+        EXPECT_TRUE(task);
+        EXPECT_EQ(1, Tracked::alive);
+
+        task();
+        task();
+        EXPECT_EQ(2, calls);
+
+        Task moved(std::move(task));
+        EXPECT_FALSE(task);
+        EXPECT_EQ(1, Tracked::alive);
+
+        moved();
+        EXPECT_EQ(3, calls);
+    }
+    EXPECT_EQ(0, Tracked::alive);
+}
+
+TEST(TaskTest, Heap) {
+    int calls = 0;
+    {
+        Task task{Large(calls)};
+        EXPECT_EQ(1, Tracked::alive);
+
+        Task other;
+        other = std::move(task);
+        EXPECT_FALSE(task);
+        EXPECT_EQ(1, Tracked::alive);
+
+        other();
+        EXPECT_EQ(1, calls);
+
+        other.Reset();
+        EXPECT_FALSE(other);
+        EXPECT_EQ(0, Tracked::alive);
+    }
+    EXPECT_EQ(0, Tracked::alive);
+}
+
+TEST(TaskTest, Assign) {
+    int first = 0, second = 0;
+    {
+        Task task{Tracked(first)};
+        Task other{Large(second)};
+        task = std::move(other);
+        EXPECT_EQ(1, Tracked::alive);
+
+        task();
+        EXPECT_EQ(0, first);
+        EXPECT_EQ(1, second);
+    }
+    EXPECT_EQ(0, Tracked::alive);
+}
+
+// Move only state is fine, unlike std::function
+struct Owner {
+    void operator()() { (*value)++; }
+    std::unique_ptr<int> value;
+};
+
+TEST(TaskTest, MoveOnly) {
+    Owner owner;
+    owner.value.reset(new int(41));
+    int *value = owner.value.get();
+
+    Task task(std::move(owner));
+    task();
+    EXPECT_EQ(42, *value);
+}
+
+TEST(TaskTest, Bind) {
+    int result = 0;
+    Task task(std::bind([&result](int a, int b) { result = a + b; }, 40, 2));
+    task();
+    EXPECT_EQ(42, result);
+}
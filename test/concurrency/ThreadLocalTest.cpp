@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/CoreLocal.h>
+#include <afina/concurrency/ThreadLocal.h>
+
+using namespace Afina::Concurrency;
+
+TEST(ThreadLocalTest, PerThread) {
+    ThreadLocal<int> value([](int &v) { v = 10; });
+    EXPECT_EQ(10, value.Get());
+    *value = 1;
+
+    std::thread([&value] {
+        EXPECT_EQ(10, *value);
+        *value = 2;
+        EXPECT_EQ(2, *value);
+    }).join();
+
+    EXPECT_EQ(1, *value);
+}
+
+TEST(ThreadLocalTest, Padded) {
+    ThreadLocal<char> value;
+    char *mine = &value.Get();
+    char *other = nullptr;
+    std::thread([&value, &other] { other = &value.Get(); }).join();
+
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(mine) % kCacheLineSize);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(other) % kCacheLineSize);
+}
+
+TEST(ThreadLocalTest, Aggregate) {
+    ThreadLocal<std::atomic<uint64_t>> counter;
+
+    // Value of exited thread is kept and handed to the next one
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&counter] {
+            std::atomic<uint64_t> &mine = counter.Get();
+            for (int i = 0; i < 10000; i++) {
+                mine.store(mine.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+        });
+        if (t % 2 == 1) {
+            for (auto &thread : threads) {
+                thread.join();
+            }
+            threads.clear();
+        }
+    }
+
+    uint64_t total = 0;
+    std::size_t copies = 0;
+    counter.ForEach([&total, &copies](std::atomic<uint64_t> &value) {
+        total += value.load();
+        copies++;
+    });
+    EXPECT_EQ(80000, total);
+
+    // At most two threads were alive at once, so there is no need for more copies
+    EXPECT_LE(1, copies);
+    EXPECT_GE(2, copies);
+}
+
+TEST(ThreadLocalTest, ReuseId) {
+    // Thread accesses instance that is destroyed and the new one gets the same id, stale slot must not be used
+    std::unique_ptr<ThreadLocal<int>> first(new ThreadLocal<int>());
+    first->Get() = 42;
+    first.reset();
+
+    ThreadLocal<int> second;
+    EXPECT_EQ(0, second.Get());
+
+    std::vector<std::unique_ptr<ThreadLocal<int>>> instances;
+    for (int i = 0; i < 100; i++) {
+        instances.emplace_back(new ThreadLocal<int>());
+        instances.back()->Get() = i;
+    }
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i, instances[i]->Get());
+    }
+}
+
+TEST(CoreLocalTest, Get) {
+    CoreLocal<std::atomic<uint64_t>> counter;
+    EXPECT_LE(1, counter.Size());
+
+    std::atomic<uint64_t> &mine = counter.Get();
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&mine) % kCacheLineSize);
+    EXPECT_GE(CurrentCpu(), 0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < 10000; i++) {
+                counter->fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    uint64_t total = 0;
+    counter.ForEach([&total](std::atomic<uint64_t> &value) { total += value.load(); });
+    EXPECT_EQ(40000, total);
+}
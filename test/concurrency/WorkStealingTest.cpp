@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <afina/concurrency/WorkStealingExecutor.h>
+#include <afina/concurrency/WorkStealingQueue.h>
+
+using namespace Afina::Concurrency;
+
+TEST(WorkStealingQueueTest, OwnerIsLifo) {
+    WorkStealingQueue<int> deque(2);
+
+    for (int i = 0; i < 10; i++) {
+        deque.Push(i);
+    }
+    EXPECT_EQ(10, deque.Size());
+
+    int value;
+    ASSERT_TRUE(deque.Pop(value));
+    EXPECT_EQ(9, value);
+
+    // Thieves take the oldest element
+    ASSERT_TRUE(deque.Steal(value));
+    EXPECT_EQ(0, value);
+
+    for (int i = 8; i >= 1; i--) {
+        ASSERT_TRUE(deque.Pop(value));
+        EXPECT_EQ(i, value);
+    }
+    EXPECT_FALSE(deque.Pop(value));
+    EXPECT_FALSE(deque.Steal(value));
+    EXPECT_TRUE(deque.Empty());
+}
+
+TEST(WorkStealingQueueTest, ConcurrentSteal) {
+    const int total = 200000;
+    WorkStealingQueue<int> deque(16);
+
+    std::atomic<bool> done(false);
+    std::vector<std::atomic<int>> seen(total);
+    for (auto &s : seen) {
+        s.store(0);
+    }
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < 3; t++) {
+        thieves.emplace_back([&deque, &done, &seen] {
+            int value;
+            while (!done.load() || !deque.Empty()) {
+                if (deque.Steal(value)) {
+                    seen[value]++;
+                }
+            }
+        });
+    }
+
+    // Owner pushes and sometimes pops, every element must be taken exactly once
+    int value;
+    for (int i = 0; i < total; i++) {
+        deque.Push(i);
+        if (i % 3 == 0 && deque.Pop(value)) {
+            seen[value]++;
+        }
+    }
+    while (deque.Pop(value)) {
+        seen[value]++;
+    }
+    done.store(true);
+
+    for (auto &t : thieves) {
+        t.join();
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_EQ(1, seen[i].load()) << "element " << i;
+    }
+}
+
+TEST(WorkStealingExecutorTest, ExecuteAll) {
+    std::atomic<int> counter(0);
+    {
+        WorkStealingExecutor executor("test", 4);
+        for (int i = 0; i < 10000; i++) {
+            ASSERT_TRUE(executor.Execute([&counter](int add) { counter += add; }, 1));
+        }
+        executor.Stop(true);
+        EXPECT_FALSE(executor.Execute([&counter] { counter++; }));
+    }
+    EXPECT_EQ(10000, counter.load());
+}
+
+// Every task spawns two children until depth is exhausted, so work appears in the pool threads deques
+static void Spawn(WorkStealingExecutor &executor, std::atomic<int> &counter, int depth) {
+    counter++;
+    if (depth > 0) {
+        executor.Execute(Spawn, std::ref(executor), std::ref(counter), depth - 1);
+        executor.Execute(Spawn, std::ref(executor), std::ref(counter), depth - 1);
+    }
+}
+
+TEST(WorkStealingExecutorTest, Recursive) {
+    std::atomic<int> counter(0);
+    WorkStealingExecutor executor("test", 4);
+    ASSERT_TRUE(executor.Execute(Spawn, std::ref(executor), std::ref(counter), 14));
+
+    // Pool stops accepting tasks once stopped, so wait for the whole tree to be spawned first
+    while (counter.load() < (1 << 15) - 1) {
+        std::this_thread::yield();
+    }
+    executor.Stop(true);
+    EXPECT_EQ((1 << 15) - 1, counter.load());
+}
+
+TEST(WorkStealingExecutorTest, StopCompletesQueued) {
+    std::atomic<int> counter(0);
+    std::atomic<bool> release(false);
+
+    WorkStealingExecutor executor("test", 2);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TRUE(executor.Execute([&release] {
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        }));
+    }
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(executor.Execute([&counter] { counter++; }));
+    }
+
+    executor.Stop();
+    EXPECT_FALSE(executor.Execute([&counter] { counter++; }));
+
+    release.store(true);
+    executor.Stop(true);
+    EXPECT_EQ(100, counter.load());
+}
@@ -1,7 +1,10 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <string>
+#include <vector>
 
 #include <afina/coroutine/Engine.h>
 
@@ -62,3 +65,79 @@ TEST(CoroutineTest, Printer) {
     engine.start(_printer, engine, result);
     ASSERT_STREQ("A1 B1 A2 B2 A3 B3 END", result.c_str());
 }
+
+void _counter(Afina::Coroutine::Engine &pe, std::stringstream &out, int id) {
+    for (int i = 0; i < 3; i++) {
+        out << id;
+        pe.yield();
+    }
+}
+
+void _yielder(Afina::Coroutine::Engine &pe, std::stringstream &out) {
+    pe.run(_counter, pe, out, 1);
+    pe.run(_counter, pe, out, 2);
+}
+
+TEST(CoroutineTest, Yield) {
+    Afina::Coroutine::Engine engine;
+
+    std::stringstream out;
+    engine.start(_yielder, engine, out);
+
+    // Every routine got control three times, none of them was starved
+    std::string result = out.str();
+    ASSERT_EQ(6, result.size());
+    ASSERT_EQ(3, std::count(result.begin(), result.end(), '1'));
+    ASSERT_EQ(3, std::count(result.begin(), result.end(), '2'));
+}
+
+void _sleeper(Afina::Coroutine::Engine &pe, std::vector<void *> &sleeping, int &woken) {
+    sleeping.push_back(pe.current());
+    pe.block();
+    woken++;
+}
+
+void _sleepers(Afina::Coroutine::Engine &pe, std::vector<void *> &sleeping, int &woken) {
+    for (int i = 0; i < 3; i++) {
+        pe.run(_sleeper, pe, sleeping, woken);
+    }
+}
+
+TEST(CoroutineTest, BlockUnblock) {
+    std::vector<void *> sleeping;
+    int woken = 0, calls = 0;
+
+    // Engine asks to unblock routines once all of them are sleeping
+    Afina::Coroutine::Engine engine([&sleeping, &calls](Afina::Coroutine::Engine &pe) {
+        calls++;
+        for (void *routine : sleeping) {
+            pe.unblock(routine);
+        }
+        sleeping.clear();
+    });
+
+    engine.start(_sleepers, engine, sleeping, woken);
+    ASSERT_EQ(3, woken);
+    ASSERT_EQ(1, calls);
+}
+
+void _recursive(Afina::Coroutine::Engine &pe, int depth, int &done) {
+    // Touch some stack, so that reused stacks are really used
+    char buffer[1024];
+    buffer[0] = char(depth);
+    pe.yield();
+    if (depth > 0) {
+        pe.run(_recursive, pe, depth - 1, done);
+    }
+    done += buffer[0] >= 0;
+}
+
+TEST(CoroutineTest, ManyRoutines) {
+    Afina::Coroutine::Engine engine;
+
+    int done = 0;
+    for (int round = 0; round < 3; round++) {
+        engine.start(_recursive, engine, 100, done);
+    }
+    ASSERT_EQ(303, done);
+}
@@ -0,0 +1,162 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <afina/coroutine/Scheduler.h>
+
+using Afina::Coroutine::Scheduler;
+
+void _counter(Scheduler &scheduler, std::atomic<int> &counter, int yields) {
+    for (int i = 0; i < yields; i++) {
+        scheduler.Yield();
+    }
+    counter++;
+}
+
+TEST(SchedulerTest, RunsEverything) {
+    std::atomic<int> counter(0);
+    Scheduler scheduler("test", 4);
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_NE(nullptr, scheduler.Spawn(_counter, scheduler, counter, 10));
+    }
+    scheduler.Stop(true);
+
+    EXPECT_EQ(1000, counter.load());
+    EXPECT_EQ(nullptr, scheduler.Spawn(_counter, scheduler, counter, 10));
+}
+
+void _spawner(Scheduler &scheduler, std::atomic<int> &counter, int depth) {
+    counter++;
+    if (depth > 0) {
+        scheduler.Spawn(_spawner, scheduler, counter, depth - 1);
+        scheduler.Spawn(_spawner, scheduler, counter, depth - 1);
+    }
+}
+
+TEST(SchedulerTest, SpawnFromCoroutine) {
+    std::atomic<int> counter(0);
+    Scheduler scheduler("test", 4);
+    scheduler.Spawn(_spawner, scheduler, counter, 10);
+
+    // Stopped scheduler doesn't accept new coroutines from anywhere, so let the tree grow first
+    while (counter.load() < (1 << 11) - 1) {
+        std::this_thread::yield();
+    }
+    scheduler.Stop(true);
+
+    EXPECT_EQ((1 << 11) - 1, counter.load());
+}
+
+struct PingPong {
+    std::atomic<int> turn{0};
+    void *players[2] = {nullptr, nullptr};
+    std::atomic<int> ready{0};
+    int rounds = 0;
+};
+
+void _player(Scheduler &scheduler, PingPong &game, int me) {
+    game.players[me] = scheduler.Current();
+    game.ready++;
+    while (game.ready.load() < 2) {
+        scheduler.Yield();
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        while (game.turn.load() != me) {
+            scheduler.Block();
+        }
+        if (me == 0) {
+            game.rounds++;
+        }
+        game.turn.store(1 - me);
+        scheduler.Unblock(game.players[1 - me]);
+    }
+}
+
+TEST(SchedulerTest, BlockUnblock) {
+    PingPong game;
+    Scheduler scheduler("test", 2);
+    scheduler.Spawn(_player, scheduler, game, 0);
+    scheduler.Spawn(_player, scheduler, game, 1);
+    scheduler.Stop(true);
+
+    EXPECT_EQ(1000, game.rounds);
+}
+
+void _sleeper(Scheduler &scheduler, std::atomic<void *> &self, std::atomic<bool> &woken) {
+    // Permit left before blocking makes the first Block return at once
+    scheduler.Unblock(scheduler.Current());
+    scheduler.Block();
+
+    self.store(scheduler.Current());
+    while (!woken.load()) {
+        scheduler.Block();
+    }
+}
+
+TEST(SchedulerTest, UnblockFromOutside) {
+    std::atomic<void *> self(nullptr);
+    std::atomic<bool> woken(false);
+    Scheduler scheduler("test", 2);
+    scheduler.Spawn(_sleeper, scheduler, self, woken);
+
+    while (self.load() == nullptr) {
+        std::this_thread::yield();
+    }
+    woken.store(true);
+    scheduler.Unblock(self.load());
+    scheduler.Stop(true);
+}
+
+void _reader(Scheduler &scheduler, int fd, std::size_t &received) {
+    Scheduler::Handle *handle = scheduler.Register(fd);
+    char buffer[4096];
+    ssize_t n;
+    while ((n = scheduler.Read(handle, buffer, sizeof(buffer))) > 0) {
+        received += n;
+
+        // Let the writer fill the socket up, so that it has to wait for EPOLLOUT
+        scheduler.Yield();
+    }
+    scheduler.Unregister(handle);
+    close(fd);
+}
+
+void _writer(Scheduler &scheduler, int fd, std::size_t total) {
+    Scheduler::Handle *handle = scheduler.Register(fd);
+    std::string chunk(64 * 1024, 'x');
+    for (std::size_t sent = 0; sent < total;) {
+        struct iovec iov;
+        iov.iov_base = &chunk[0];
+        iov.iov_len = std::min(chunk.size(), total - sent);
+        ssize_t n = scheduler.Writev(handle, &iov, 1);
+        ASSERT_GT(n, 0);
+        sent += n;
+    }
+    scheduler.Unregister(handle);
+    close(fd);
+}
+
+TEST(SchedulerTest, BlockingIO) {
+    static constexpr std::size_t kTotal = 16 * 1024 * 1024;
+    std::vector<std::size_t> received(8, 0);
+    Scheduler scheduler("test", 4);
+    for (auto &result : received) {
+        int fds[2];
+        ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+        scheduler.Spawn(_reader, scheduler, std::move(fds[0]), result);
+        scheduler.Spawn(_writer, scheduler, std::move(fds[1]), kTotal / received.size());
+    }
+    scheduler.Stop(true);
+
+    for (auto result : received) {
+        EXPECT_EQ(kTotal / received.size(), result);
+    }
+}
@@ -0,0 +1,276 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <afina/execute/Variant.h>
+
+#include "execute/Executor.h"
+#include "storage/SimpleLRU.h"
+
+using namespace Afina;
+
+// Backend executor doesn't know about: must be driven through virtual interface, so that overrides are called
+class CountingLRU : public Backend::SimpleLRU {
+public:
+    bool Put(const std::string &key, const std::string &value) override {
+        puts++;
+        return SimpleLRU::Put(key, value);
+    }
+
+    int puts = 0;
+};
+
+static std::string ExecuteOn(Storage &storage, Execute::Variant &command, const std::string &args) {
+    std::string out;
+    Execute::StaticExecutor(storage)(storage, command, args, out);
+    return out;
+}
+
+TEST(VariantTest, Empty) {
+    Execute::Variant command;
+    EXPECT_TRUE(command.Empty());
+
+    Backend::SimpleLRU storage;
+    EXPECT_THROW(ExecuteOn(storage, command, ""), std::runtime_error);
+}
+
+TEST(VariantTest, KnownBackend) {
+    Backend::SimpleLRU storage;
+    Execute::Variant command;
+
+    command.Emplace<Execute::Set>("key", 0, 0);
+    EXPECT_EQ(Execute::Variant::tSet, command.type());
+    EXPECT_EQ("STORED\r\n", ExecuteOn(storage, command, "value"));
+
+    command.Emplace<Execute::Add>("key", 0, 0);
+    EXPECT_EQ("NOT_STORED\r\n", ExecuteOn(storage, command, "other"));
+
+    command.Emplace<Execute::Append>("key", 0, 0);
+    EXPECT_EQ("STORED\r\n", ExecuteOn(storage, command, "+"));
+
+    command.Emplace<Execute::Get>(std::vector<std::string>{"key", "missing"});
+    EXPECT_EQ("VALUE key 0 6\r\nvalue+\r\nEND\r\n", ExecuteOn(storage, command, ""));
+
+    command.Reset();
+    EXPECT_TRUE(command.Empty());
+}
+
+// Command asked for no reply leaves the output empty whatever the result is
+TEST(VariantTest, Noreply) {
+    Backend::SimpleLRU storage;
+    Execute::Variant command;
+
+    command.Emplace<Execute::Replace>("key", 0, 0, true);
+    EXPECT_EQ("", ExecuteOn(storage, command, "value"));
+    command.Emplace<Execute::Set>("key", 0, 0, true);
+    EXPECT_EQ("", ExecuteOn(storage, command, "value"));
+    command.Emplace<Execute::Prepend>("key", 0, 0, true);
+    EXPECT_EQ("", ExecuteOn(storage, command, "my "));
+
+    command.Emplace<Execute::Replace>("missing", 0, 0);
+    EXPECT_EQ(Execute::Variant::tReplace, command.type());
+    EXPECT_EQ("NOT_STORED\r\n", ExecuteOn(storage, command, "other"));
+
+    std::string value;
+    EXPECT_TRUE(storage.Get("key", value));
+    EXPECT_EQ("my value", value);
+
+    command.Emplace<Execute::Delete>("key", true);
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+    command.Emplace<Execute::Delete>("key");
+    EXPECT_EQ("NOT_FOUND\r\n", ExecuteOn(storage, command, ""));
+}
+
+// Long multi-get response is produced in batches, each one fetched by the next Execute call
+TEST(VariantTest, GetInBatches) {
+    Backend::SimpleLRU storage(64 * Execute::Get::kBatchSize);
+    std::string value(Execute::Get::kBatchSize / 4, 'v');
+    std::vector<std::string> keys;
+    std::string expected;
+    for (int i = 0; i < 10; i++) {
+        keys.push_back("key" + std::to_string(i));
+        if (i != 5) {
+            ASSERT_TRUE(storage.Put(keys.back(), value));
+            expected += "VALUE " + keys.back() + " 0 " + std::to_string(value.size()) + "\r\n" + value + "\r\n";
+        }
+    }
+    expected += "END\r\n";
+
+    Execute::Variant command;
+    command.Emplace<Execute::Get>(keys);
+    EXPECT_FALSE(command.HasMore());
+
+    std::string response;
+    int parts = 0;
+    do {
+        std::string part = ExecuteOn(storage, command, "");
+        EXPECT_LT(part.size(), Execute::Get::kBatchSize + value.size() + 32);
+        response += part;
+        parts++;
+    } while (command.HasMore());
+
+    EXPECT_EQ(3, parts);
+    EXPECT_EQ(expected, response);
+}
+
+TEST(VariantTest, UnknownBackend) {
+    CountingLRU storage;
+    Execute::Variant command;
+
+    command.Emplace<Execute::Set>("key", 0, 0);
+    EXPECT_EQ("STORED\r\n", ExecuteOn(storage, command, "value"));
+    EXPECT_EQ(1, storage.puts);
+
+    command.Emplace<Execute::Get>(std::vector<std::string>{"key"});
+    EXPECT_EQ("VALUE key 0 5\r\nvalue\r\nEND\r\n", ExecuteOn(storage, command, ""));
+}
+
+static void Meta(Execute::Variant &command, char name, const std::string &tokens) {
+    std::vector<std::string> split;
+    for (std::size_t begin = 0, end; begin < tokens.size(); begin = end + 1) {
+        end = std::min(tokens.find(' ', begin), tokens.size());
+        split.push_back(tokens.substr(begin, end - begin));
+    }
+    command.Emplace<Execute::Meta>(name, std::move(split));
+}
+
+TEST(VariantTest, Meta) {
+    Backend::SimpleLRU storage;
+    Execute::Variant command;
+
+    Meta(command, 'g', "key v q");
+    EXPECT_EQ(Execute::Variant::tMeta, command.type());
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+
+    Meta(command, 'g', "key v");
+    EXPECT_EQ("EN\r\n", ExecuteOn(storage, command, ""));
+
+    Meta(command, 's', "key ME T0 F5");
+    EXPECT_EQ("HD\r\n", ExecuteOn(storage, command, "10"));
+    EXPECT_EQ("NS\r\n", ExecuteOn(storage, command, "20"));
+
+    Meta(command, 's', "key MA q");
+    EXPECT_EQ("", ExecuteOn(storage, command, "0"));
+
+    Meta(command, 'g', "key s v k O42 f t");
+    EXPECT_EQ("VA 3 s3 kkey O42 f0 t-1\r\n100\r\n", ExecuteOn(storage, command, ""));
+
+    Meta(command, 'a', "key v D50 MD");
+    EXPECT_EQ("VA 2\r\n50\r\n", ExecuteOn(storage, command, ""));
+    EXPECT_EQ("VA 1\r\n0\r\n", ExecuteOn(storage, command, ""));
+
+    Meta(command, 'a', "missing");
+    EXPECT_EQ("NF\r\n", ExecuteOn(storage, command, ""));
+
+    Meta(command, 'd', "key q");
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+    Meta(command, 'd', "key k");
+    EXPECT_EQ("NF kkey\r\n", ExecuteOn(storage, command, ""));
+
+    Meta(command, 'g', "key x");
+    EXPECT_EQ("CLIENT_ERROR bad command line format\r\n", ExecuteOn(storage, command, ""));
+
+    command.Emplace<Execute::Meta>('n', std::vector<std::string>());
+    EXPECT_EQ("MN\r\n", ExecuteOn(storage, command, ""));
+}
+
+static void Resp(Execute::Variant &command, std::vector<std::string> tokens) {
+    command.Emplace<Execute::Resp>(std::move(tokens));
+}
+
+TEST(VariantTest, Resp) {
+    Backend::SimpleLRU storage;
+    Execute::Variant command;
+
+    Resp(command, {"GET", "key"});
+    EXPECT_EQ(Execute::Variant::tResp, command.type());
+    EXPECT_EQ("$-1\r\n", ExecuteOn(storage, command, ""));
+
+    Resp(command, {"set", "key", "10", "EX", "60"});
+    EXPECT_EQ("+OK\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"SET", "key", "20", "NX"});
+    EXPECT_EQ("$-1\r\n", ExecuteOn(storage, command, ""));
+
+    Resp(command, {"INCR", "key"});
+    EXPECT_EQ(":11\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"APPEND", "key", "x"});
+    EXPECT_EQ(":3\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"INCR", "key"});
+    EXPECT_EQ("-ERR value is not an integer or out of range\r\n", ExecuteOn(storage, command, ""));
+
+    Resp(command, {"MSET", "a", "1", "b", "2"});
+    EXPECT_EQ("+OK\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"MGET", "a", "missing", "key"});
+    EXPECT_EQ("*3\r\n$1\r\n1\r\n$-1\r\n$3\r\n11x\r\n", ExecuteOn(storage, command, ""));
+
+    Resp(command, {"EXPIRE", "a", "0"});
+    EXPECT_EQ(":1\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"DEL", "a", "b", "key"});
+    EXPECT_EQ(":2\r\n", ExecuteOn(storage, command, ""));
+
+    Resp(command, {"MSET", "a", "1", "b"});
+    EXPECT_EQ("-ERR wrong number of arguments for 'MSET' command\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"SET", "a", "1", "EX", "0"});
+    EXPECT_EQ("-ERR invalid expire time in 'set' command\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"FLUSHALL"});
+    EXPECT_EQ("-ERR unknown command 'FLUSHALL'\r\n", ExecuteOn(storage, command, ""));
+    Resp(command, {"PING"});
+    EXPECT_EQ("+PONG\r\n", ExecuteOn(storage, command, ""));
+}
+
+// Header of binary request with no extras: opcode, key length, body length and opaque
+static std::string BinaryRequest(uint8_t opcode, const std::string &key, const std::string &value, uint8_t opaque) {
+    std::string packet(Execute::Binary::kHeaderSize, '\0');
+    packet[0] = char(Execute::Binary::kRequestMagic);
+    packet[1] = char(opcode);
+    packet[3] = char(key.size());
+    packet[11] = char(key.size() + value.size());
+    packet[15] = char(opaque);
+    return packet + key + value;
+}
+
+// Status and body of the binary response
+static std::pair<int, std::string> BinaryResponse(const std::string &packet) {
+    EXPECT_LE(Execute::Binary::kHeaderSize, packet.size());
+    EXPECT_EQ(char(Execute::Binary::kResponseMagic), packet[0]);
+    return std::make_pair(int(packet[7]), packet.substr(Execute::Binary::kHeaderSize));
+}
+
+TEST(VariantTest, Binary) {
+    Backend::SimpleLRU storage;
+    Execute::Variant command;
+
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oAppend, "key", "tail", 1));
+    EXPECT_EQ(Execute::Variant::tBinary, command.type());
+    EXPECT_EQ(Execute::Binary::sNotStored, BinaryResponse(ExecuteOn(storage, command, "")).first);
+
+    // Quiet commands are silent unless they fail
+    storage.Put("key", "value");
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oAppendQ, "key", "+", 2));
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oPrependQ, "key", "-", 2));
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oGetQ, "missing", "", 3));
+    EXPECT_EQ("", ExecuteOn(storage, command, ""));
+
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oGetK, "key", "", 4));
+    std::string response = ExecuteOn(storage, command, "");
+    EXPECT_EQ(4, response[15]);
+    EXPECT_EQ(std::make_pair(0, std::string("\0\0\0\0key-value+", 14)), BinaryResponse(response));
+
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oDelete, "key", "", 5));
+    EXPECT_EQ(std::make_pair(0, std::string()), BinaryResponse(ExecuteOn(storage, command, "")));
+
+    // Set requires flags and expire time as extras
+    command.Emplace<Execute::Binary>(BinaryRequest(Execute::Binary::oSet, "key", "value", 6));
+    EXPECT_EQ(Execute::Binary::sInvalidArguments, BinaryResponse(ExecuteOn(storage, command, "")).first);
+
+    command.Emplace<Execute::Binary>(BinaryRequest(0x42, "", "", 7));
+    EXPECT_EQ(0x81, uint8_t(ExecuteOn(storage, command, "")[7]));
+}
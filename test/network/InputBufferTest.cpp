@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <network/InputBuffer.h>
+
+using namespace Afina::Network;
+
+// Pipe with non blocking read end, that is what connections read from
+class InputBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_EQ(0, pipe(fds));
+        fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    }
+
+    void TearDown() override {
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    void Send(const std::string &data) { ASSERT_EQ(ssize_t(data.size()), write(fds[1], data.data(), data.size())); }
+
+    int fds[2];
+};
+
+// Take everything buffered
+static std::string Drain(InputBuffer &buffer) {
+    std::string result(buffer.Available(), '\0');
+    std::size_t available = buffer.Available();
+    buffer.CopyOut(&result[0], available);
+    return result;
+}
+
+TEST_F(InputBufferTest, ReadConsume) {
+    InputBuffer buffer(16);
+    EXPECT_TRUE(buffer.Empty());
+
+    Send("set foo 0 0 3\r\nbar\r\n");
+    EXPECT_EQ(20, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(20, buffer.Available());
+
+    // Data spilled over into the second block
+    EXPECT_EQ(16, buffer.Size());
+    EXPECT_EQ("set foo 0 0 3\r\nb", std::string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(15);
+    EXPECT_EQ("b", std::string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(1);
+    EXPECT_EQ("ar\r\n", std::string(buffer.Data(), buffer.Size()));
+
+    buffer.Consume(4);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_EQ(0, buffer.Size());
+
+    EXPECT_EQ(-1, buffer.ReadFrom(fds[0]));
+    EXPECT_EQ(EAGAIN, errno);
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST_F(InputBufferTest, ReuseDrainedBlock) {
+    InputBuffer buffer(16);
+
+    Send("get foo\r\n");
+    buffer.ReadFrom(fds[0]);
+    const char *first = buffer.Data();
+    buffer.Consume(9);
+
+    // Once everything is consumed next read starts from the block beginning
+    Send("get bar\r\n");
+    buffer.ReadFrom(fds[0]);
+    EXPECT_EQ(first, buffer.Data());
+    EXPECT_EQ("get bar\r\n", std::string(buffer.Data(), buffer.Size()));
+}
+
+TEST_F(InputBufferTest, Chain) {
+    InputBuffer buffer(8);
+
+    // Tail is not consumed, so every read goes on after it
+    std::string expected;
+    for (int i = 0; i < 10; i++) {
+        std::string piece = "piece " + std::to_string(i) + "\r\n";
+        expected += piece;
+        Send(piece);
+        buffer.ReadFrom(fds[0]);
+    }
+    EXPECT_EQ(expected.size(), buffer.Available());
+
+    buffer.Consume(3);
+    std::string tail(buffer.Available(), '\0');
+    EXPECT_EQ(tail.size(), buffer.CopyOut(&tail[0], tail.size() + 10));
+    EXPECT_EQ(expected.substr(3), tail);
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST_F(InputBufferTest, CopyOutPartial) {
+    InputBuffer buffer(4);
+
+    Send("0123456789");
+    buffer.ReadFrom(fds[0]);
+    buffer.ReadFrom(fds[0]);
+    buffer.ReadFrom(fds[0]);
+    EXPECT_EQ(10, buffer.Available());
+
+    char value[6];
+    EXPECT_EQ(6, buffer.CopyOut(value, 6));
+    EXPECT_EQ("012345", std::string(value, 6));
+    EXPECT_EQ("6789", Drain(buffer));
+
+    buffer.Clear();
+    EXPECT_TRUE(buffer.Empty());
+}
+
+// Argument grows by what arrived, not by what it is going to be
+TEST_F(InputBufferTest, AppendArgument) {
+    InputBuffer buffer(4);
+
+    Send("0123456789");
+    EXPECT_EQ(8, buffer.ReadFrom(fds[0]));
+
+    std::string argument("ab");
+    EXPECT_EQ(8, buffer.AppendTo(argument, 1024 * 1024));
+    EXPECT_EQ("ab01234567", argument);
+    EXPECT_TRUE(buffer.Empty());
+
+    // Direct read gets room for the part of the value only, the rest is up to the next reads
+    std::size_t offset = argument.size();
+    std::size_t room = ExtendForRead(argument, 1024 * 1024);
+    EXPECT_GE(room, 4096);
+    EXPECT_LT(room, 1024 * 1024);
+    EXPECT_EQ(offset + room, argument.size());
+
+    ssize_t readed = read(fds[0], &argument[offset], room);
+    EXPECT_EQ(2, readed);
+    argument.resize(offset + readed);
+    EXPECT_EQ("ab0123456789", argument);
+
+    EXPECT_EQ(3, ExtendForRead(argument, 3));
+}
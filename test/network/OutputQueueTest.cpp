@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include <network/OutputQueue.h>
+
+using namespace Afina::Network;
+
+// Collect everything queue would send in one writev
+static std::string Pending(const OutputQueue &queue) {
+    struct iovec iov[64];
+    std::size_t count = queue.Prepare(iov, 64);
+
+    std::string result;
+    for (std::size_t i = 0; i < count; i++) {
+        result.append(static_cast<char *>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return result;
+}
+
+TEST(OutputQueueTest, AppendConsume) {
+    OutputQueue queue(1024, 512, 8);
+    EXPECT_TRUE(queue.Empty());
+
+    queue.Append("STORED\r\n");
+    queue.Append("VALUE foo 0 3\r\nbar\r\nEND\r\n");
+    EXPECT_EQ(33, queue.Size());
+    EXPECT_EQ("STORED\r\nVALUE foo 0 3\r\nbar\r\nEND\r\n", Pending(queue));
+
+    queue.Consume(3);
+    EXPECT_EQ("RED\r\nVALUE foo 0 3\r\nbar\r\nEND\r\n", Pending(queue));
+
+    queue.Consume(14);
+    EXPECT_EQ(" 0 3\r\nbar\r\nEND\r\n", Pending(queue));
+
+    queue.Consume(16);
+    EXPECT_TRUE(queue.Empty());
+    EXPECT_EQ("", Pending(queue));
+}
+
+TEST(OutputQueueTest, WrapAround) {
+    OutputQueue queue(1024 * 1024, 1024, 4);
+
+    // Keep a few chunks in flight while ring head runs around many times
+    std::string expected;
+    for (int i = 0; i < 1000; i++) {
+        std::string piece = std::to_string(i) + ";";
+        queue.Append(piece);
+        expected += piece;
+
+        if (i % 3 == 0) {
+            queue.Consume(5);
+            expected.erase(0, 5);
+        }
+        ASSERT_EQ(expected.size(), queue.Size());
+    }
+    std::string pending = Pending(queue);
+    ASSERT_FALSE(pending.empty());
+    ASSERT_EQ(expected.substr(0, pending.size()), pending);
+}
+
+TEST(OutputQueueTest, Grow) {
+    OutputQueue queue(1024 * 1024, 1024, 4);
+
+    std::string expected = "abcdefghijklmnopqrstuvwxyz012345";
+    queue.Append(expected);
+    queue.Consume(8);
+    expected.erase(0, 8);
+
+    // Ring head is not at the beginning, so tail wraps around and then ring grows
+    std::string tail = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    queue.Append(tail);
+    expected += tail;
+
+    EXPECT_EQ(expected, Pending(queue));
+    EXPECT_EQ(expected.size(), queue.Size());
+}
+
+TEST(OutputQueueTest, Watermarks) {
+    OutputQueue queue(10, 4, 4);
+    EXPECT_FALSE(queue.Overflown());
+    EXPECT_TRUE(queue.Drained());
+
+    queue.Append("0123456789");
+    EXPECT_FALSE(queue.Overflown());
+    EXPECT_FALSE(queue.Drained());
+
+    queue.Append("a");
+    EXPECT_TRUE(queue.Overflown());
+
+    queue.Consume(6);
+    EXPECT_FALSE(queue.Overflown());
+    EXPECT_FALSE(queue.Drained());
+
+    queue.Consume(1);
+    EXPECT_TRUE(queue.Drained());
+}
@@ -1,19 +1,48 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <memory>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include <afina/execute/Add.h>
+#include <afina/execute/Delete.h>
+#include <afina/execute/Binary.h>
 #include <afina/execute/Get.h>
+#include <afina/execute/Meta.h>
+#include <afina/execute/Resp.h>
 #include <afina/execute/Set.h>
 #include <afina/execute/Stats.h>
+#include <afina/execute/Variant.h>
 
 #include <protocol/Parser.h>
 
 using namespace Afina;
 
+// Number of heap allocations made by the thread so far
+static thread_local size_t allocations = 0;
+
+// Make every allocation of the thread fail
+static thread_local bool out_of_memory = false;
+
+void *operator new(size_t size) {
+    allocations++;
+    if (out_of_memory) {
+        throw std::bad_alloc();
+    } else if (void *p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
 // TODO: Negative test on errors
-// TODO: Separate tests for integers overflow
 // TODO: Special test that consumed only increased
 
 // Verify simple set command passed in a single string
@@ -81,6 +110,27 @@ TEST(MemcachedParserTest, SimpleGet) {
     ASSERT_EQ("super_long_key", keys[2]);
 }
 
+// Storage has no CAS, so gets is served as get
+TEST(MemcachedParserTest, Gets) {
+    Protocol::Parser parser;
+
+    size_t consumed = 0;
+    ASSERT_TRUE(parser.Parse("gets k1 k2\r\n", consumed));
+    ASSERT_EQ("gets", parser.Name());
+
+    size_t value_size;
+    std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+    Execute::Get *tmp = dynamic_cast<Execute::Get *>(cmd.get());
+    ASSERT_FALSE(tmp == nullptr);
+    ASSERT_EQ(std::vector<std::string>({"k1", "k2"}), tmp->keys());
+
+    parser.Reset();
+    Execute::Variant command;
+    ASSERT_TRUE(parser.Parse("gets k3\r\n", consumed));
+    ASSERT_TRUE(parser.Build(command, value_size));
+    EXPECT_EQ(Execute::Variant::tGet, command.type());
+}
+
 TEST(MemcachedParserTest, Stats) {
     Protocol::Parser parser;
 
@@ -98,3 +148,314 @@ TEST(MemcachedParserTest, Stats) {
     Execute::Stats *tmp = reinterpret_cast<Execute::Stats *>(cmd.get());
     ASSERT_FALSE(tmp == nullptr);
 }
+
+// Parse command line pushed in pieces of the given size
+static std::unique_ptr<Execute::Command> ParseSplit(const std::string &line, size_t piece, size_t &value_size) {
+    Protocol::Parser parser;
+    size_t offset = 0;
+    bool cmd_avail = false;
+    while (!cmd_avail) {
+        EXPECT_LT(offset, line.size());
+        size_t consumed = 0;
+        cmd_avail = parser.Parse(line.data() + offset, std::min(piece, line.size() - offset), consumed);
+        offset += consumed;
+    }
+    EXPECT_EQ(line.size(), offset);
+    return parser.Build(value_size);
+}
+
+// Line available at once and line split at every position give the same command
+TEST(MemcachedParserTest, SplitLines) {
+    std::string line = "set some_rather_long_key_name 4294967295 -2147483648 1048576\r\n";
+    for (size_t piece = 1; piece <= line.size(); piece++) {
+        size_t value_size = 0;
+        std::unique_ptr<Execute::Command> cmd = ParseSplit(line, piece, value_size);
+        ASSERT_FALSE(cmd == nullptr);
+        ASSERT_EQ(1048576, value_size);
+
+        Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+        ASSERT_EQ("some_rather_long_key_name", tmp->key());
+        ASSERT_EQ(4294967295u, tmp->flags());
+        ASSERT_EQ(-2147483648ll, tmp->expire());
+    }
+
+    line = "get a bb ccc dddd eeeee ffffff ggggggg hhhhhhhh iiiiiiiii jjjjjjjjjj kkkkkkkkkkk llllllllllll\r\n";
+    for (size_t piece = 1; piece <= line.size(); piece++) {
+        size_t value_size = 0;
+        std::unique_ptr<Execute::Command> cmd = ParseSplit(line, piece, value_size);
+        ASSERT_FALSE(cmd == nullptr);
+
+        Execute::Get *tmp = reinterpret_cast<Execute::Get *>(cmd.get());
+        std::vector<std::string> keys = tmp->keys();
+        ASSERT_EQ(12, keys.size());
+        ASSERT_EQ("a", keys[0]);
+        ASSERT_EQ("hhhhhhhh", keys[7]);
+        ASSERT_EQ("llllllllllll", keys[11]);
+    }
+}
+
+// Every digit of the expire time counts
+TEST(MemcachedParserTest, LongNumbers) {
+    for (size_t piece : {size_t(1), size_t(1024)}) {
+        size_t value_size = 0;
+        std::unique_ptr<Execute::Command> cmd = ParseSplit("set k 000000000000000012345 3600 0\r\n", piece, value_size);
+        ASSERT_FALSE(cmd == nullptr);
+        ASSERT_EQ(0, value_size);
+
+        Execute::Set *tmp = reinterpret_cast<Execute::Set *>(cmd.get());
+        ASSERT_EQ(12345, tmp->flags());
+        ASSERT_EQ(3600, tmp->expire());
+    }
+}
+
+TEST(MemcachedParserTest, Overflow) {
+    const char *lines[] = {"set k 4294967296 0 1\r\n", "set k 0 2147483648 1\r\n", "set k 0 -2147483649 1\r\n",
+                           "set k 0 0 42949672950\r\n"};
+    for (const char *line : lines) {
+        for (size_t piece : {size_t(1), size_t(1024)}) {
+            size_t value_size = 0;
+            EXPECT_THROW(ParseSplit(line, piece, value_size), std::runtime_error) << line;
+        }
+    }
+}
+
+// Data block over the limit is refused before anything is allocated for it
+TEST(MemcachedParserTest, TooLarge) {
+    for (const char *line : {"set k 0 0 1048577\r\n", "append k 0 0 4294967295 noreply\r\n", "ms k 1048577\r\n"}) {
+        for (size_t piece : {size_t(1), size_t(1024)}) {
+            Protocol::Parser parser;
+            size_t value_size = 0;
+            size_t offset = 0;
+            EXPECT_THROW(
+                {
+                    bool cmd_avail = false;
+                    while (!cmd_avail) {
+                        size_t consumed = 0;
+                        cmd_avail = parser.Parse(line + offset, std::min(piece, std::strlen(line) - offset), consumed);
+                        offset += consumed;
+                    }
+                    parser.Build(value_size);
+                },
+                std::runtime_error)
+                << line;
+            EXPECT_EQ("SERVER_ERROR object too large for cache\r\n", parser.Error()) << line;
+        }
+    }
+
+    Protocol::Parser parser;
+    size_t consumed = 0;
+    EXPECT_THROW(parser.Parse("bogus key\r\n", consumed), std::runtime_error);
+    EXPECT_EQ("ERROR\r\n", parser.Error());
+}
+
+TEST(MemcachedParserTest, UnknownCommand) {
+    Protocol::Parser parser;
+    size_t consumed = 0;
+    EXPECT_THROW(parser.Parse("bogus key\r\n", consumed), std::runtime_error);
+}
+
+// Storage commands and delete could ask for no reply
+TEST(MemcachedParserTest, Noreply) {
+    for (size_t piece : {size_t(1), size_t(1024)}) {
+        size_t value_size = 0;
+        std::unique_ptr<Execute::Command> cmd = ParseSplit("replace key 1 2 3 noreply\r\n", piece, value_size);
+        ASSERT_EQ(3, value_size);
+        ASSERT_TRUE(dynamic_cast<Execute::InsertCommand *>(cmd.get())->noreply());
+
+        cmd = ParseSplit("prepend key 1 2 3\r\n", piece, value_size);
+        ASSERT_FALSE(dynamic_cast<Execute::InsertCommand *>(cmd.get())->noreply());
+
+        cmd = ParseSplit("delete key noreply\r\n", piece, value_size);
+        Execute::Delete *tmp = dynamic_cast<Execute::Delete *>(cmd.get());
+        ASSERT_FALSE(tmp == nullptr);
+        ASSERT_EQ("key", tmp->key());
+        ASSERT_TRUE(tmp->noreply());
+
+        EXPECT_THROW(ParseSplit("set key 1 2 3 please\r\n", piece, value_size), std::runtime_error);
+        EXPECT_THROW(ParseSplit("delete key 0 noreply\r\n", piece, value_size), std::runtime_error);
+    }
+}
+
+// Meta commands are key and flags, data length of set goes to the body size
+TEST(MemcachedParserTest, Meta) {
+    std::string line = "ms some_key 42 T60 F7 MA q O123\r\n";
+    for (size_t piece = 1; piece <= line.size(); piece++) {
+        size_t value_size = 0;
+        std::unique_ptr<Execute::Command> cmd = ParseSplit(line, piece, value_size);
+        ASSERT_EQ(42, value_size);
+
+        Execute::Meta *tmp = dynamic_cast<Execute::Meta *>(cmd.get());
+        ASSERT_FALSE(tmp == nullptr);
+        ASSERT_EQ('s', tmp->command());
+        ASSERT_EQ("some_key", tmp->key());
+    }
+
+    size_t value_size = 0;
+    std::unique_ptr<Execute::Command> cmd = ParseSplit("mn\r\n", 1024, value_size);
+    ASSERT_EQ('n', dynamic_cast<Execute::Meta *>(cmd.get())->command());
+
+    EXPECT_THROW(ParseSplit("ms key v\r\n", 1024, value_size), std::runtime_error);
+    EXPECT_THROW(ParseSplit("ms key\r\n", 1, value_size), std::runtime_error);
+}
+
+// Binary set request: 8 bytes of extras, key "key" and value "value"
+static std::string BinarySet() {
+    std::string packet = {'\x80', '\x01', '\x00', '\x03', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00',
+                          '\x10', '\x12', '\x34', '\x56', '\x78', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00',
+                          '\x00', '\x00', '\x00', '\x00', '\x00', '\x05', '\x00', '\x00', '\x0e', '\x10'};
+    return packet + "keyvalue";
+}
+
+// Request starting with magic byte is collected as a whole packet, value included
+TEST(MemcachedParserTest, BinaryRequest) {
+    std::string packet = BinarySet() + "get key\r\n";
+    for (size_t piece = 1; piece <= packet.size(); piece++) {
+        Protocol::Parser parser;
+        size_t offset = 0;
+        bool cmd_avail = false;
+        while (!cmd_avail && offset < packet.size()) {
+            size_t consumed = 0;
+            cmd_avail = parser.Parse(packet.data() + offset, std::min(piece, packet.size() - offset), consumed);
+            offset += consumed;
+        }
+        ASSERT_TRUE(cmd_avail);
+        ASSERT_EQ(BinarySet().size(), offset);
+
+        size_t value_size = 1;
+        std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+        ASSERT_EQ(0, value_size);
+
+        Execute::Binary *tmp = dynamic_cast<Execute::Binary *>(cmd.get());
+        ASSERT_FALSE(tmp == nullptr);
+        ASSERT_EQ(Execute::Binary::oSet, tmp->opcode());
+        ASSERT_EQ("key", tmp->key());
+
+        // Text request follows binary one on the same connection
+        parser.Reset();
+        size_t consumed = 0;
+        ASSERT_TRUE(parser.Parse(packet.data() + offset, packet.size() - offset, consumed));
+        ASSERT_EQ("get", parser.Name());
+    }
+}
+
+TEST(MemcachedParserTest, BinaryBadLengths) {
+    // Key is longer than the whole body
+    std::string packet = BinarySet();
+    packet[3] = '\x20';
+
+    Protocol::Parser parser;
+    size_t consumed = 0;
+    EXPECT_THROW(parser.Parse(packet, consumed), std::runtime_error);
+    EXPECT_EQ("", parser.Error());
+
+    // Value is over the limit: refused once header is there, client gets response with the same opaque
+    packet = BinarySet().substr(0, Execute::Binary::kHeaderSize);
+    packet[9] = '\x10';
+    parser.Reset();
+    EXPECT_THROW(parser.Parse(packet, consumed), std::runtime_error);
+    ASSERT_EQ(Execute::Binary::kHeaderSize + 9, parser.Error().size());
+    EXPECT_EQ(std::string("\x81\x01\x00\x00\x00\x00\x00\x03", 8), parser.Error().substr(0, 8));
+    EXPECT_EQ("\x12\x34\x56\x78", parser.Error().substr(12, 4));
+}
+
+// Quit is answered as an error: response goes out and connection is closed
+TEST(MemcachedParserTest, BinaryQuit) {
+    std::string packet(Execute::Binary::kHeaderSize, '\0');
+    packet[0] = '\x80';
+    packet[1] = Execute::Binary::oQuit;
+    packet[15] = '\x2a';
+
+    Protocol::Parser parser;
+    size_t consumed = 0;
+    EXPECT_THROW(parser.Parse(packet, consumed), std::runtime_error);
+    ASSERT_EQ(Execute::Binary::kHeaderSize, parser.Error().size());
+    EXPECT_EQ('\x81', parser.Error()[0]);
+    EXPECT_EQ(Execute::Binary::oQuit, parser.Error()[1]);
+    EXPECT_EQ('\x2a', parser.Error()[15]);
+
+    packet[1] = Execute::Binary::oQuitQ;
+    parser.Reset();
+    EXPECT_THROW(parser.Parse(packet, consumed), std::runtime_error);
+    EXPECT_EQ("", parser.Error());
+}
+
+// Redis request is an array of bulk strings, those are binary safe
+TEST(MemcachedParserTest, RespRequest) {
+    std::string value("a\r\nb\0c", 7);
+    std::string request = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$7\r\n" + value + "\r\n";
+    std::string packet = request + "*1\r\n$4\r\nPING\r\n";
+    for (size_t piece = 1; piece <= packet.size(); piece++) {
+        Protocol::Parser parser(Protocol::Type::Resp);
+        size_t offset = 0;
+        bool cmd_avail = false;
+        while (!cmd_avail && offset < packet.size()) {
+            size_t consumed = 0;
+            cmd_avail = parser.Parse(packet.data() + offset, std::min(piece, packet.size() - offset), consumed);
+            offset += consumed;
+        }
+        ASSERT_TRUE(cmd_avail);
+        ASSERT_EQ(request.size(), offset);
+        ASSERT_EQ("SET", parser.Name());
+
+        size_t value_size = 1;
+        std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+        ASSERT_EQ(0, value_size);
+
+        Execute::Resp *tmp = dynamic_cast<Execute::Resp *>(cmd.get());
+        ASSERT_FALSE(tmp == nullptr);
+        ASSERT_EQ(std::vector<std::string>{"key"}, tmp->keys());
+
+        parser.Reset();
+        size_t consumed = 0;
+        ASSERT_TRUE(parser.Parse(packet.data() + offset, packet.size() - offset, consumed));
+        ASSERT_EQ("PING", parser.Name());
+    }
+}
+
+TEST(MemcachedParserTest, RespBadRequest) {
+    const std::string requests[] = {"get key\r\n", "*0\r\n", "*1\r\n:1\r\n", "*1\r\n$3\r\nGETxx"};
+    for (auto &request : requests) {
+        Protocol::Parser parser(Protocol::Type::Resp);
+        size_t consumed = 0;
+        EXPECT_THROW(parser.Parse(request, consumed), std::runtime_error) << request;
+    }
+}
+
+// Once the first requests have left their memory to the thread, parser and commands don't touch the heap. Keys fit
+// into std::string inline buffer, longer ones take an allocation each
+TEST(MemcachedParserTest, NoAllocations) {
+    Protocol::Parser parser;
+    const std::string lines[] = {"set key 1 2 3\r\n", "get k1 k2 k3 k4\r\n", "add k 0 0 1\r\n", "stats\r\n"};
+
+    size_t before = 0;
+    for (int round = 0; round < 3; round++) {
+        if (round == 2) {
+            before = allocations;
+        }
+
+        for (const std::string &line : lines) {
+            size_t consumed = 0, value_size = 0;
+            ASSERT_TRUE(parser.Parse(line, consumed));
+            std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+            ASSERT_FALSE(cmd == nullptr);
+            cmd.reset();
+            parser.Reset();
+        }
+    }
+    EXPECT_EQ(before, allocations);
+}
+
+// Command returns its keys to the thread from destructor, that must survive allocation failure
+TEST(MemcachedParserTest, ReturnKeysOutOfMemory) {
+    // Fresh thread has no room for spare vectors yet
+    std::thread([] {
+        Protocol::Parser parser;
+        size_t consumed = 0, value_size = 0;
+        ASSERT_TRUE(parser.Parse("get k1 k2\r\n", consumed));
+        std::unique_ptr<Execute::Command> cmd = parser.Build(value_size);
+
+        out_of_memory = true;
+        cmd.reset();
+        out_of_memory = false;
+    }).join();
+}
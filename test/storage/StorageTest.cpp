@@ -2,6 +2,7 @@
 #include <iomanip>
 #include <iostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <afina/execute/Add.h>
@@ -10,7 +11,9 @@
 #include <afina/execute/Get.h>
 #include <afina/execute/Set.h>
 
+#include "storage/FlatCombineLRU.h"
 #include "storage/SimpleLRU.h"
+#include "storage/StripedLRU.h"
 
 using namespace Afina::Backend;
 using namespace Afina::Execute;
@@ -195,3 +198,54 @@ TEST(StorageTest, MaxTest) {
         EXPECT_FALSE(storage.Get(key, res));
     }
 }
+
+TEST(StorageTest, FlatCombineConcurrent) {
+    const size_t length = 20;
+    FlatCombineLRU storage(2 * 8 * 1000 * length);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&storage, t, length] {
+            for (long i = 0; i < 1000; ++i) {
+                auto key = pad_space("Key " + std::to_string(t) + " " + std::to_string(i), length);
+                auto val = pad_space("Val " + std::to_string(i), length);
+                EXPECT_TRUE(storage.Put(key, val));
+
+                std::string res;
+                EXPECT_TRUE(storage.Get(key, res));
+                EXPECT_TRUE(val == res);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    std::string res;
+    EXPECT_TRUE(storage.Get(pad_space("Key 7 999", length), res));
+    EXPECT_TRUE(storage.Delete(pad_space("Key 7 999", length)));
+    EXPECT_FALSE(storage.Get(pad_space("Key 7 999", length), res));
+}
+
+TEST(StorageTest, StripeLockStats) {
+    auto storage = StripedLRU::BuildStripedLRU(4 * MinStripeSize, 4);
+    EXPECT_TRUE(storage->Put("KEY1", "val1"));
+
+    std::string value;
+    EXPECT_TRUE(storage->Get("KEY1", value));
+
+    // Both operations went to the same stripe
+    std::vector<std::pair<std::string, uint64_t>> stats;
+    storage->Stats(stats);
+    ASSERT_EQ(12, stats.size());
+
+    uint64_t acquisitions = 0;
+    for (auto &stat : stats) {
+        EXPECT_EQ(0, stat.first.find("stripe_"));
+        if (stat.first.find("_lock_acquisitions") != std::string::npos) {
+            EXPECT_TRUE(stat.second == 0 || stat.second == 2);
+            acquisitions += stat.second;
+        }
+    }
+    EXPECT_EQ(2, acquisitions);
+}